@@ -1,16 +1,31 @@
 #pragma once
 
+#include <limits>
+#include <ostream>
+#include <sstream>
 #include <string>
-#include <fstream>
 
 namespace PReflTool {
 
+// Values of the annotations in the generated code, without losing precision.
+inline std::string FormatNumber(double value) {
+  std::ostringstream out;
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << value;
+  return out.str();
+}
+
 struct Attr {
   // std::string name;
   Attr() = default;
   virtual ~Attr() = default;
   virtual std::string GetName() = 0;
-  virtual void Write(std::ofstream&) = 0;
+  // `nameExpr` names the attribute in the generated code, Name<"range">{} or
+  // an entry of the pooled name table of the record.
+  virtual void Write(std::ostream &, const std::string &nameExpr) = 0;
+  void Write(std::ostream &out) {
+    Write(out, "Name<\"" + GetName() + "\">{}");
+  }
 };
 
 struct MetaAnnotate : public Attr {
@@ -19,8 +34,21 @@ struct MetaAnnotate : public Attr {
     return "META=clang::annotate(\"meta\")";
   }
   std::string GetName() override { return std::string{name}; }
-  void Write(std::ofstream &out) override {
-    out << "Attribute{ Name<\"" << name << "\">{} }";
+  void Write(std::ostream &out, const std::string &nameExpr) override {
+    out << "Attribute{ " << nameExpr << " }";
+  }
+};
+
+// Record annotation, the generator emits a struct-of-arrays container
+// PRefl::SoA<T> for the record.
+struct SoAAnnotate : public Attr {
+  constexpr static char name[] = "soa";
+  constexpr static const char *GetMarco() {
+    return "SOA=clang::annotate(\"soa\")";
+  }
+  std::string GetName() override { return std::string{name}; }
+  void Write(std::ostream &out, const std::string &nameExpr) override {
+    out << "Attribute{ " << nameExpr << " }";
   }
 };
 
@@ -33,8 +61,8 @@ struct InfoAnnotate : public Attr {
 
   std::string info;
   
-  void Write(std::ofstream &out) override {
-    out << "Attribute{ Name<\"" << name << "\">{}, \"" << info << "\"}";
+  void Write(std::ostream &out, const std::string &nameExpr) override {
+    out << "Attribute{ " << nameExpr << ", \"" << info << "\"}";
   }
 };
 
@@ -49,9 +77,9 @@ struct RangeAnnotate : public Attr {
   double vmin = 0.;
   double vmax = 0.;
 
-  void Write(std::ofstream &out) override {
-    out << "Attribute{ Name<\"" << name << "\">{}, std::make_pair(" << vmin
-        << ", " << vmax << ") }";
+  void Write(std::ostream &out, const std::string &nameExpr) override {
+    out << "Attribute{ " << nameExpr << ", std::make_pair("
+        << FormatNumber(vmin) << ", " << FormatNumber(vmax) << ") }";
   }
 
   void SetRange(double v) {
@@ -82,8 +110,8 @@ struct StepAnnotate : public Attr {
 
   double step;
 
-  void Write(std::ofstream &out) override {
-    out << "Attribute{ Name<\"" << name << "\">{}, " << step << " }";
+  void Write(std::ostream &out, const std::string &nameExpr) override {
+    out << "Attribute{ " << nameExpr << ", " << FormatNumber(step) << " }";
   }
 };
 
@@ -0,0 +1,169 @@
+#include "BatchScheduler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace PReflTool;
+
+// Guess for headers which have never been parsed.
+static const size_t s_defaultEstimate = 256ull * 1024 * 1024;
+
+BatchScheduler::BatchScheduler(unsigned threads, size_t budget)
+    : m_threads(std::max(1u, threads)), m_budget(budget) {}
+
+bool BatchScheduler::LoadProfile(const std::filesystem::path &file) {
+  std::ifstream in(file);
+  if (!in.is_open())
+    return false;
+
+  m_profile.clear();
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    // lines which do not parse are dropped, the header is estimated again
+    auto tab = line.find('\t');
+    if (tab == 0 || tab == std::string::npos)
+      continue;
+    size_t bytes = 0;
+    auto number = line.data();
+    auto [end, ec] = std::from_chars(number, number + tab, bytes);
+    if (ec != std::errc() || end != number + tab)
+      continue;
+    m_profile[line.substr(tab + 1)] = bytes;
+  }
+  m_dirty = false;
+  return true;
+}
+
+bool BatchScheduler::SaveProfile(const std::filesystem::path &file) {
+  if (!m_dirty && std::filesystem::exists(file))
+    return true;
+
+  std::ostringstream content;
+  for (auto &[header, bytes] : m_profile)
+    content << bytes << "\t" << header << "\n";
+
+  std::ofstream out(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!out.is_open())
+    return false;
+  out << content.str();
+  m_dirty = false;
+  return out.good();
+}
+
+size_t BatchScheduler::GetEstimate(const std::string &header) const {
+  auto it = m_profile.find(header);
+  if (it != m_profile.end())
+    return it->second;
+  if (m_profile.empty())
+    return s_defaultEstimate;
+  // new headers usually look like the other ones of the project
+  size_t total = 0;
+  for (auto &[name, bytes] : m_profile)
+    total += bytes;
+  return total / m_profile.size();
+}
+
+void BatchScheduler::Run(const std::vector<std::string> &headers,
+                         const std::function<size_t(size_t)> &run) {
+  std::vector<size_t> estimates;
+  for (auto &header : headers)
+    estimates.push_back(GetEstimate(header));
+
+  // largest first, small parses fill the remaining budget
+  std::vector<size_t> pending(headers.size());
+  std::iota(pending.begin(), pending.end(), 0);
+  std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b) {
+    return estimates[a] > estimates[b];
+  });
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t reserved = 0;
+  unsigned running = 0;
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!pending.empty()) {
+      auto it = std::find_if(pending.begin(), pending.end(), [&](size_t i) {
+        return running == 0 || m_budget == 0 ||
+               reserved + estimates[i] <= m_budget;
+      });
+      if (it == pending.end()) {
+        cv.wait(lock);
+        continue;
+      }
+
+      size_t index = *it;
+      pending.erase(it);
+      reserved += estimates[index];
+      ++running;
+      lock.unlock();
+
+      size_t measured = run(index);
+      ReleaseFreeMemory();
+
+      lock.lock();
+      reserved -= estimates[index];
+      --running;
+      if (measured > 0) {
+        m_profile[headers[index]] = measured;
+        m_dirty = true;
+      }
+      cv.notify_all();
+    }
+  };
+
+  unsigned threadCnt =
+      static_cast<unsigned>(std::min<size_t>(m_threads, headers.size()));
+  if (threadCnt <= 1) {
+    worker();
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < threadCnt; ++i)
+    threads.emplace_back(worker);
+  for (auto &thread : threads)
+    thread.join();
+}
+
+size_t BatchScheduler::GetPeakProcessMemory() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+void BatchScheduler::ReleaseFreeMemory() {
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+// Run the parses of a batch on worker threads while keeping the expected
+// memory of the parses in flight below a budget. The peak memory of each
+// header is remembered in a profile file from the earlier runs:
+//   <bytes> \t <header>
+// A header which is larger than the whole budget is parsed alone.
+class BatchScheduler {
+  unsigned m_threads;
+  size_t m_budget; // bytes, 0 is unlimited
+  std::map<std::string, size_t> m_profile;
+  bool m_dirty = false;
+
+public:
+  BatchScheduler(unsigned threads, size_t budget);
+  ~BatchScheduler() = default;
+
+  bool LoadProfile(const std::filesystem::path &file);
+  // Only writes the file if new measurements have been recorded.
+  bool SaveProfile(const std::filesystem::path &file);
+
+  // Peak memory of the last parse of `header`, or a guess from the others.
+  size_t GetEstimate(const std::string &header) const;
+
+  // Call run(i) for every header, the largest ones first. run returns the
+  // measured peak memory of the parse, or 0 if nothing has been parsed.
+  void Run(const std::vector<std::string> &headers,
+           const std::function<size_t(size_t)> &run);
+
+  // Peak resident memory of the process.
+  static size_t GetPeakProcessMemory();
+  // Give the memory freed by the last parse back to the system.
+  static void ReleaseFreeMemory();
+};
+} // namespace PReflTool
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+struct Enumerator {
+  std::string name;
+  // bits of the value, sign extended for signed underlying types
+  uint64_t value = 0;
+};
+
+class CxxEnum {
+  std::string m_name;
+  std::vector<std::string> m_namespaces;
+  std::string m_usr;
+  bool m_signed;
+  std::vector<Enumerator> m_enumerators;
+
+public:
+  CxxEnum(std::string name, std::vector<std::string> nsps, bool isSigned)
+      : m_name(name), m_namespaces(nsps), m_signed(isSigned) {}
+
+  std::string GetName() const { return m_name; }
+
+  // Qualified name with namespaces/outer classes, e.g. RenderNsp::EMode
+  std::string GetFullName() const {
+    std::string name = "";
+    for (auto &nsp : m_namespaces) {
+      name += nsp + "::";
+    }
+    return name + m_name;
+  }
+
+  const std::vector<std::string> &GetNamespaces() const { return m_namespaces; }
+  const std::string &GetUSR() const { return m_usr; }
+  bool IsSigned() const { return m_signed; }
+  const std::vector<Enumerator> &GetEnumerators() const {
+    return m_enumerators;
+  }
+
+  void SetUSR(std::string usr) { m_usr = usr; }
+
+  void PushEnumerator(std::string name, uint64_t value) {
+    m_enumerators.push_back({name, value});
+  }
+
+  // a < b in the value order of the underlying type
+  bool Less(uint64_t a, uint64_t b) const {
+    return m_signed ? static_cast<int64_t>(a) < static_cast<int64_t>(b)
+                    : a < b;
+  }
+};
+} // namespace PReflTool
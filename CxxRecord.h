@@ -2,14 +2,67 @@
 
 #include "Attributes.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 namespace PReflTool {
 
+struct GpuMember;
+
+// Shape of a field in a GPU buffer (std140/std430), read from the clang type.
+// A matrix is `columns` column vectors of `rows` components, stored one
+// column after the other on the CPU as well.
+struct GpuType {
+  enum class EKind : uint8_t {
+    None,   // can not be placed in a GPU buffer
+    Scalar, // scalar, vector or matrix
+    Struct
+  };
+  enum class EScalar : uint8_t { Float, Double, Int, UInt, Bool };
+
+  EKind kind = EKind::None;
+  EScalar scalar = EScalar::Float;
+  uint32_t rows = 1;
+  uint32_t columns = 1;
+  // array elements, 0 when the type is not an array
+  uint32_t count = 0;
+  // size of the whole type on the CPU, in bytes
+  uint64_t cpuSize = 0;
+  std::vector<GpuMember> members;
+};
+
+struct GpuMember {
+  std::string name;
+  uint64_t cpuOffset = 0;
+  GpuType type;
+};
+
 struct Field {
   std::string name;
   std::vector<std::unique_ptr<Attr>> attrs;
+  bool isStatic = false;
+  // Layout computed by clang, in bytes. 0 for static members and when the
+  // layout depends on template parameters.
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  // trivially copyable without padding, so its bytes are its value
+  bool isPlainBytes = false;
+  GpuType gpu;
+};
+
+struct MethodParam {
+  std::string type; // as spelled in the generated code
+  std::string name;
+};
+
+struct Method {
+  std::string name;
+  std::string returnType;
+  std::vector<MethodParam> params;
+  bool isConst = false;
+  bool isStatic = false;
 };
 
 enum class ECxxRecordType {
@@ -28,10 +81,24 @@ class CxxRecord {
   std::string m_name;
   std::vector<std::string> m_namespaces;
   std::vector<std::string> m_templates;
+  // declarations of the template parameters, e.g. "typename T", "int N"
+  std::vector<std::string> m_templateDecls;
+  // arguments of the concrete specializations which get their own full
+  // ReflData specialization
+  std::vector<std::vector<std::string>> m_specializations;
   std::vector<std::string> m_bases;
+  // clang USR of the record and of its bases (empty when unknown), used to
+  // identify records across headers
+  std::string m_usr;
+  std::vector<std::string> m_baseUSRs;
   bool m_hasMetaFlag;
+  // annotated with SOA
+  bool m_generateSoA = false;
+  // declared inside another record
+  bool m_isNested = false;
 
   std::vector<std::unique_ptr<Field>> m_fields;
+  std::vector<Method> m_methods;
 
   const ECxxRecordType m_type;
   EAccessPermission m_curFlag;
@@ -42,6 +109,8 @@ public:
             ECxxRecordType type)
       : m_name(name), m_namespaces(nsps), m_templates(tmps),
         m_hasMetaFlag(hasMetaFlag), m_type(type) {
+    for (auto &tmp : m_templates)
+      m_templateDecls.push_back("typename " + tmp);
     switch (m_type) {
     case ECxxRecordType::Struct:
       m_curFlag = EAccessPermission::Public;
@@ -58,20 +127,78 @@ public:
 
   std::string GetName() const { return m_name; }
 
+  // Qualified name without template parameters, e.g. TestCase8Nsp::TestCase8
+  std::string GetTemplateName() const {
+    std::string name = "";
+    for (auto &nsp : m_namespaces) {
+      name += nsp + "::";
+    }
+    return name + m_name;
+  }
+
+  // Qualified name with namespaces/outer classes and template parameters,
+  // e.g. TestCase8Nsp::TestCase8<T1, T2>
+  std::string GetFullName() const {
+    std::string name = GetTemplateName();
+
+    if (m_templates.size() > 0) {
+      name += "<";
+      for (size_t i = 0; i < m_templates.size() - 1; ++i) {
+        name += m_templates[i] + ", ";
+      }
+      name += m_templates.back() + ">";
+    }
+    return name;
+  }
+
   const std::vector<std::string> &GetNamespaces() const { return m_namespaces; }
   const std::vector<std::string> &GetTemplates() const { return m_templates; }
+  const std::vector<std::string> &GetTemplateDecls() const {
+    return m_templateDecls;
+  }
+  const std::vector<std::vector<std::string>> &GetSpecializations() const {
+    return m_specializations;
+  }
   const std::vector<std::string> &GetBases() const { return m_bases; }
+  const std::vector<std::string> &GetBaseUSRs() const { return m_baseUSRs; }
+  const std::string &GetUSR() const { return m_usr; }
   const std::vector<std::unique_ptr<Field>> &GetFields() const {
     return m_fields;
   }
 
+  const std::vector<Method> &GetMethods() const { return m_methods; }
+
+  ECxxRecordType GetType() const { return m_type; }
+
   bool IsNeedGenerate() const { return m_hasMetaFlag; }
+  bool IsGenerateSoA() const { return m_generateSoA; }
+  bool IsNested() const { return m_isNested; }
 
   void PushField(std::unique_ptr<Field> &field) {
     m_fields.emplace_back(std::move(field));
   }
 
-  void AddBase(std::string base) { m_bases.push_back(base); }
+  void PushMethod(Method method) { m_methods.push_back(std::move(method)); }
+
+  void AddBase(std::string base, std::string usr = "") {
+    m_bases.push_back(base);
+    m_baseUSRs.push_back(usr);
+  }
+
+  void SetUSR(std::string usr) { m_usr = usr; }
+  void SetGenerateSoA(bool generate) { m_generateSoA = generate; }
+  void SetNested(bool nested) { m_isNested = nested; }
+
+  void SetTemplateDecls(std::vector<std::string> &decls) {
+    if (decls.size() == m_templates.size())
+      m_templateDecls = decls;
+  }
+
+  void AddSpecialization(std::vector<std::string> args) {
+    if (std::find(m_specializations.begin(), m_specializations.end(), args) ==
+        m_specializations.end())
+      m_specializations.push_back(std::move(args));
+  }
 
   void SetCurrentAccessPermission(EAccessPermission permission) {
     m_curFlag = permission;
@@ -1,27 +1,518 @@
 #include "Generator.h"
+#include "IRCache.h"
+#include "SchemaWriter.h"
+#include "runtime/PReflEnum.h"
+#include "runtime/PReflTypeId.h"
 
-#include <iostream>
+#include <cinttypes>
+#include <cstdio>
+#include <limits>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 
 using namespace PReflTool;
 
 static const char *s_generatedDir = "generated";
+// Smaller outputs are not worth starting threads for.
+static const size_t s_parallelRecordThreshold = 256;
 
-Generator::Generator(std::string file) {
+namespace {
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+// Split "a, std::pair<b, c>" at the top level commas.
+std::vector<std::string> SplitTemplateArgs(const std::string &str) {
+  std::vector<std::string> args;
+  std::string cur;
+  int depth = 0;
+  for (char c : str) {
+    if (c == '<' || c == '(' || c == '[')
+      ++depth;
+    else if (c == '>' || c == ')' || c == ']')
+      --depth;
+
+    if (c == ',' && depth == 0) {
+      args.push_back(cur);
+      cur.clear();
+    } else if (!(cur.empty() && c == ' ')) {
+      cur += c;
+    }
+  }
+  while (!cur.empty() && cur.back() == ' ')
+    cur.pop_back();
+  if (!cur.empty())
+    args.push_back(cur);
+  return args;
+}
+
+const RangeAnnotate *FindRange(const Field *field) {
+  for (auto &attr : field->attrs) {
+    if (attr->GetName().compare(RangeAnnotate::name) == 0) {
+      auto *range = static_cast<const RangeAnnotate *>(attr.get());
+      // both bounds are needed
+      return range->cnt >= 2 ? range : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+const StepAnnotate *FindStep(const Field *field) {
+  for (auto &attr : field->attrs) {
+    if (attr->GetName().compare(StepAnnotate::name) == 0) {
+      auto *step = static_cast<const StepAnnotate *>(attr.get());
+      return step->step > 0. ? step : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+bool HasKernels(const CxxRecord *record) {
+  return std::any_of(record->GetFields().begin(), record->GetFields().end(),
+                     [](auto &field) {
+                       return FindRange(field.get()) || FindStep(field.get());
+                     });
+}
+
+// Non-static fields get a column in the SoA container.
+std::vector<const Field *> GetSoAFields(const CxxRecord *record) {
+  std::vector<const Field *> fields;
+  if (!record->IsGenerateSoA())
+    return fields;
+  for (auto &field : record->GetFields()) {
+    if (!field->isStatic)
+      fields.push_back(field.get());
+  }
+  return fields;
+}
+
+// Non-static fields are hashed by the generated Hasher.
+std::vector<const Field *> GetHashedFields(const CxxRecord *record) {
+  std::vector<const Field *> fields;
+  for (auto &field : record->GetFields()) {
+    if (!field->isStatic)
+      fields.push_back(field.get());
+  }
+  return fields;
+}
+
+size_t NextPowerOfTwo(size_t n) {
+  size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+// Perfect hash of the keys, see PRefl::EnumHashIndex.
+struct HashIndex {
+  std::vector<uint32_t> displacements;
+  std::vector<uint32_t> slots; // key index + 1, 0 is empty
+};
+
+// Equal hashes can not be told apart by the index.
+bool HasDuplicate(std::vector<uint64_t> hashes) {
+  std::sort(hashes.begin(), hashes.end());
+  return std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end();
+}
+
+// Hash and displace: the largest buckets are placed first, each one with the
+// first displacement which moves all of its keys into free slots. The table
+// grows when a bucket can not be placed.
+HashIndex BuildHashIndex(const std::vector<uint64_t> &hashes) {
+  const uint32_t maxDisplacement = 1u << 16;
+  size_t bucketCnt = NextPowerOfTwo(std::max<size_t>(1, hashes.size() / 2));
+  size_t slotCnt = NextPowerOfTwo(std::max<size_t>(1, hashes.size() * 5 / 4));
+
+  std::vector<std::vector<uint32_t>> buckets(bucketCnt);
+  for (uint32_t i = 0; i < hashes.size(); ++i)
+    buckets[hashes[i] & (bucketCnt - 1)].push_back(i);
+  std::vector<size_t> order(bucketCnt);
+  for (size_t i = 0; i < bucketCnt; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  while (true) {
+    HashIndex index{std::vector<uint32_t>(bucketCnt),
+                    std::vector<uint32_t>(slotCnt)};
+    bool placed = true;
+    std::vector<uint64_t> candidates;
+    for (size_t b : order) {
+      auto &keys = buckets[b];
+      if (keys.empty())
+        break;
+
+      uint32_t d = 0;
+      for (; d < maxDisplacement; ++d) {
+        candidates.clear();
+        for (auto key : keys) {
+          auto slot = PRefl::EnumDetail::Mix(hashes[key] ^ d) & (slotCnt - 1);
+          if (index.slots[slot] != 0 ||
+              std::find(candidates.begin(), candidates.end(), slot) !=
+                  candidates.end())
+            break;
+          candidates.push_back(slot);
+        }
+        if (candidates.size() == keys.size())
+          break;
+      }
+      if (d == maxDisplacement) {
+        placed = false;
+        break;
+      }
+      index.displacements[b] = d;
+      for (size_t i = 0; i < keys.size(); ++i)
+        index.slots[candidates[i]] = keys[i] + 1;
+    }
+    if (placed)
+      return index;
+    slotCnt *= 2;
+  }
+}
+
+// Size and alignment of a type in a GPU block, in bytes.
+struct GpuLayout {
+  uint64_t size = 0;
+  uint64_t align = 1;
+};
+
+uint64_t RoundUp(uint64_t value, uint64_t align) {
+  return (value + align - 1) / align * align;
+}
+
+uint64_t GetScalarSize(GpuType::EScalar scalar) {
+  return scalar == GpuType::EScalar::Double ? 8 : 4;
+}
+
+// A vector of `rows` components: vec2 is aligned to two components, vec3 and
+// vec4 to four.
+GpuLayout GetGpuVectorLayout(const GpuType &type) {
+  auto n = GetScalarSize(type.scalar);
+  return {type.rows * n, (type.rows == 1 ? 1 : type.rows == 2 ? 2 : 4) * n};
+}
+
+GpuLayout GetGpuLayout(const GpuType &type, bool std140);
+
+// Arrays and matrix columns are rounded up to a vec4 in std140.
+uint64_t GetGpuStride(const GpuLayout &element, bool std140) {
+  auto stride = RoundUp(element.size, element.align);
+  return std140 ? RoundUp(stride, 16) : stride;
+}
+
+// One element of `type`, the whole type when it is not an array.
+GpuLayout GetGpuElementLayout(const GpuType &type, bool std140) {
+  if (type.kind == GpuType::EKind::Struct) {
+    GpuLayout layout;
+    for (auto &member : type.members) {
+      auto memberLayout = GetGpuLayout(member.type, std140);
+      layout.size = RoundUp(layout.size, memberLayout.align) + memberLayout.size;
+      layout.align = std::max(layout.align, memberLayout.align);
+    }
+    if (std140)
+      layout.align = RoundUp(layout.align, 16);
+    layout.size = RoundUp(layout.size, layout.align);
+    return layout;
+  }
+  auto column = GetGpuVectorLayout(type);
+  if (type.columns == 1)
+    return column;
+  // matrices are arrays of their column vectors
+  return {GetGpuStride(column, std140) * type.columns,
+          std140 ? RoundUp(column.align, 16) : column.align};
+}
+
+GpuLayout GetGpuLayout(const GpuType &type, bool std140) {
+  auto element = GetGpuElementLayout(type, std140);
+  if (type.count == 0)
+    return element;
+  return {GetGpuStride(element, std140) * type.count,
+          std140 ? RoundUp(element.align, 16) : element.align};
+}
+
+// Copy of `size` CPU bytes from `source` to `gpuOffset` in the block, or a
+// loop over the elements of an array when `count` is not 0. The CPU offsets
+// are the ones clang computed, they only decide which copies are merged.
+struct GpuCopy {
+  std::string source; // expression of the first CPU byte
+  uint64_t cpuOffset = 0;
+  uint64_t gpuOffset = 0;
+  uint64_t size = 0;
+  bool isBool = false;
+  uint32_t count = 0;
+  uint64_t gpuStride = 0;
+  std::vector<GpuCopy> body = {}; // the elements of a loop
+};
+
+// Copies of a value of `type`, the lvalue `expr`, to the block. `depth`
+// names the indices of the loops around it.
+void AppendGpuCopies(const GpuType &type, const std::string &expr,
+                     uint64_t cpuOffset, uint64_t gpuOffset, bool std140,
+                     size_t depth, std::vector<GpuCopy> &copies) {
+  if (type.count > 0) {
+    auto element = type;
+    element.count = 0;
+    element.cpuSize = type.cpuSize / type.count;
+    auto stride = GetGpuStride(GetGpuElementLayout(element, std140), std140);
+    auto index = "i" + std::to_string(depth);
+    std::vector<GpuCopy> body;
+    AppendGpuCopies(element, expr + "[" + index + "]", 0, 0, std140,
+                    depth + 1, body);
+    // elements without padding on both sides are one copy
+    if (body.size() == 1 && body[0].count == 0 && !body[0].isBool &&
+        body[0].size == element.cpuSize && body[0].size == stride) {
+      copies.push_back({"GpuDetail::Bytes(" + expr + ")", cpuOffset,
+                        gpuOffset, type.cpuSize});
+      return;
+    }
+    // bools of one element after the other, 4 bytes each in the block
+    if (body.size() == 1 && body[0].count == 0 && body[0].isBool &&
+        body[0].size == element.cpuSize && body[0].size * 4 == stride) {
+      copies.push_back({"GpuDetail::Bytes(" + expr + ")", cpuOffset,
+                        gpuOffset, type.count * body[0].size, true});
+      return;
+    }
+    GpuCopy loop;
+    loop.cpuOffset = cpuOffset;
+    loop.gpuOffset = gpuOffset;
+    loop.count = type.count;
+    loop.gpuStride = stride;
+    loop.body = std::move(body);
+    copies.push_back(std::move(loop));
+    return;
+  }
+
+  if (type.kind == GpuType::EKind::Struct) {
+    uint64_t offset = 0;
+    for (auto &member : type.members) {
+      auto layout = GetGpuLayout(member.type, std140);
+      offset = RoundUp(offset, layout.align);
+      AppendGpuCopies(member.type, expr + "." + member.name,
+                      cpuOffset + member.cpuOffset, gpuOffset + offset, std140,
+                      depth, copies);
+      offset += layout.size;
+    }
+    return;
+  }
+
+  bool isBool = type.scalar == GpuType::EScalar::Bool;
+  auto column = GetGpuVectorLayout(type);
+  auto columnSize = isBool ? type.rows : column.size;
+  auto source = "GpuDetail::Bytes(" + expr + ")";
+  auto stride = GetGpuStride(column, std140);
+  if (type.columns == 1 || columnSize == stride) {
+    copies.push_back({source, cpuOffset, gpuOffset, columnSize * type.columns,
+                      isBool});
+    return;
+  }
+  for (uint32_t i = 0; i < type.columns; ++i) {
+    copies.push_back({i == 0 ? source
+                             : source + " + " + std::to_string(i * columnSize),
+                      cpuOffset + i * columnSize, gpuOffset + i * stride,
+                      columnSize});
+  }
+}
+
+// Adjacent copies which are contiguous on the CPU and in the block are one
+// memcpy, guarded like the runs of Hasher.
+void WriteGpuCopies(const std::vector<GpuCopy> &copies, const std::string &out,
+                    size_t depth, std::ostream &genFile) {
+  std::string indent(8 + depth * 4, ' ');
+  auto writeCopy = [&](const std::string &indent, const GpuCopy &copy) {
+    genFile << indent
+            << (copy.isBool ? "GpuDetail::PackBools(" : "std::memcpy(") << out
+            << " + " << copy.gpuOffset << ", " << copy.source << ", "
+            << copy.size << ");\n";
+  };
+  for (size_t i = 0; i < copies.size();) {
+    if (copies[i].count > 0) {
+      auto index = "i" + std::to_string(depth);
+      auto element = "out" + std::to_string(depth + 1);
+      genFile << indent << "for (size_t " << index << " = 0; " << index
+              << " < " << copies[i].count << "; ++" << index << ") {\n";
+      genFile << indent << "    unsigned char *" << element << " = " << out
+              << " + " << copies[i].gpuOffset << " + " << index << " * "
+              << copies[i].gpuStride << ";\n";
+      WriteGpuCopies(copies[i].body, element, depth + 1, genFile);
+      genFile << indent << "}\n";
+      ++i;
+      continue;
+    }
+
+    size_t end = i + 1;
+    uint64_t size = copies[i].size;
+    while (!copies[i].isBool && end < copies.size() &&
+           copies[end].count == 0 && !copies[end].isBool &&
+           copies[end].cpuOffset == copies[i].cpuOffset + size &&
+           copies[end].gpuOffset == copies[i].gpuOffset + size)
+      size += copies[end++].size;
+    if (end - i == 1) {
+      writeCopy(indent, copies[i]);
+      i = end;
+      continue;
+    }
+
+    auto &last = copies[end - 1];
+    genFile << indent << "if (GpuDetail::IsRun(" << copies[i].source << ", "
+            << last.source << " + " << last.size << ", " << size << ")) {\n";
+    writeCopy(indent + "    ", {copies[i].source, 0, copies[i].gpuOffset, size});
+    genFile << indent << "} else {\n";
+    for (size_t j = i; j < end; ++j)
+      writeCopy(indent + "    ", copies[j]);
+    genFile << indent << "}\n";
+    i = end;
+  }
+}
+
+// Records of public fields which all have a place in a GPU block.
+bool HasGpuBlock(const CxxRecord *record) {
+  auto fields = GetHashedFields(record);
+  return record->GetTemplates().empty() && !fields.empty() &&
+         std::all_of(fields.begin(), fields.end(), [](const Field *field) {
+           return field->gpu.kind != GpuType::EKind::None;
+         });
+}
+
+void WriteHashIndex(const std::string &name, const HashIndex &index,
+                    std::ostream &out) {
+  auto writeArray = [&out](const std::vector<uint32_t> &values) {
+    out << "{";
+    for (size_t i = 0; i < values.size(); ++i)
+      out << (i > 0 ? ", " : "") << values[i];
+    out << "}";
+  };
+  out << "    constexpr static auto " << name << " = EnumHashIndex<"
+      << index.displacements.size() << ", " << index.slots.size() << "> {\n";
+  out << "        ";
+  writeArray(index.displacements);
+  out << ",\n        ";
+  writeArray(index.slots);
+  out << "\n    };\n";
+}
+} // namespace
+
+std::string
+Generator::SubstituteTemplateParams(const std::string &text,
+                                    const std::vector<std::string> &params,
+                                    const std::vector<std::string> &args) {
+  std::map<std::string, std::string> values;
+  std::string packName;
+  for (size_t i = 0; i < params.size() && i <= args.size(); ++i) {
+    const auto &param = params[i];
+    if (param.size() > 3 && param.compare(param.size() - 3, 3, "...") == 0) {
+      // the last parameter is a pack and takes the remaining arguments
+      packName = param.substr(0, param.size() - 3);
+      std::string pack;
+      for (size_t j = i; j < args.size(); ++j)
+        pack += (j > i ? ", " : "") + args[j];
+      values[packName] = pack;
+      break;
+    }
+    if (i < args.size())
+      values[param] = args[i];
+  }
+
+  std::string result;
+  for (size_t i = 0; i < text.size();) {
+    if (!IsIdentifierChar(text[i])) {
+      result += text[i++];
+      continue;
+    }
+    size_t end = i;
+    while (end < text.size() && IsIdentifierChar(text[end]))
+      ++end;
+    auto id = text.substr(i, end - i);
+    auto it = values.find(id);
+    if (it == values.end()) {
+      result += id;
+    } else {
+      result += it->second;
+      if (id == packName && text.compare(end, 3, "...") == 0)
+        end += 3;
+    }
+    i = end;
+  }
+  return result;
+}
+
+bool Generator::LoadSpecializations(
+    const std::filesystem::path &file,
+    std::map<std::string, std::vector<std::vector<std::string>>> &specs) {
+  std::ifstream in(file);
+  if (!in.is_open())
+    return false;
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    auto begin = line.find('<');
+    auto end = line.rfind('>');
+    if (line.empty() || line.front() == '#' || begin == std::string::npos ||
+        end == std::string::npos || end < begin)
+      continue;
+
+    auto name = line.substr(0, begin);
+    while (!name.empty() && name.back() == ' ')
+      name.pop_back();
+    auto args = SplitTemplateArgs(line.substr(begin + 1, end - begin - 1));
+    auto &list = specs[name];
+    if (std::find(list.begin(), list.end(), args) == list.end())
+      list.push_back(args);
+  }
+  return true;
+}
+
+Generator::Generator(std::string file, const Options &options)
+    : m_options(options) {
   m_targetFile = std::filesystem::path{file};
   if (!(std::filesystem::exists(m_targetFile) && m_targetFile.has_stem())) {
-    throw std::exception("file does not exist");
+    throw std::runtime_error("file does not exist");
   }
 
   m_resultDir = m_targetFile.parent_path() / s_generatedDir;
-  std::filesystem::create_directory(m_resultDir);
+  if (m_options.writeOutputs)
+    std::filesystem::create_directory(m_resultDir);
 }
 
 std::filesystem::path Generator::GetGeneratedFilePath() {
   return m_resultDir / (m_targetFile.stem().string() + ".gen.inl");
 }
 
+std::filesystem::path Generator::GetIRCacheFilePath() {
+  return m_resultDir / (m_targetFile.stem().string() + ".refl.cache");
+}
+
+std::filesystem::path Generator::GetSchemaFilePath() {
+  return m_resultDir / (m_targetFile.stem().string() + ".refl.bin");
+}
+
+bool Generator::LoadIRCache(uint64_t config) {
+  return IRCache::Read(GetIRCacheFilePath(), m_targetFile, config, m_records,
+                       m_enums, m_dependencies);
+}
+
+bool Generator::SaveIRCache(uint64_t config) {
+  return IRCache::Write(GetIRCacheFilePath(), m_targetFile, config, m_records,
+                        m_enums, m_dependencies);
+}
+
+void Generator::AddDependency(const std::filesystem::path &file) {
+  // the generated file is included by the target, but never an input
+  auto normalized = ProjectIndex::NormalizePath(file);
+  if (normalized.rfind(ProjectIndex::NormalizePath(m_resultDir) + "/", 0) == 0)
+    return;
+  if (std::find(m_dependencies.begin(), m_dependencies.end(), normalized) ==
+      m_dependencies.end())
+    m_dependencies.push_back(normalized);
+}
+
 bool Generator::CheckModifyTime() {
   auto genFile = GetGeneratedFilePath();
   if (!std::filesystem::exists(genFile))
@@ -35,14 +526,34 @@ bool Generator::CheckModifyTime() {
 }
 
 void Generator::Generate() {
-  AddIncludePathToTarget();
+  if (m_options.modifySource)
+    AddIncludePathToTarget();
 
   std::ofstream genFile;
 
   // open generated file
   genFile.open(GetGeneratedFilePath().string(),
                std::ios::out | std::ios::trunc);
+  Generate(genFile);
+  genFile.close();
+
+  if (m_options.emitSchema)
+    SchemaWriter::Write(GetSchemaFilePath(), m_records);
+}
 
+void Generator::AddError(std::string message) {
+  std::lock_guard<std::mutex> lock(m_errorMutex);
+  m_errors.push_back(std::move(message));
+}
+
+void Generator::AddWarning(std::string message) {
+  std::lock_guard<std::mutex> lock(m_errorMutex);
+  m_warnings.push_back(std::move(message));
+}
+
+void Generator::Generate(std::ostream &genFile) {
+  m_errors.clear();
+  m_warnings.clear();
   auto fileName = m_targetFile.stem().string();
   std::transform(fileName.begin(), fileName.end(), fileName.begin(),
                  [](unsigned char c) { return toupper(c); });
@@ -51,92 +562,805 @@ void Generator::Generate() {
   genFile << "//===================================================\n\n";
   genFile << "#ifndef __" << fileName << "__GEN_INL__\n";
   genFile << "#define __" << fileName << "__GEN_INL__\n";
+  if (!m_options.modifySource) {
+    // the target header does not include the generated file, so the
+    // generated file has to make the reflected types visible itself
+    genFile << "#include \"../" << m_targetFile.filename().string()
+            << "\"\n";
+  }
+  if (!m_enums.empty())
+    genFile << "#include \"PReflEnum.h\"\n";
+  if (m_options.pooledNames &&
+      std::any_of(m_records.begin(), m_records.end(),
+                  [](auto &record) { return !record->GetFields().empty(); }))
+    genFile << "#include \"PReflNames.h\"\n";
+  if (m_options.emitHash &&
+      std::any_of(m_records.begin(), m_records.end(), [](auto &record) {
+        return !GetHashedFields(record.get()).empty();
+      }))
+    genFile << "#include \"PReflHash.h\"\n";
+  if (m_options.emitJson &&
+      std::any_of(m_records.begin(), m_records.end(), [](auto &record) {
+        return !GetHashedFields(record.get()).empty();
+      }))
+    genFile << "#include \"PReflJson.h\"\n";
+  if (m_options.gpuLayout != Options::EGpuLayout::None &&
+      std::any_of(m_records.begin(), m_records.end(),
+                  [](auto &record) { return HasGpuBlock(record.get()); }))
+    genFile << "#include \"PReflGpu.h\"\n";
+  if (!m_records.empty() && m_options.emitRegistry)
+    genFile << "#include \"PReflRegistry.h\"\n";
+  if (std::any_of(m_records.begin(), m_records.end(),
+                  [](auto &record) { return !record->GetMethods().empty(); }))
+    genFile << "#include \"PReflMethod.h\"\n";
+  if (m_options.emitKernels &&
+      std::any_of(m_records.begin(), m_records.end(),
+                  [](auto &record) { return HasKernels(record.get()); }))
+    genFile << "#include \"PReflKernels.h\"\n";
+  if (std::any_of(m_records.begin(), m_records.end(), [](auto &record) {
+        return !GetSoAFields(record.get()).empty();
+      }))
+    genFile << "#include \"PReflSoA.h\"\n";
   genFile << "namespace PRefl {\n";
 
-  for (auto &record : m_records) {
-    std::string name = "";
-    const auto &nsps = record->GetNamespaces();
-    for (auto nsp : nsps) {
-      name += nsp + "::";
-    }
-    name += record->GetName();
-
-    std::string tmpDecl = "";
-    tmpDecl = "template<";
-    const auto &tmps = record->GetTemplates();
-    if (tmps.size() > 0) {
-      name += "<";
-      for (size_t i = 0; i < tmps.size() - 1; ++i) {
-        tmpDecl += "typename " + tmps[i] + ", ";
-        name += tmps[i] + ", ";
+  for (auto &cxxEnum : m_enums)
+    WriteEnum(cxxEnum.get(), genFile);
+
+  if (m_options.jobs > 1 && m_records.size() >= s_parallelRecordThreshold) {
+    // Format the records independently on worker threads, then concatenate
+    // them in the original order so the output stays deterministic.
+    std::vector<std::string> buffers(m_records.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+      for (size_t i = next++; i < m_records.size(); i = next++) {
+        std::ostringstream out;
+        WriteRecord(m_records[i].get(), out);
+        buffers[i] = out.str();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    unsigned threadCnt = std::min<size_t>(m_options.jobs, m_records.size());
+    for (unsigned i = 1; i < threadCnt; ++i)
+      threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads)
+      t.join();
+
+    for (auto &buffer : buffers)
+      genFile << buffer;
+  } else {
+    for (auto &record : m_records)
+      WriteRecord(record.get(), genFile);
+  }
+
+  genFile << "}\n";
+  for (auto &record : m_records)
+    WriteSoAAlias(record.get(), genFile);
+  genFile << "#endif\n";
+
+  // in the same order whatever the threads
+  std::sort(m_errors.begin(), m_errors.end());
+  std::sort(m_warnings.begin(), m_warnings.end());
+}
+
+void Generator::WriteEnum(const CxxEnum *cxxEnum, std::ostream &genFile) {
+  auto name = cxxEnum->GetFullName();
+  auto &enumerators = cxxEnum->GetEnumerators();
+
+  // the first enumerator of each value, ordered by value
+  std::vector<size_t> unique;
+  for (size_t i = 0; i < enumerators.size(); ++i)
+    unique.push_back(i);
+  std::stable_sort(unique.begin(), unique.end(), [&](size_t a, size_t b) {
+    return cxxEnum->Less(enumerators[a].value, enumerators[b].value);
+  });
+  unique.erase(std::unique(unique.begin(), unique.end(),
+                           [&](size_t a, size_t b) {
+                             return enumerators[a].value ==
+                                    enumerators[b].value;
+                           }),
+               unique.end());
+
+  std::vector<uint64_t> nameHashes;
+  for (auto &enumerator : enumerators)
+    nameHashes.push_back(PRefl::EnumDetail::Hash(enumerator.name));
+  if (HasDuplicate(nameHashes)) {
+    AddError("hash collision between the enumerators of " + name +
+             ", EnumData is not generated");
+    return;
+  }
+
+  auto &minEnumerator = enumerators[unique.front()];
+  auto &maxEnumerator = enumerators[unique.back()];
+  bool isDense =
+      maxEnumerator.value - minEnumerator.value == unique.size() - 1;
+
+  genFile << "template<>\n";
+  genFile << "struct EnumData<" << name << ">\n";
+  genFile << "{\n";
+  genFile << "    constexpr static size_t count = " << enumerators.size()
+          << ";\n";
+  genFile << "    constexpr static auto min = " << name
+          << "::" << minEnumerator.name << ";\n";
+  genFile << "    constexpr static auto max = " << name
+          << "::" << maxEnumerator.name << ";\n";
+
+  genFile << "    constexpr static auto entries = std::array<EnumEntry<"
+          << name << ">, " << enumerators.size() << "> {{\n";
+  for (size_t i = 0; i < enumerators.size(); ++i) {
+    genFile << "        { " << name << "::" << enumerators[i].name << ", \""
+            << enumerators[i].name << "\" }"
+            << (i + 1 < enumerators.size() ? ",\n" : "\n");
+  }
+  genFile << "    }};\n";
+
+  genFile << "    constexpr static bool isDense = "
+          << (isDense ? "true" : "false") << ";\n";
+  if (isDense) {
+    genFile << "    constexpr static auto names = std::array<std::string_view, "
+            << unique.size() << "> {\n";
+    for (size_t i = 0; i < unique.size(); ++i) {
+      genFile << "        \"" << enumerators[unique[i]].name << "\""
+              << (i + 1 < unique.size() ? ",\n" : "\n");
+    }
+    genFile << "    };\n";
+  } else {
+    std::vector<uint64_t> hashes;
+    for (auto i : unique)
+      hashes.push_back(PRefl::EnumDetail::Hash(enumerators[i].value));
+    auto index = BuildHashIndex(hashes);
+    // slots refer to the unique values, map them back to the entries
+    for (auto &slot : index.slots) {
+      if (slot != 0)
+        slot = static_cast<uint32_t>(unique[slot - 1] + 1);
+    }
+    WriteHashIndex("valueIndex", index, genFile);
+  }
+
+  WriteHashIndex("nameIndex", BuildHashIndex(nameHashes), genFile);
+  genFile << "};\n";
+}
+
+void Generator::WriteKernels(const CxxRecord *record,
+                             const std::string &tmpDecl,
+                             std::ostream &genFile) {
+  auto name = record->GetFullName();
+  auto &fields = record->GetFields();
+  auto writeLoop = [&](const char *function, auto writeField) {
+    if (!record->GetTemplates().empty())
+      genFile << tmpDecl << "\n";
+    genFile << "inline void " << function << "(" << name
+            << " *records, size_t count) {\n";
+    genFile << "    for (size_t i = 0; i < count; ++i) {\n";
+    genFile << "        auto &record = records[i];\n";
+    for (auto &field : fields)
+      writeField(field.get());
+    genFile << "    }\n";
+    genFile << "}\n";
+  };
+
+  if (std::any_of(fields.begin(), fields.end(),
+                  [](auto &field) { return FindRange(field.get()); })) {
+    writeLoop("ClampToRange", [&](const Field *field) {
+      if (auto *range = FindRange(field))
+        genFile << "        KernelDetail::Clamp(record." << field->name
+                << ", " << FormatNumber(range->vmin) << ", "
+                << FormatNumber(range->vmax) << ");\n";
+    });
+  }
+  if (std::any_of(fields.begin(), fields.end(),
+                  [](auto &field) { return FindStep(field.get()); })) {
+    writeLoop("SnapToStep", [&](const Field *field) {
+      if (auto *step = FindStep(field)) {
+        // steps start at the lower bound of the range
+        auto *range = FindRange(field);
+        genFile << "        KernelDetail::Snap(record." << field->name << ", "
+                << FormatNumber(step->step) << ", "
+                << FormatNumber(range ? range->vmin : 0.) << ");\n";
       }
-      tmpDecl += "typename " + tmps.back();
-      name += tmps.back() + ">";
+    });
+  }
+}
+
+// Adjacent plain fields are hashed as one byte range. The types and the layout
+// are the ones clang saw, the generated code checks both again for the
+// compiler which builds it.
+void Generator::WriteHash(const CxxRecord *record, const std::string &tmpDecl,
+                          std::ostream &genFile) {
+  auto fields = GetHashedFields(record);
+  if (fields.empty())
+    return;
+
+  auto name = record->GetFullName();
+  genFile << tmpDecl << "\n";
+  genFile << "struct Hasher<" << name << ">\n";
+  genFile << "{\n";
+  // a template, so a field without hash only fails when the hash is used
+  genFile << "    template <typename Record>\n";
+  genFile << "    static uint64_t Hash(const Record &record, uint64_t seed) "
+             "{\n";
+  genFile << "        uint64_t h = seed;\n";
+  auto combine = [&](const char *indent, const Field *field) {
+    genFile << indent << "h = HashDetail::Combine(h, record." << field->name
+            << ");\n";
+  };
+  size_t runCnt = 0;
+  for (size_t i = 0; i < fields.size();) {
+    size_t end = i + 1;
+    if (fields[i]->isPlainBytes && fields[i]->size > 0) {
+      while (end < fields.size() && fields[end]->isPlainBytes &&
+             fields[end]->offset ==
+                 fields[end - 1]->offset + fields[end - 1]->size)
+        ++end;
+    }
+    if (end - i == 1) {
+      combine("        ", fields[i]);
+      i = end;
+      continue;
+    }
+
+    auto run = "run" + std::to_string(runCnt++);
+    genFile << "        constexpr size_t " << run << " = ";
+    for (size_t j = i; j < end; ++j)
+      genFile << (j > i ? " + " : "") << "sizeof(record." << fields[j]->name
+              << ")";
+    genFile << ";\n";
+    // both checks fold to constants
+    genFile << "        if (HashDetail::IsPlainRun<";
+    for (size_t j = i; j < end; ++j)
+      genFile << (j > i ? ", " : "") << "decltype(record." << fields[j]->name
+              << ")";
+    genFile << "> &&\n";
+    genFile << "            HashDetail::IsRun(record." << fields[i]->name
+            << ", record." << fields[end - 1]->name << ", " << run
+            << ")) {\n";
+    genFile << "            h = HashDetail::HashRun(h, record."
+            << fields[i]->name << ", " << run << ");\n";
+    genFile << "        } else {\n";
+    for (size_t j = i; j < end; ++j)
+      combine("            ", fields[j]);
+    genFile << "        }\n";
+    i = end;
+  }
+  genFile << "        return h;\n";
+  genFile << "    }\n";
+  genFile << "};\n";
+}
+
+// The keys are complete JSON literals, and the reader finds the field of a
+// key with the same perfect hash as the enumerator names.
+void Generator::WriteJson(const CxxRecord *record, const std::string &tmpDecl,
+                          std::ostream &genFile) {
+  auto fields = GetHashedFields(record);
+  if (!m_options.emitJson || fields.empty())
+    return;
+
+  auto name = record->GetFullName();
+  std::vector<uint64_t> keyHashes;
+  for (auto *field : fields)
+    keyHashes.push_back(PRefl::EnumDetail::Hash(field->name));
+  if (HasDuplicate(keyHashes)) {
+    AddError("hash collision between the fields of " + name +
+             ", JsonCodec is not generated");
+    return;
+  }
+
+  genFile << tmpDecl << "\n";
+  genFile << "struct JsonCodec<" << name << ">\n";
+  genFile << "{\n";
+  genFile << "    constexpr static std::array<std::string_view, "
+          << fields.size() << "> keys = {";
+  for (size_t i = 0; i < fields.size(); ++i)
+    genFile << (i > 0 ? ", " : "") << "\"" << fields[i]->name << "\"";
+  genFile << "};\n";
+  WriteHashIndex("keyIndex", BuildHashIndex(keyHashes), genFile);
+
+  // field names are identifiers, so the keys need no escaping
+  genFile << "    template <typename Record>\n";
+  genFile << "    static void Write(JsonWriter &out, const Record &record) "
+             "{\n";
+  for (size_t i = 0; i < fields.size(); ++i) {
+    genFile << "        out.Raw(\"" << (i > 0 ? "," : "{") << "\\\""
+            << fields[i]->name << "\\\":\");\n";
+    genFile << "        JsonDetail::Write(out, record." << fields[i]->name
+            << ");\n";
+  }
+  genFile << "        out.Char('}');\n";
+  genFile << "    }\n";
+
+  genFile << "    template <typename Record>\n";
+  genFile << "    static bool Read(JsonReader &in, Record &record) {\n";
+  genFile << "        return in.ReadObject([&](std::string_view key) {\n";
+  genFile << "            switch (JsonDetail::FindKey(keyIndex, keys, key)) "
+             "{\n";
+  for (size_t i = 0; i < fields.size(); ++i) {
+    genFile << "            case " << i << ":\n";
+    genFile << "                return JsonDetail::Read(in, record."
+            << fields[i]->name << ");\n";
+  }
+  genFile << "            default:\n";
+  genFile << "                return in.Skip();\n";
+  genFile << "            }\n";
+  genFile << "        });\n";
+  genFile << "    }\n";
+  genFile << "};\n";
+}
+
+// The layout is the one of a block (or a struct in a block) whose members are
+// the non-static fields, in their order.
+void Generator::WriteGpuBlock(const CxxRecord *record, std::ostream &genFile) {
+  // records without fields have nothing to place
+  if (m_options.gpuLayout == Options::EGpuLayout::None ||
+      !record->GetTemplates().empty() || GetHashedFields(record).empty())
+    return;
+  auto name = record->GetFullName();
+  if (!HasGpuBlock(record)) {
+    AddWarning(name + " has fields which can not be placed in a GPU block");
+    return;
+  }
+
+  bool std140 = m_options.gpuLayout == Options::EGpuLayout::Std140;
+  GpuType type;
+  type.kind = GpuType::EKind::Struct;
+  for (auto *field : GetHashedFields(record))
+    type.members.push_back({field->name, field->offset, field->gpu});
+  auto layout = GetGpuElementLayout(type, std140);
+
+  genFile << "template<>\n";
+  genFile << "struct GpuBlock<" << name << ">\n";
+  genFile << "{\n";
+  genFile << "    constexpr static EGpuLayout layout = EGpuLayout::"
+          << (std140 ? "Std140" : "Std430") << ";\n";
+  genFile << "    constexpr static size_t size = " << layout.size << ";\n";
+  genFile << "    constexpr static size_t align = " << layout.align << ";\n";
+  genFile << "    constexpr static std::array<GpuMember, "
+          << type.members.size() << "> members = {{\n";
+  uint64_t offset = 0;
+  for (size_t i = 0; i < type.members.size(); ++i) {
+    auto memberLayout = GetGpuLayout(type.members[i].type, std140);
+    offset = RoundUp(offset, memberLayout.align);
+    genFile << "        { \"" << type.members[i].name << "\", " << offset
+            << ", " << memberLayout.size << " }"
+            << (i + 1 < type.members.size() ? ",\n" : "\n");
+    offset += memberLayout.size;
+  }
+  genFile << "    }};\n";
+
+  std::vector<GpuCopy> copies;
+  AppendGpuCopies(type, "record", 0, 0, std140, 0, copies);
+  genFile << "    template <typename Record>\n";
+  genFile << "    static void PackTo(const Record &record, void *dst) {\n";
+  genFile << "        auto *out = static_cast<unsigned char *>(dst);\n";
+  WriteGpuCopies(copies, "out", 0, genFile);
+  genFile << "    }\n";
+  genFile << "};\n";
+}
+
+void Generator::WriteSoA(const CxxRecord *record, const std::string &tmpDecl,
+                         std::ostream &genFile) {
+  auto fields = GetSoAFields(record);
+  if (fields.empty())
+    return;
+
+  auto name = record->GetFullName();
+  auto column = [](const Field *field) {
+    return "SoADetail::ElementT<decltype(Record::" + field->name + ")>";
+  };
+  // one statement per column
+  auto forEach = [&](const char *indent, auto writeField) {
+    for (auto *field : fields) {
+      genFile << indent;
+      writeField(field);
+      genFile << "\n";
+    }
+  };
+
+  genFile << tmpDecl << "\n";
+  genFile << "class SoA<" << name << ">\n";
+  genFile << "{\n";
+  genFile << "public:\n";
+  genFile << "    using Record = " << name << ";\n";
+  genFile << "    size_t Size() const { return m_" << fields[0]->name
+          << ".size(); }\n";
+  genFile << "    bool Empty() const { return m_" << fields[0]->name
+          << ".empty(); }\n";
+  genFile << "    void Reserve(size_t count) {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "m_" << field->name << ".reserve(count);";
+  });
+  genFile << "    }\n";
+  genFile << "    void Clear() {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "m_" << field->name << ".clear();";
+  });
+  genFile << "    }\n";
+  genFile << "    void Push(const Record &record) {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "SoADetail::Push(m_" << field->name << ", record."
+            << field->name << ");";
+  });
+  genFile << "    }\n";
+  genFile << "    void Pop() {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "m_" << field->name << ".pop_back();";
+  });
+  genFile << "    }\n";
+  genFile << "    Record Get(size_t i) const {\n";
+  genFile << "        Record record{};\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "SoADetail::Store(record." << field->name << ", m_"
+            << field->name << "[i]);";
+  });
+  genFile << "        return record;\n";
+  genFile << "    }\n";
+  genFile << "    void Set(size_t i, const Record &record) {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "SoADetail::Load(m_" << field->name << "[i], record."
+            << field->name << ");";
+  });
+  genFile << "    }\n";
+  // column by column, each loop streams over one array
+  genFile << "    static SoA FromAoS(const Record *records, size_t count) {\n";
+  genFile << "        SoA soa;\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "soa.m_" << field->name << ".resize(count);";
+  });
+  forEach("        ", [&](const Field *field) {
+    genFile << "for (size_t i = 0; i < count; ++i)\n";
+    genFile << "            SoADetail::Load(soa.m_" << field->name
+            << "[i], records[i]." << field->name << ");";
+  });
+  genFile << "        return soa;\n";
+  genFile << "    }\n";
+  genFile << "    void ToAoS(Record *records) const {\n";
+  forEach("        ", [&](const Field *field) {
+    genFile << "for (size_t i = 0; i < Size(); ++i)\n";
+    genFile << "            SoADetail::Store(records[i]." << field->name
+            << ", m_" << field->name << "[i]);";
+  });
+  genFile << "    }\n";
+  for (auto *field : fields) {
+    genFile << "    std::span<" << column(field) << "> " << field->name
+            << "() { return m_" << field->name << "; }\n";
+    genFile << "    std::span<const " << column(field) << "> " << field->name
+            << "() const { return m_" << field->name << "; }\n";
+  }
+  genFile << "private:\n";
+  for (auto *field : fields)
+    genFile << "    std::vector<" << column(field) << "> m_" << field->name
+            << ";\n";
+  genFile << "};\n";
+}
+
+void Generator::WriteSoAAlias(const CxxRecord *record, std::ostream &genFile) {
+  // an alias can not be added to the scope of an outer record
+  if (record->IsNested() || GetSoAFields(record).empty())
+    return;
+
+  auto &nsps = record->GetNamespaces();
+  if (!nsps.empty()) {
+    genFile << "namespace ";
+    for (size_t i = 0; i < nsps.size(); ++i)
+      genFile << (i > 0 ? "::" : "") << nsps[i];
+    genFile << " {\n";
+  }
+  if (!record->GetTemplates().empty()) {
+    auto &tmpDecls = record->GetTemplateDecls();
+    genFile << "template<";
+    for (size_t i = 0; i < tmpDecls.size(); ++i)
+      genFile << (i > 0 ? ", " : "") << tmpDecls[i];
+    genFile << ">\n";
+  }
+  genFile << "using " << record->GetName() << "SoA = PRefl::SoA<"
+          << record->GetFullName() << ">;\n";
+  if (!nsps.empty())
+    genFile << "}\n";
+}
+
+void Generator::WriteMethodData(const CxxRecord *record,
+                                const std::string &tmpDecl,
+                                const std::string &name,
+                                const std::vector<std::string> &args,
+                                std::ostream &genFile) {
+  // types of a full specialization have the template parameters replaced
+  auto spell = [&](const std::string &type) {
+    return args.empty()
+               ? type
+               : SubstituteTemplateParams(type, record->GetTemplates(), args);
+  };
+  auto &methods = record->GetMethods();
+
+  genFile << tmpDecl << "\n";
+  genFile << "struct MethodData<" << name << ">\n";
+  genFile << "{\n";
+  for (size_t i = 0; i < methods.size(); ++i) {
+    auto &method = methods[i];
+    genFile << "    static void Invoke" << i << "("
+            << (method.isStatic ? "void *" : "void *object") << ", "
+            << (method.params.empty() ? "void *const *" : "void *const *args")
+            << ", void *result) {\n";
+    genFile << "        MethodDetail::Store<" << spell(method.returnType)
+            << ">(result, [&]() -> decltype(auto) {\n";
+    genFile << "            return ";
+    if (method.isStatic)
+      genFile << name << "::";
+    else
+      genFile << "static_cast<" << (method.isConst ? "const " : "") << name
+              << " *>(object)->";
+    genFile << method.name << "(";
+    for (size_t j = 0; j < method.params.size(); ++j) {
+      genFile << (j > 0 ? ", " : "") << "MethodDetail::Arg<"
+              << spell(method.params[j].type) << ">(args[" << j << "])";
+    }
+    genFile << ");\n";
+    genFile << "        });\n";
+    genFile << "    }\n";
+
+    genFile << "    constexpr static auto params" << i
+            << " = std::array<MethodParam, " << method.params.size()
+            << "> {{";
+    for (size_t j = 0; j < method.params.size(); ++j) {
+      genFile << (j > 0 ? "," : "") << "\n        { \""
+              << method.params[j].name << "\", TypeTagOf<"
+              << spell(method.params[j].type) << ">() }";
+    }
+    genFile << (method.params.empty() ? "}};\n" : "\n    }};\n");
+  }
+
+  genFile << "    constexpr static auto methods = std::array<Method, "
+          << methods.size() << "> {{\n";
+  for (size_t i = 0; i < methods.size(); ++i) {
+    auto &method = methods[i];
+    genFile << "        { \"" << method.name << "\", &Invoke" << i
+            << ", TypeTagOf<" << spell(method.returnType) << ">(), params"
+            << i << ".data(), params" << i << ".size(), "
+            << (method.isConst ? "true" : "false") << ", "
+            << (method.isStatic ? "true" : "false") << " }"
+            << (i + 1 < methods.size() ? ",\n" : "\n");
+  }
+  genFile << "    }};\n";
+  genFile << "};\n";
+}
+
+uint64_t Generator::GetTypeId(const std::string &name) {
+  return PRefl::TypeIdOf(name);
+}
+
+std::vector<std::string> Generator::GetTypeNames() const {
+  std::vector<std::string> names;
+  for (auto &record : m_records) {
+    if (record->GetTemplates().empty())
+      names.push_back(record->GetFullName());
+    for (auto &args : GetSpecializationArgs(record.get()))
+      names.push_back(GetSpecializationName(record.get(), args));
+  }
+  return names;
+}
+
+// Full specializations for the concrete arguments found in the target file or
+// listed by --specializations.
+std::vector<std::vector<std::string>>
+Generator::GetSpecializationArgs(const CxxRecord *record) const {
+  const auto &tmps = record->GetTemplates();
+  if (tmps.empty())
+    return {};
+
+  auto specs = record->GetSpecializations();
+  auto configured = m_options.specializations.find(record->GetTemplateName());
+  if (configured != m_options.specializations.end()) {
+    for (auto &args : configured->second) {
+      if (std::find(specs.begin(), specs.end(), args) == specs.end())
+        specs.push_back(args);
+    }
+  }
 
+  bool hasPack = tmps.back().size() > 3 &&
+                 tmps.back().compare(tmps.back().size() - 3, 3, "...") == 0;
+  std::vector<std::vector<std::string>> result;
+  for (auto &args : specs) {
+    if (hasPack ? args.size() + 1 < tmps.size() : args.size() != tmps.size())
+      continue;
+    result.push_back(args);
+  }
+  return result;
+}
+
+std::string
+Generator::GetSpecializationName(const CxxRecord *record,
+                                 const std::vector<std::string> &args) {
+  std::string name = record->GetTemplateName() + "<";
+  for (size_t i = 0; i < args.size(); ++i)
+    name += (i > 0 ? ", " : "") + args[i];
+  return name + ">";
+}
+
+void Generator::WriteRecord(const CxxRecord *record, std::ostream &genFile) {
+  std::vector<std::string> bases;
+  for (size_t i = 0; i < record->GetBases().size(); ++i) {
+    const auto &usr = record->GetBaseUSRs()[i];
+    if (!m_index || usr.empty() || m_index->IsReflected(usr))
+      bases.push_back(record->GetBases()[i]);
+  }
+
+  std::string tmpDecl = "";
+  tmpDecl = "template<";
+  const auto &tmpDecls = record->GetTemplateDecls();
+  if (tmpDecls.size() > 0) {
+    for (size_t i = 0; i < tmpDecls.size() - 1; ++i) {
+      tmpDecl += tmpDecls[i] + ", ";
     }
-    tmpDecl += ">";
-    genFile << tmpDecl << "\n";
-    genFile << "struct ReflData<" << name << ">\n";
-    genFile << "{\n";
+    tmpDecl += tmpDecls.back();
+  }
+  tmpDecl += ">";
+  WriteReflData(record, tmpDecl, record->GetFullName(), bases, genFile);
+  if (!record->GetMethods().empty())
+    WriteMethodData(record, tmpDecl, record->GetFullName(), {}, genFile);
+  if (m_options.emitKernels && HasKernels(record))
+    WriteKernels(record, tmpDecl, genFile);
+  WriteSoA(record, tmpDecl, genFile);
+  if (m_options.emitHash)
+    WriteHash(record, tmpDecl, genFile);
+  WriteJson(record, tmpDecl, genFile);
+  WriteGpuBlock(record, genFile);
+  if (record->GetTemplates().empty())
+    WriteRegistration(record, record->GetFullName(), genFile);
 
-    genFile << "    constexpr static bool hasData = ";
-    auto &fields = record->GetFields();
-    genFile << (fields.size() > 0 ? "true" : "false") << ";\n";
+  const auto &tmps = record->GetTemplates();
+  for (auto &args : GetSpecializationArgs(record)) {
+    auto name = GetSpecializationName(record, args);
+    std::vector<std::string> specBases;
+    for (auto &base : bases)
+      specBases.push_back(SubstituteTemplateParams(base, tmps, args));
+    WriteReflData(record, "template<>", name, specBases, genFile);
+    if (!record->GetMethods().empty())
+      WriteMethodData(record, "template<>", name, args, genFile);
+    WriteRegistration(record, name, genFile);
+  }
+}
 
-    genFile << "    constexpr static bool hasBases = ";
-    auto &bases = record->GetBases();
-    genFile << (bases.size() > 0 ? "true" : "false") << ";\n";
+// One inline variable per record, so each module registers the record once
+// however many of its TUs include the generated file. It is named by the type
+// ID, which is unique in the project.
+void Generator::WriteRegistration(const CxxRecord *record,
+                                  const std::string &name,
+                                  std::ostream &genFile) {
+  if (!m_options.emitRegistry)
+    return;
+
+  std::vector<const Field *> fields;
+  for (auto &field : record->GetFields()) {
+    if (!field->isStatic)
+      fields.push_back(field.get());
+  }
+
+  char idStr[24];
+  std::snprintf(idStr, sizeof(idStr), "%016" PRIx64, GetTypeId(name));
+  genFile << "namespace RegistryDetail {\n";
+  genFile << "inline const Registration registration_" << idStr << " {\n";
+  genFile << "    RecordInfo { ReflData<" << name << ">::typeId, \"" << name
+          << "\", sizeof(" << name << "), alignof(" << name << ") },\n";
+  genFile << "    {";
+  for (size_t i = 0; i < fields.size(); ++i) {
+    genFile << (i > 0 ? ",\n" : "\n") << "        FieldOf(\""
+            << fields[i]->name << "\", &" << name << "::" << fields[i]->name
+            << ")";
+  }
+  genFile << (fields.empty() ? "}\n" : "\n    }\n");
+  genFile << "};\n";
+  genFile << "} // namespace RegistryDetail\n";
+}
 
-    if (bases.size() > 0) {
-      genFile << "    constexpr static auto bases = ReflDataArray {\n";
-      for (size_t i = 0; i < bases.size() - 1; ++i) {
-        genFile << "        ReflData<" << bases[i] << "> {},\n";
+void Generator::WriteReflData(const CxxRecord *record,
+                              const std::string &tmpDecl,
+                              const std::string &name,
+                              const std::vector<std::string> &bases,
+                              std::ostream &genFile) {
+  genFile << tmpDecl << "\n";
+  genFile << "struct ReflData<" << name << ">\n";
+  genFile << "{\n";
+
+  genFile << "    constexpr static bool hasData = ";
+  auto &fields = record->GetFields();
+  genFile << (fields.size() > 0 ? "true" : "false") << ";\n";
+
+  genFile << "    constexpr static bool hasBases = ";
+  genFile << (bases.size() > 0 ? "true" : "false") << ";\n";
+
+  // class templates only have an ID for the concrete arguments of a full
+  // specialization
+  uint64_t typeId = 0;
+  if (record->GetTemplates().empty() || tmpDecl == "template<>")
+    typeId = GetTypeId(name);
+  char typeIdStr[32];
+  std::snprintf(typeIdStr, sizeof(typeIdStr), "0x%016" PRIx64 "ull", typeId);
+  genFile << "    constexpr static uint64_t typeId = " << typeIdStr << ";\n";
+
+  if (bases.size() > 0) {
+    genFile << "    constexpr static auto bases = ReflDataArray {\n";
+    for (size_t i = 0; i < bases.size() - 1; ++i) {
+      genFile << "        ReflData<" << bases[i] << "> {},\n";
+    }
+    genFile << "        ReflData<" << bases.back() << "> {}\n";
+    genFile << "    };\n";
+  }
+
+  if (fields.size() > 0) {
+    // With pooled names, the fields and attributes are named by their index
+    // in one character table instead of a Name<"..."> instantiation each.
+    std::map<std::string, size_t> pool;
+    std::vector<std::string> poolNames;
+    auto addName = [&](const std::string &poolName) {
+      if (pool.emplace(poolName, poolNames.size()).second)
+        poolNames.push_back(poolName);
+    };
+    auto nameExpr = [&](const std::string &poolName) {
+      if (!m_options.pooledNames)
+        return "Name<\"" + poolName + "\">{}";
+      return "PooledName<" + name + ">{" + std::to_string(pool[poolName]) +
+             "}";
+    };
+    if (m_options.pooledNames) {
+      for (auto &field : fields) {
+        addName(field->name);
+        for (auto &attr : field->attrs)
+          addName(attr->GetName());
+      }
+      // adjacent literals, so a name starting with a digit does not extend
+      // the \0 escape
+      genFile << "    constexpr static char nameChars[] =";
+      for (auto &poolName : poolNames)
+        genFile << " \"" << poolName << "\\0\"";
+      genFile << ";\n";
+      genFile << "    constexpr static uint32_t nameOffsets[] = {0";
+      size_t offset = 0;
+      for (auto &poolName : poolNames) {
+        offset += poolName.size() + 1;
+        genFile << ", " << offset;
       }
-      genFile << "        ReflData<" << bases.back() << "> {}\n";
-      genFile << "    };\n";
+      genFile << "};\n";
+      genFile << "    constexpr static NameTable names {nameChars, "
+              << "nameOffsets, " << poolNames.size() << "};\n";
     }
 
-    if (fields.size() > 0) {
-      genFile << "    constexpr static auto fields = FieldArray {\n";
+    genFile << "    constexpr static auto fields = FieldArray {\n";
 
-      auto writeField = [&genFile, &name](const Field *field) {
-        genFile << "        Field { Name<\"" << field->name << "\">{}, "
-                << "&" << name << "::" << field->name << ",";
-        if (field->attrs.size() > 2) {
-          genFile << "\n            AttrArray{\n";
-          for (size_t i = 0; i < field->attrs.size() - 1; ++i) {
-            genFile << "                ";
-            field->attrs[i]->Write(genFile);
-            genFile << ",\n";
-          }
+    auto writeField = [&](const Field *field) {
+      genFile << "        Field { " << nameExpr(field->name) << ", "
+              << "&" << name << "::" << field->name << ",";
+      if (field->attrs.size() > 2) {
+        genFile << "\n            AttrArray{\n";
+        for (size_t i = 0; i < field->attrs.size() - 1; ++i) {
           genFile << "                ";
-          field->attrs.back()->Write(genFile);
-          genFile << "\n            }\n        }";
-        } else {
-          genFile << " AttrArray {";
-          if (field->attrs.size() > 0) {
-            for (size_t i = 0; i < field->attrs.size() - 1; ++i) {
-              field->attrs[i]->Write(genFile);
-              genFile << ", ";
-            }
-            field->attrs.back()->Write(genFile);
+          field->attrs[i]->Write(genFile, nameExpr(field->attrs[i]->GetName()));
+          genFile << ",\n";
+        }
+        genFile << "                ";
+        field->attrs.back()->Write(genFile,
+                                   nameExpr(field->attrs.back()->GetName()));
+        genFile << "\n            }\n        }";
+      } else {
+        genFile << " AttrArray {";
+        if (field->attrs.size() > 0) {
+          for (size_t i = 0; i < field->attrs.size() - 1; ++i) {
+            field->attrs[i]->Write(genFile,
+                                   nameExpr(field->attrs[i]->GetName()));
+            genFile << ", ";
           }
-          genFile << "} }";
+          field->attrs.back()->Write(genFile,
+                                     nameExpr(field->attrs.back()->GetName()));
         }
-      };
-      for (size_t i = 0; i < fields.size() - 1; ++i) {
-        writeField(fields[i].get());
-        genFile << ",\n";
+        genFile << "} }";
       }
-      writeField(fields.back().get());
-      genFile << "\n    };\n";
+    };
+    for (size_t i = 0; i < fields.size() - 1; ++i) {
+      writeField(fields[i].get());
+      genFile << ",\n";
     }
-    genFile << "};\n";
+    writeField(fields.back().get());
+    genFile << "\n    };\n";
   }
-
-  genFile << "}\n";
-  genFile << "#endif\n";
-  genFile.close();
+  genFile << "};\n";
 }
 
 void Generator::AddIncludePathToTarget() {
@@ -166,4 +1390,64 @@ void Generator::AddIncludePathToTarget() {
          << std::endl;
     file.close();
   }
-}
\ No newline at end of file
+}
+void Generator::WriteUmbrella(
+    const std::filesystem::path &umbrella,
+    std::vector<std::filesystem::path> generatedFiles) {
+  auto umbrellaDir = std::filesystem::absolute(umbrella).parent_path();
+  std::filesystem::create_directories(umbrellaDir);
+
+  std::vector<std::string> includes;
+  includes.reserve(generatedFiles.size());
+  for (auto &file : generatedFiles) {
+    auto path = std::filesystem::absolute(file).lexically_normal();
+    auto relative = path.lexically_relative(umbrellaDir);
+    includes.push_back(relative.empty() ? path.generic_string()
+                                        : relative.generic_string());
+  }
+  // Keep the files of the earlier invocations, so running the tool once per
+  // header (e.g. one custom command per file) still gives a complete umbrella.
+  // The files which have been removed since are dropped.
+  std::string old;
+  {
+    std::ifstream file(umbrella, std::ios::in | std::ios::binary);
+    if (file.is_open()) {
+      std::ostringstream buffer;
+      buffer << file.rdbuf();
+      old = buffer.str();
+    }
+  }
+  {
+    std::istringstream lines(old);
+    const std::string prefix = "#include \"";
+    for (std::string line; std::getline(lines, line);) {
+      if (line.rfind(prefix, 0) != 0 || line.size() <= prefix.size() ||
+          line.back() != '"')
+        continue;
+      auto inc = line.substr(prefix.size(), line.size() - prefix.size() - 1);
+      std::filesystem::path path{inc};
+      if (std::filesystem::exists(path.is_absolute() ? path
+                                                     : umbrellaDir / path))
+        includes.push_back(inc);
+    }
+  }
+  // keep the content independent of the input order
+  std::sort(includes.begin(), includes.end());
+  includes.erase(std::unique(includes.begin(), includes.end()), includes.end());
+
+  std::ostringstream content;
+  content << "//===================================================\n";
+  content << "// Automatically generated by Pupil Reflection Tool\n";
+  content << "//===================================================\n\n";
+  content << "#pragma once\n";
+  for (auto &inc : includes)
+    content << "#include \"" << inc << "\"\n";
+
+  if (old == content.str())
+    return;
+
+  std::ofstream file(umbrella,
+                     std::ios::out | std::ios::trunc | std::ios::binary);
+  file << content.str();
+  file.close();
+}
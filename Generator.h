@@ -1,31 +1,158 @@
 #pragma once
 
+#include "CxxEnum.h"
 #include "CxxRecord.h"
+#include "Options.h"
+#include "ProjectIndex.h"
 #include <filesystem>
+#include <map>
+#include <mutex>
 
 namespace PReflTool {
 class Generator {
 private:
   std::filesystem::path m_targetFile;
   std::filesystem::path m_resultDir;
+  const Options &m_options;
+  const ProjectIndex *m_index = nullptr;
   std::vector<std::unique_ptr<CxxRecord>> m_records;
+  std::vector<std::unique_ptr<CxxEnum>> m_enums;
+  // user headers included by the target file
+  std::vector<std::string> m_dependencies;
+  // memory used by the clang parse of the target file
+  size_t m_parseMemory = 0;
+  // errors of the clang parse, the records of a failed parse are incomplete
+  std::vector<std::string> m_parseErrors;
+  // messages of the last Generate, records are written on several threads
+  std::vector<std::string> m_errors;
+  std::vector<std::string> m_warnings;
+  std::mutex m_errorMutex;
 
   void AddIncludePathToTarget();
+  void AddError(std::string message);
+  void AddWarning(std::string message);
+  void WriteEnum(const CxxEnum *cxxEnum, std::ostream &out);
+  void WriteRecord(const CxxRecord *record, std::ostream &out);
+  void WriteReflData(const CxxRecord *record, const std::string &tmpDecl,
+                     const std::string &name,
+                     const std::vector<std::string> &bases, std::ostream &out);
+  void WriteKernels(const CxxRecord *record, const std::string &tmpDecl,
+                    std::ostream &out);
+  void WriteSoA(const CxxRecord *record, const std::string &tmpDecl,
+                std::ostream &out);
+  void WriteSoAAlias(const CxxRecord *record, std::ostream &out);
+  void WriteHash(const CxxRecord *record, const std::string &tmpDecl,
+                 std::ostream &out);
+  void WriteJson(const CxxRecord *record, const std::string &tmpDecl,
+                 std::ostream &out);
+  void WriteGpuBlock(const CxxRecord *record, std::ostream &out);
+  void WriteRegistration(const CxxRecord *record, const std::string &name,
+                         std::ostream &out);
+  void WriteMethodData(const CxxRecord *record, const std::string &tmpDecl,
+                       const std::string &name,
+                       const std::vector<std::string> &args, std::ostream &out);
+  std::vector<std::vector<std::string>>
+  GetSpecializationArgs(const CxxRecord *record) const;
+  static std::string
+  GetSpecializationName(const CxxRecord *record,
+                        const std::vector<std::string> &args);
 
 public:
-  Generator(std::string file);
+  Generator(std::string file, const Options &options);
   ~Generator() = default;
 	
   void PushCxxRecord(std::unique_ptr<CxxRecord> &record) {
     m_records.emplace_back(std::move(record));
   }
+  void PushCxxEnum(std::unique_ptr<CxxEnum> &cxxEnum) {
+    m_enums.emplace_back(std::move(cxxEnum));
+  }
 
   // If generated file exsits, compare the modification time of generated file
   // and traget file. When the modification time of the generated file is later,
   // the target file does not need to generate a new file.
   bool CheckModifyTime();
 
+  // With an index, only bases which are reflected somewhere in the project
+  // are referenced by the generated code.
+  void SetProjectIndex(const ProjectIndex *index) { m_index = index; }
+
+  const std::vector<std::unique_ptr<CxxRecord>> &GetRecords() const {
+    return m_records;
+  }
+  const std::vector<std::unique_ptr<CxxEnum>> &GetEnums() const {
+    return m_enums;
+  }
+  // Hand the records over once the generator is done with them.
+  std::vector<std::unique_ptr<CxxRecord>> ReleaseRecords() {
+    return std::move(m_records);
+  }
+  std::vector<std::unique_ptr<CxxEnum>> ReleaseEnums() {
+    return std::move(m_enums);
+  }
+
+  // Qualified names of the generated ReflData which have a type ID: records
+  // which are not templates and the full specializations.
+  std::vector<std::string> GetTypeNames() const;
+  // ReflData<T>::typeId of the record named `name`, see PRefl::TypeIdOf.
+  static uint64_t GetTypeId(const std::string &name);
+
+  void AddParseError(std::string message) {
+    m_parseErrors.push_back(std::move(message));
+  }
+  const std::vector<std::string> &GetParseErrors() const {
+    return m_parseErrors;
+  }
+
+  void SetParseMemory(size_t bytes) { m_parseMemory = bytes; }
+  size_t GetParseMemory() const { return m_parseMemory; }
+
+  void AddDependency(const std::filesystem::path &file);
+  const std::vector<std::string> &GetDependencies() const {
+    return m_dependencies;
+  }
+
+  // The extracted records are cached next to the generated file. Loading
+  // fails when the target file or one of its dependencies has been modified
+  // since the cache was written, or when `config` (the hash of the options
+  // which change the extraction) differs.
+  bool LoadIRCache(uint64_t config);
+  bool SaveIRCache(uint64_t config);
+
+  // Write the generated file (and the schema), appending the include to the
+  // target file when needed.
   void Generate();
+  // Only write the generated code to `out`.
+  void Generate(std::ostream &out);
+  // The outputs which could not be generated by the last Generate, such as
+  // the hash index of two fields whose names have the same hash. The rest of
+  // the file is generated without them.
+  const std::vector<std::string> &GetErrors() const { return m_errors; }
+  // Parts of the output which were skipped as expected, such as the GPU block
+  // of a record with fields which have no place in it.
+  const std::vector<std::string> &GetWarnings() const { return m_warnings; }
   std::filesystem::path GetGeneratedFilePath();
+  std::filesystem::path GetIRCacheFilePath();
+  std::filesystem::path GetSchemaFilePath();
+  std::filesystem::path GetTargetFilePath() const { return m_targetFile; }
+
+  // Replace the template parameters in `text` (e.g. a base "Base<T>") by the
+  // arguments of a concrete specialization.
+  static std::string
+  SubstituteTemplateParams(const std::string &text,
+                           const std::vector<std::string> &params,
+                           const std::vector<std::string> &args);
+
+  // Read the concrete specializations to generate, one per line:
+  //   TestCase8Nsp::TestCase8<int, float>
+  static bool LoadSpecializations(
+      const std::filesystem::path &file,
+      std::map<std::string, std::vector<std::vector<std::string>>> &specs);
+
+  // Write the header which includes all generated files: `generatedFiles`
+  // and the ones already listed by the umbrella which still exist. The file
+  // is only rewritten when this list changes.
+  static void WriteUmbrella(const std::filesystem::path &umbrella,
+                            std::vector<std::filesystem::path> generatedFiles);
 };
 } // namespace PReflTool
@@ -0,0 +1,419 @@
+#include "IRCache.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace PReflTool;
+
+namespace {
+const char s_magic[4] = {'P', 'R', 'I', 'R'};
+
+struct SourceStamp {
+  uint64_t size = 0;
+  int64_t time = 0;
+};
+
+bool GetSourceStamp(const std::filesystem::path &source, SourceStamp &stamp) {
+  std::error_code ec;
+  stamp.size = std::filesystem::file_size(source, ec);
+  if (ec)
+    return false;
+  auto time = std::filesystem::last_write_time(source, ec);
+  if (ec)
+    return false;
+  stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+  return true;
+}
+
+class BinaryWriter {
+  std::string m_buffer;
+
+public:
+  template <typename T> void Write(T value) {
+    m_buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+  void Write(const std::string &str) {
+    Write(static_cast<uint32_t>(str.size()));
+    m_buffer.append(str);
+  }
+  void Write(const std::vector<std::string> &strs) {
+    Write(static_cast<uint32_t>(strs.size()));
+    for (auto &str : strs)
+      Write(str);
+  }
+  void Write(const std::vector<std::vector<std::string>> &lists) {
+    Write(static_cast<uint32_t>(lists.size()));
+    for (auto &strs : lists)
+      Write(strs);
+  }
+
+  const std::string &GetBuffer() const { return m_buffer; }
+};
+
+class BinaryReader {
+  const char *m_cur;
+  const char *m_end;
+  bool m_ok = true;
+
+public:
+  BinaryReader(const std::string &buffer)
+      : m_cur(buffer.data()), m_end(buffer.data() + buffer.size()) {}
+
+  bool IsOk() const { return m_ok; }
+  void Fail() { m_ok = false; }
+
+  template <typename T> T Read() {
+    T value{};
+    if (static_cast<size_t>(m_end - m_cur) < sizeof(T)) {
+      m_ok = false;
+      return value;
+    }
+    std::memcpy(&value, m_cur, sizeof(T));
+    m_cur += sizeof(T);
+    return value;
+  }
+  // A count of elements which take at least `elementSize` bytes each. A
+  // corrupt count fails the read instead of allocating.
+  uint32_t ReadCount(size_t elementSize) {
+    auto cnt = Read<uint32_t>();
+    if (!m_ok || static_cast<size_t>(m_end - m_cur) / elementSize < cnt) {
+      m_ok = false;
+      return 0;
+    }
+    return cnt;
+  }
+  std::string ReadString() {
+    auto size = Read<uint32_t>();
+    if (!m_ok || static_cast<size_t>(m_end - m_cur) < size) {
+      m_ok = false;
+      return {};
+    }
+    std::string str{m_cur, size};
+    m_cur += size;
+    return str;
+  }
+  std::vector<std::string> ReadStrings() {
+    auto cnt = ReadCount(sizeof(uint32_t));
+    std::vector<std::string> strs;
+    for (uint32_t i = 0; i < cnt && m_ok; ++i)
+      strs.push_back(ReadString());
+    return strs;
+  }
+};
+
+void WriteAttr(BinaryWriter &writer, Attr *attr) {
+  auto name = attr->GetName();
+  writer.Write(name);
+  if (name.compare(InfoAnnotate::name) == 0) {
+    writer.Write(static_cast<InfoAnnotate *>(attr)->info);
+  } else if (name.compare(RangeAnnotate::name) == 0) {
+    auto *range = static_cast<RangeAnnotate *>(attr);
+    writer.Write(static_cast<int32_t>(range->cnt));
+    writer.Write(range->vmin);
+    writer.Write(range->vmax);
+  } else if (name.compare(StepAnnotate::name) == 0) {
+    writer.Write(static_cast<StepAnnotate *>(attr)->step);
+  }
+}
+
+void WriteGpuType(BinaryWriter &writer, const GpuType &type) {
+  writer.Write(static_cast<uint8_t>(type.kind));
+  writer.Write(static_cast<uint8_t>(type.scalar));
+  writer.Write(type.rows);
+  writer.Write(type.columns);
+  writer.Write(type.count);
+  writer.Write(type.cpuSize);
+  writer.Write(static_cast<uint32_t>(type.members.size()));
+  for (auto &member : type.members) {
+    writer.Write(member.name);
+    writer.Write(member.cpuOffset);
+    WriteGpuType(writer, member.type);
+  }
+}
+
+// Structs nest as deep as the records of the sources, a deeper type can
+// only come from a corrupt file.
+const unsigned s_maxGpuTypeDepth = 64;
+
+void ReadGpuType(BinaryReader &reader, GpuType &type, unsigned depth = 0) {
+  if (depth > s_maxGpuTypeDepth) {
+    reader.Fail();
+    return;
+  }
+  type.kind = static_cast<GpuType::EKind>(reader.Read<uint8_t>());
+  type.scalar = static_cast<GpuType::EScalar>(reader.Read<uint8_t>());
+  type.rows = reader.Read<uint32_t>();
+  type.columns = reader.Read<uint32_t>();
+  type.count = reader.Read<uint32_t>();
+  type.cpuSize = reader.Read<uint64_t>();
+  auto memberCnt = reader.ReadCount(sizeof(uint32_t));
+  for (uint32_t i = 0; i < memberCnt && reader.IsOk(); ++i) {
+    auto &member = type.members.emplace_back();
+    member.name = reader.ReadString();
+    member.cpuOffset = reader.Read<uint64_t>();
+    ReadGpuType(reader, member.type, depth + 1);
+  }
+}
+
+std::unique_ptr<Attr> ReadAttr(BinaryReader &reader) {
+  auto name = reader.ReadString();
+  if (name.compare(MetaAnnotate::name) == 0) {
+    return std::make_unique<MetaAnnotate>();
+  } else if (name.compare(InfoAnnotate::name) == 0) {
+    auto pInfo = std::make_unique<InfoAnnotate>();
+    pInfo->info = reader.ReadString();
+    return pInfo;
+  } else if (name.compare(RangeAnnotate::name) == 0) {
+    auto pRange = std::make_unique<RangeAnnotate>();
+    pRange->cnt = reader.Read<int32_t>();
+    pRange->vmin = reader.Read<double>();
+    pRange->vmax = reader.Read<double>();
+    return pRange;
+  } else if (name.compare(StepAnnotate::name) == 0) {
+    auto pStep = std::make_unique<StepAnnotate>();
+    pStep->step = reader.Read<double>();
+    return pStep;
+  }
+  return nullptr;
+}
+} // namespace
+
+bool IRCache::Write(const std::filesystem::path &cacheFile,
+                    const std::filesystem::path &source, uint64_t config,
+                    const std::vector<std::unique_ptr<CxxRecord>> &records,
+                    const std::vector<std::unique_ptr<CxxEnum>> &enums,
+                    const std::vector<std::string> &dependencies) {
+  SourceStamp stamp;
+  if (!GetSourceStamp(source, stamp))
+    return false;
+
+  // headers which are not on the disk (e.g. stubs) can not change
+  std::vector<std::pair<std::string, SourceStamp>> depStamps;
+  for (auto &dep : dependencies) {
+    SourceStamp depStamp;
+    if (GetSourceStamp(dep, depStamp))
+      depStamps.emplace_back(dep, depStamp);
+  }
+
+  BinaryWriter writer;
+  for (char c : s_magic)
+    writer.Write(c);
+  writer.Write(s_version);
+  writer.Write(config);
+  writer.Write(stamp.size);
+  writer.Write(stamp.time);
+
+  writer.Write(static_cast<uint32_t>(depStamps.size()));
+  for (auto &[dep, depStamp] : depStamps) {
+    writer.Write(dep);
+    writer.Write(depStamp.size);
+    writer.Write(depStamp.time);
+  }
+
+  writer.Write(static_cast<uint32_t>(records.size()));
+  for (auto &record : records) {
+    writer.Write(record->GetName());
+    writer.Write(record->GetNamespaces());
+    writer.Write(record->GetTemplates());
+    writer.Write(record->GetTemplateDecls());
+    writer.Write(record->GetSpecializations());
+    writer.Write(record->GetBases());
+    writer.Write(record->GetBaseUSRs());
+    writer.Write(record->GetUSR());
+    writer.Write(static_cast<uint8_t>(record->IsNeedGenerate()));
+    writer.Write(static_cast<uint8_t>(record->GetType()));
+    writer.Write(static_cast<uint8_t>(record->IsGenerateSoA()));
+    writer.Write(static_cast<uint8_t>(record->IsNested()));
+
+    auto &fields = record->GetFields();
+    writer.Write(static_cast<uint32_t>(fields.size()));
+    for (auto &field : fields) {
+      writer.Write(field->name);
+      writer.Write(static_cast<uint8_t>(field->isStatic));
+      writer.Write(field->offset);
+      writer.Write(field->size);
+      writer.Write(static_cast<uint8_t>(field->isPlainBytes));
+      WriteGpuType(writer, field->gpu);
+      writer.Write(static_cast<uint32_t>(field->attrs.size()));
+      for (auto &attr : field->attrs)
+        WriteAttr(writer, attr.get());
+    }
+
+    auto &methods = record->GetMethods();
+    writer.Write(static_cast<uint32_t>(methods.size()));
+    for (auto &method : methods) {
+      writer.Write(method.name);
+      writer.Write(method.returnType);
+      writer.Write(static_cast<uint8_t>(method.isConst));
+      writer.Write(static_cast<uint8_t>(method.isStatic));
+      writer.Write(static_cast<uint32_t>(method.params.size()));
+      for (auto &param : method.params) {
+        writer.Write(param.type);
+        writer.Write(param.name);
+      }
+    }
+  }
+
+  writer.Write(static_cast<uint32_t>(enums.size()));
+  for (auto &cxxEnum : enums) {
+    writer.Write(cxxEnum->GetName());
+    writer.Write(cxxEnum->GetNamespaces());
+    writer.Write(cxxEnum->GetUSR());
+    writer.Write(static_cast<uint8_t>(cxxEnum->IsSigned()));
+    auto &enumerators = cxxEnum->GetEnumerators();
+    writer.Write(static_cast<uint32_t>(enumerators.size()));
+    for (auto &enumerator : enumerators) {
+      writer.Write(enumerator.name);
+      writer.Write(enumerator.value);
+    }
+  }
+
+  std::ofstream file(cacheFile,
+                     std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file.is_open())
+    return false;
+  file << writer.GetBuffer();
+  return file.good();
+}
+
+bool IRCache::Read(const std::filesystem::path &cacheFile,
+                   const std::filesystem::path &source, uint64_t config,
+                   std::vector<std::unique_ptr<CxxRecord>> &records,
+                   std::vector<std::unique_ptr<CxxEnum>> &enums,
+                   std::vector<std::string> &dependencies) {
+  SourceStamp stamp;
+  if (!GetSourceStamp(source, stamp))
+    return false;
+
+  std::string buffer;
+  {
+    std::ifstream file(cacheFile, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+      return false;
+    buffer.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+  }
+
+  BinaryReader reader{buffer};
+  for (char c : s_magic) {
+    if (reader.Read<char>() != c)
+      return false;
+  }
+  if (reader.Read<uint32_t>() != s_version ||
+      reader.Read<uint64_t>() != config ||
+      reader.Read<uint64_t>() != stamp.size ||
+      reader.Read<int64_t>() != stamp.time)
+    return false;
+
+  std::vector<std::string> deps;
+  auto depCnt = reader.ReadCount(sizeof(uint32_t));
+  for (uint32_t i = 0; i < depCnt && reader.IsOk(); ++i) {
+    auto dep = reader.ReadString();
+    SourceStamp depStamp;
+    if (!GetSourceStamp(dep, depStamp) ||
+        reader.Read<uint64_t>() != depStamp.size ||
+        reader.Read<int64_t>() != depStamp.time)
+      return false;
+    deps.push_back(std::move(dep));
+  }
+
+  std::vector<std::unique_ptr<CxxRecord>> result;
+  auto recordCnt = reader.ReadCount(sizeof(uint32_t));
+  for (uint32_t i = 0; i < recordCnt && reader.IsOk(); ++i) {
+    auto name = reader.ReadString();
+    auto nsps = reader.ReadStrings();
+    auto tmps = reader.ReadStrings();
+    auto tmpDecls = reader.ReadStrings();
+    std::vector<std::vector<std::string>> specs(
+        reader.ReadCount(sizeof(uint32_t)));
+    for (auto &spec : specs) {
+      if (!reader.IsOk())
+        return false;
+      spec = reader.ReadStrings();
+    }
+    auto bases = reader.ReadStrings();
+    auto baseUSRs = reader.ReadStrings();
+    auto usr = reader.ReadString();
+    bool hasMetaFlag = reader.Read<uint8_t>() != 0;
+    auto type = static_cast<ECxxRecordType>(reader.Read<uint8_t>());
+    bool generateSoA = reader.Read<uint8_t>() != 0;
+    bool isNested = reader.Read<uint8_t>() != 0;
+
+    auto record =
+        std::make_unique<CxxRecord>(name, nsps, tmps, hasMetaFlag, type);
+    if (baseUSRs.size() != bases.size())
+      return false;
+    for (size_t j = 0; j < bases.size(); ++j)
+      record->AddBase(bases[j], baseUSRs[j]);
+    record->SetUSR(usr);
+    record->SetGenerateSoA(generateSoA);
+    record->SetNested(isNested);
+    record->SetTemplateDecls(tmpDecls);
+    for (auto &spec : specs)
+      record->AddSpecialization(spec);
+
+    auto fieldCnt = reader.ReadCount(sizeof(uint32_t));
+    for (uint32_t j = 0; j < fieldCnt && reader.IsOk(); ++j) {
+      auto field = std::make_unique<Field>();
+      field->name = reader.ReadString();
+      field->isStatic = reader.Read<uint8_t>() != 0;
+      field->offset = reader.Read<uint64_t>();
+      field->size = reader.Read<uint64_t>();
+      field->isPlainBytes = reader.Read<uint8_t>() != 0;
+      ReadGpuType(reader, field->gpu);
+      auto attrCnt = reader.ReadCount(sizeof(uint32_t));
+      for (uint32_t k = 0; k < attrCnt && reader.IsOk(); ++k) {
+        auto attr = ReadAttr(reader);
+        if (!attr)
+          return false;
+        field->attrs.emplace_back(std::move(attr));
+      }
+      record->PushField(field);
+    }
+
+    auto methodCnt = reader.ReadCount(sizeof(uint32_t));
+    for (uint32_t j = 0; j < methodCnt && reader.IsOk(); ++j) {
+      Method method;
+      method.name = reader.ReadString();
+      method.returnType = reader.ReadString();
+      method.isConst = reader.Read<uint8_t>() != 0;
+      method.isStatic = reader.Read<uint8_t>() != 0;
+      auto paramCnt = reader.ReadCount(2 * sizeof(uint32_t));
+      for (uint32_t k = 0; k < paramCnt && reader.IsOk(); ++k) {
+        MethodParam param;
+        param.type = reader.ReadString();
+        param.name = reader.ReadString();
+        method.params.push_back(std::move(param));
+      }
+      record->PushMethod(std::move(method));
+    }
+    result.emplace_back(std::move(record));
+  }
+
+  std::vector<std::unique_ptr<CxxEnum>> enumResult;
+  auto enumCnt = reader.ReadCount(sizeof(uint32_t));
+  for (uint32_t i = 0; i < enumCnt && reader.IsOk(); ++i) {
+    auto name = reader.ReadString();
+    auto nsps = reader.ReadStrings();
+    auto usr = reader.ReadString();
+    bool isSigned = reader.Read<uint8_t>() != 0;
+
+    auto cxxEnum = std::make_unique<CxxEnum>(name, nsps, isSigned);
+    cxxEnum->SetUSR(usr);
+    auto enumeratorCnt =
+        reader.ReadCount(sizeof(uint32_t) + sizeof(uint64_t));
+    for (uint32_t j = 0; j < enumeratorCnt && reader.IsOk(); ++j) {
+      auto enumeratorName = reader.ReadString();
+      cxxEnum->PushEnumerator(enumeratorName, reader.Read<uint64_t>());
+    }
+    enumResult.emplace_back(std::move(cxxEnum));
+  }
+
+  if (!reader.IsOk())
+    return false;
+
+  records = std::move(result);
+  enums = std::move(enumResult);
+  dependencies = std::move(deps);
+  return true;
+}
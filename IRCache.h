@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CxxEnum.h"
+#include "CxxRecord.h"
+
+#include <cstdint>
+#include <filesystem>
+
+namespace PReflTool {
+
+// Binary cache of the records extracted from one target file, so that the
+// outputs can be regenerated without parsing the file with clang again.
+//
+// Layout (native endianness, the cache is not meant to be shared between
+// machines):
+//   magic "PRIR", version, extraction config, source file size, source
+//   modification time,
+//   dependency count, dependencies (path, size, modification time),
+//   record count, records..., enum count, enums...
+// The cache is stale as soon as the source or one of the user headers it
+// includes has been modified, or when it was extracted with another config
+// (compiler arguments, stub headers), see Tool.
+// Strings are stored as length + bytes, arrays as count + elements.
+class IRCache {
+public:
+  // Increase when the layout or the meaning of the IR changes.
+  constexpr static uint32_t s_version = 13;
+
+  static bool Write(const std::filesystem::path &cacheFile,
+                    const std::filesystem::path &source, uint64_t config,
+                    const std::vector<std::unique_ptr<CxxRecord>> &records,
+                    const std::vector<std::unique_ptr<CxxEnum>> &enums,
+                    const std::vector<std::string> &dependencies);
+
+  // Return false if the cache does not exist, has another version or was
+  // written for another config or state of the source file or its
+  // dependencies.
+  static bool Read(const std::filesystem::path &cacheFile,
+                   const std::filesystem::path &source, uint64_t config,
+                   std::vector<std::unique_ptr<CxxRecord>> &records,
+                   std::vector<std::unique_ptr<CxxEnum>> &enums,
+                   std::vector<std::string> &dependencies);
+};
+} // namespace PReflTool
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+struct Options {
+  // Append '#include "generated/xxx.gen.inl"' to the target header when it is
+  // missing. When disabled the tool never writes user sources, the generated
+  // files include their target header themselves and are reached through the
+  // umbrella header instead.
+  bool modifySource = true;
+  // One header which includes every generated file, usable as forced include.
+  std::filesystem::path umbrella;
+  // Write one umbrella named umbrella.filename() per directory of generated
+  // files instead, which only includes the files of that directory.
+  bool umbrellaPerDir = false;
+  // Also write the records as binary schema (generated/xxx.refl.bin) for
+  // external tools, see schema/PReflSchema.h.
+  bool emitSchema = false;
+  // Regenerate outputs even if they are newer than the target file.
+  bool force = false;
+  // Store the extracted records and reuse them while the target file is
+  // unchanged, so regenerating does not need clang.
+  bool useIRCache = true;
+  // Concrete template arguments to generate full ReflData specializations
+  // for, keyed by the qualified template name, see --specializations.
+  std::map<std::string, std::vector<std::vector<std::string>>> specializations;
+  // Number of worker threads, used by --scan, the parses and to format large
+  // outputs. 0 is resolved to the number of hardware threads, except for the
+  // parses which then run one at a time without a memory budget.
+  unsigned jobs = 0;
+  // Print the parse and generation time of each file.
+  bool stats = false;
+  // Number of target headers parsed together in one translation unit, so
+  // the headers they share are only parsed once per batch. 0 and 1 parse
+  // each header on its own.
+  unsigned unityBatch = 1;
+  // Register the records with a type ID in the runtime registry during
+  // static initialization, see runtime/PReflRegistry.h.
+  bool emitRegistry = false;
+  // JSON writer and reader for each record, see runtime/PReflJson.h.
+  bool emitJson = false;
+  // Hasher for each record with non-static fields, see runtime/PReflHash.h.
+  bool emitHash = false;
+  // ClampToRange and SnapToStep for the records with RANGE or STEP fields,
+  // see runtime/PReflKernels.h.
+  bool emitKernels = false;
+  // Name the fields and attributes of each record by their index in one
+  // character table (PooledName) instead of one Name<"..."> instantiation
+  // each, see runtime/PReflNames.h.
+  bool pooledNames = false;
+  // GPU buffer layout of the blocks generated for each record (GpuBlock<T>
+  // and PackTo), see runtime/PReflGpu.h. None generates no block.
+  enum class EGpuLayout { None, Std140, Std430 };
+  EGpuLayout gpuLayout = EGpuLayout::None;
+  // Part of a sharded run (--shard): only extract the records into the IR
+  // caches. The outputs depend on the records of every shard and are written
+  // by --merge.
+  bool extractOnly = false;
+  // Generate the outputs of a sharded run (--merge) from the IR caches left
+  // by the shards. Headers which no shard extracted are parsed.
+  bool merge = false;
+  // Write the generated files, IR caches and schemas, and append the include
+  // to the target headers. Without it every header is extracted (from its IR
+  // cache when valid) and generated in memory, see PReflTool::Tool.
+  bool writeOutputs = true;
+};
+} // namespace PReflTool
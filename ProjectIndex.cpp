@@ -0,0 +1,155 @@
+#include "ProjectIndex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace PReflTool;
+
+namespace {
+// TestCase8Nsp::TestCase8<T1, T2> -> TestCase8
+std::string GetPlainName(const std::string &name) {
+  auto end = name.find('<');
+  auto plain = name.substr(0, end);
+  auto pos = plain.rfind("::");
+  return pos == std::string::npos ? plain : plain.substr(pos + 2);
+}
+} // namespace
+
+std::string ProjectIndex::NormalizePath(const std::filesystem::path &file) {
+  std::error_code ec;
+  auto path = std::filesystem::weakly_canonical(file, ec);
+  if (ec)
+    path = std::filesystem::absolute(file).lexically_normal();
+  return path.generic_string();
+}
+
+void ProjectIndex::AddNames(const std::string &usr, const std::string &name) {
+  m_names.emplace(name, usr);
+  auto plain = GetPlainName(name);
+  if (plain != name)
+    m_names.emplace(plain, usr);
+}
+
+void ProjectIndex::RemoveNames(const std::string &usr,
+                               const std::string &name) {
+  for (const auto &key : {name, GetPlainName(name)}) {
+    auto [begin, end] = m_names.equal_range(key);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second == usr) {
+        m_names.erase(it);
+        break;
+      }
+    }
+  }
+}
+
+bool ProjectIndex::Load(const std::filesystem::path &file) {
+  std::ifstream in(file);
+  if (!in.is_open())
+    return false;
+
+  m_entries.clear();
+  m_names.clear();
+  m_dirty = false;
+  // headers which have been deleted or renamed since the index was written
+  // no longer declare their records
+  std::unordered_map<std::string, bool> exists;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    auto first = line.find('\t');
+    auto second = line.find('\t', first + 1);
+    if (first == std::string::npos || second == std::string::npos)
+      continue;
+
+    auto usr = line.substr(0, first);
+    Entry entry{line.substr(first + 1, second - first - 1),
+                line.substr(second + 1)};
+    auto it = exists.find(entry.header);
+    if (it == exists.end()) {
+      std::error_code ec;
+      it = exists.emplace(entry.header,
+                          std::filesystem::exists(entry.header, ec))
+               .first;
+    }
+    if (!it->second) {
+      m_dirty = true;
+      continue;
+    }
+    AddNames(usr, entry.name);
+    m_entries[usr] = std::move(entry);
+  }
+  return true;
+}
+
+bool ProjectIndex::Save(const std::filesystem::path &file) {
+  if (!m_dirty && std::filesystem::exists(file))
+    return true;
+
+  std::ostringstream content;
+  for (auto &[usr, entry] : m_entries)
+    content << usr << "\t" << entry.name << "\t" << entry.header << "\n";
+
+  std::ofstream out(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!out.is_open())
+    return false;
+  out << content.str();
+  m_dirty = false;
+  return out.good();
+}
+
+void ProjectIndex::Update(
+    const std::string &header,
+    const std::vector<std::unique_ptr<CxxRecord>> &records) {
+  std::map<std::string, Entry> newEntries;
+  for (auto &record : records) {
+    if (!record->GetUSR().empty())
+      newEntries[record->GetUSR()] = Entry{record->GetFullName(), header};
+  }
+
+  std::map<std::string, Entry> oldEntries;
+  for (auto &[usr, entry] : m_entries) {
+    if (entry.header == header)
+      oldEntries.emplace(usr, entry);
+  }
+
+  auto isSame = [](const auto &a, const auto &b) {
+    return a.first == b.first && a.second.name == b.second.name;
+  };
+  if (std::equal(oldEntries.begin(), oldEntries.end(), newEntries.begin(),
+                 newEntries.end(), isSame))
+    return;
+
+  for (auto &[usr, entry] : oldEntries) {
+    RemoveNames(usr, entry.name);
+    m_entries.erase(usr);
+  }
+  for (auto &[usr, entry] : newEntries) {
+    auto it = m_entries.find(usr);
+    if (it != m_entries.end())
+      RemoveNames(usr, it->second.name);
+    AddNames(usr, entry.name);
+    m_entries[usr] = entry;
+  }
+  m_dirty = true;
+}
+
+const ProjectIndex::Entry *ProjectIndex::Find(const std::string &usr) const {
+  auto it = m_entries.find(usr);
+  return it == m_entries.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string>
+ProjectIndex::FindHeaders(const std::string &name) const {
+  std::vector<std::string> headers;
+  auto [begin, end] = m_names.equal_range(name);
+  for (auto it = begin; it != end; ++it) {
+    if (auto *entry = Find(it->second))
+      headers.push_back(entry->header);
+  }
+  std::sort(headers.begin(), headers.end());
+  headers.erase(std::unique(headers.begin(), headers.end()), headers.end());
+  return headers;
+}
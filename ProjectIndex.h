@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CxxRecord.h"
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace PReflTool {
+
+// Persistent index of the reflected records of a project, keyed by clang USR.
+// One line per record:
+//   <usr> \t <qualified name> \t <header>
+// Lines are sorted by USR, so the file does not depend on the order in which
+// headers have been processed.
+class ProjectIndex {
+public:
+  struct Entry {
+    std::string name;
+    std::string header;
+  };
+
+private:
+  std::map<std::string, Entry> m_entries;
+  // qualified name and plain name -> USR, for queries
+  std::unordered_multimap<std::string, std::string> m_names;
+  bool m_dirty = false;
+
+  void AddNames(const std::string &usr, const std::string &name);
+  void RemoveNames(const std::string &usr, const std::string &name);
+
+public:
+  // The entries of headers which no longer exist are dropped.
+  bool Load(const std::filesystem::path &file);
+  // Only writes the file if the index has been modified.
+  bool Save(const std::filesystem::path &file);
+
+  // Replace the records of `header` by `records`.
+  void Update(const std::string &header,
+              const std::vector<std::unique_ptr<CxxRecord>> &records);
+
+  bool IsReflected(const std::string &usr) const {
+    return m_entries.find(usr) != m_entries.end();
+  }
+  // Header that reflects the record, or nullptr.
+  const Entry *Find(const std::string &usr) const;
+  // Headers reflecting a type, by qualified (ns::Type<T>) or plain name.
+  std::vector<std::string> FindHeaders(const std::string &name) const;
+
+  const std::map<std::string, Entry> &GetEntries() const { return m_entries; }
+
+  // Normalized absolute path, so one header reached through different paths
+  // gets only one entry.
+  static std::string NormalizePath(const std::filesystem::path &file);
+};
+} // namespace PReflTool
@@ -0,0 +1,190 @@
+#include "Scanner.h"
+#include "Attributes.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace PReflTool;
+
+namespace {
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+// "META=clang::annotate(\"meta\")" -> "META"
+llvm::StringRef GetMarcoName(const char *marco) {
+  llvm::StringRef def{marco};
+  return def.take_until([](char c) { return c == '=' || c == '('; });
+}
+
+// Search a whole identifier, e.g. META but not METADATA.
+bool ContainsIdentifier(llvm::StringRef text, llvm::StringRef id) {
+  size_t pos = text.find(id);
+  while (pos != llvm::StringRef::npos) {
+    size_t end = pos + id.size();
+    bool headOk = pos == 0 || !IsIdentifierChar(text[pos - 1]);
+    bool tailOk = end >= text.size() || !IsIdentifierChar(text[end]);
+    if (headOk && tailOk)
+      return true;
+    pos = text.find(id, end);
+  }
+  return false;
+}
+
+// Map the file and check its content. Empty files can not be mapped and never
+// contain annotations.
+bool CheckFile(const std::filesystem::path &file, size_t size) {
+  if (size == 0)
+    return false;
+
+  auto fd = llvm::sys::fs::openNativeFileForRead(file.string());
+  if (!fd) {
+    llvm::consumeError(fd.takeError());
+    return false;
+  }
+
+  std::error_code ec;
+  llvm::sys::fs::mapped_file_region region(
+      *fd, llvm::sys::fs::mapped_file_region::readonly, size, 0, ec);
+  llvm::sys::fs::closeFile(*fd);
+  if (ec)
+    return false;
+
+  return Scanner::HasAnnotation(region.const_data(), size);
+}
+} // namespace
+
+Scanner::Scanner(unsigned threads) : m_threads(threads) {
+  if (m_threads == 0)
+    m_threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool Scanner::IsHeader(const std::filesystem::path &file) {
+  auto ext = file.extension();
+  return ext == ".h" || ext == ".hpp" || ext == ".hh" || ext == ".hxx";
+}
+
+bool Scanner::HasAnnotation(const char *data, size_t size) {
+  llvm::StringRef text{data, size};
+  return ContainsIdentifier(text, GetMarcoName(MetaAnnotate::GetMarco())) ||
+         text.contains("annotate(\"meta\"");
+}
+
+std::vector<std::filesystem::path>
+Scanner::Scan(const std::filesystem::path &root) {
+  m_stats = ScanStats{};
+  auto start = std::chrono::steady_clock::now();
+
+  // Directories are the unit of work. A worker lists one directory, queues
+  // the sub directories and checks the headers inside it.
+  std::vector<std::filesystem::path> dirs{root};
+  size_t busy = 0;
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  std::vector<std::filesystem::path> result;
+  std::atomic<size_t> files{0}, bytes{0};
+
+  auto worker = [&]() {
+    std::vector<std::filesystem::path> matched;
+    while (true) {
+      std::filesystem::path dir;
+      {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&]() { return !dirs.empty() || busy == 0; });
+        if (dirs.empty())
+          break;
+        dir = std::move(dirs.back());
+        dirs.pop_back();
+        ++busy;
+      }
+
+      std::vector<std::filesystem::path> subDirs;
+      std::error_code ec;
+      for (auto it = std::filesystem::directory_iterator(dir, ec);
+           !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        const auto &entry = *it;
+        std::error_code typeEc;
+        if (entry.is_directory(typeEc)) {
+          auto name = entry.path().filename().string();
+          // skip generated results and hidden directories (.git etc.)
+          if (name != "generated" && name.front() != '.')
+            subDirs.push_back(entry.path());
+        } else if (entry.is_regular_file(typeEc) && IsHeader(entry.path())) {
+          size_t size = static_cast<size_t>(entry.file_size(typeEc));
+          if (typeEc)
+            continue;
+          ++files;
+          bytes += size;
+          if (CheckFile(entry.path(), size))
+            matched.push_back(entry.path());
+        }
+      }
+
+      {
+        std::lock_guard lock(mutex);
+        for (auto &sub : subDirs)
+          dirs.push_back(std::move(sub));
+        --busy;
+      }
+      cv.notify_all();
+    }
+
+    std::lock_guard lock(mutex);
+    result.insert(result.end(), matched.begin(), matched.end());
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(m_threads);
+  for (unsigned i = 0; i < m_threads; ++i)
+    threads.emplace_back(worker);
+  for (auto &t : threads)
+    t.join();
+
+  std::sort(result.begin(), result.end());
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  m_stats.files = files;
+  m_stats.bytes = bytes;
+  m_stats.matched = result.size();
+  m_stats.seconds = elapsed.count();
+  return result;
+}
+
+bool Scanner::WriteManifest(const std::filesystem::path &manifest,
+                            const std::vector<std::filesystem::path> &files) {
+  std::ofstream out(manifest, std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+    return false;
+
+  out << "# reflected headers found by PupilReflTool --scan\n";
+  for (auto &file : files)
+    out << file.string() << "\n";
+  out.close();
+  return true;
+}
+
+std::vector<std::filesystem::path>
+Scanner::ReadManifest(const std::filesystem::path &manifest) {
+  std::vector<std::filesystem::path> files;
+  std::ifstream in(manifest);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line.front() == '#')
+      continue;
+    files.emplace_back(line);
+  }
+  return files;
+}
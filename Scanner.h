@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+struct ScanStats {
+  size_t files = 0;   // header files that have been checked
+  size_t bytes = 0;   // total size of the checked files
+  size_t matched = 0; // files which contain annotation macros
+  double seconds = 0.;
+};
+
+// Walk a source tree in parallel and find the headers that contain reflection
+// annotations. The files are memory mapped and only searched for the macro
+// names, so no clang parse is needed for headers without annotations.
+class Scanner {
+  unsigned m_threads;
+  ScanStats m_stats;
+
+public:
+  Scanner(unsigned threads = 0);
+  ~Scanner() = default;
+
+  // Return the matched headers sorted by path.
+  std::vector<std::filesystem::path> Scan(const std::filesystem::path &root);
+
+  const ScanStats &GetStats() const { return m_stats; }
+
+  static bool IsHeader(const std::filesystem::path &file);
+  static bool HasAnnotation(const char *data, size_t size);
+
+  static bool WriteManifest(const std::filesystem::path &manifest,
+                            const std::vector<std::filesystem::path> &files);
+  static std::vector<std::filesystem::path>
+  ReadManifest(const std::filesystem::path &manifest);
+};
+} // namespace PReflTool
@@ -0,0 +1,178 @@
+#include "SchemaWriter.h"
+
+#include "schema/PReflSchema.h"
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+using namespace PReflTool;
+
+namespace {
+class StringTable {
+  std::string m_data;
+  std::unordered_map<std::string, PReflSchema::StringRef> m_refs;
+
+public:
+  PReflSchema::StringRef Add(const std::string &str) {
+    auto it = m_refs.find(str);
+    if (it != m_refs.end())
+      return it->second;
+
+    PReflSchema::StringRef ref{static_cast<uint32_t>(m_data.size()),
+                               static_cast<uint32_t>(str.size())};
+    m_data += str;
+    m_data += '\0';
+    m_refs.emplace(str, ref);
+    return ref;
+  }
+
+  const std::string &GetData() const { return m_data; }
+};
+
+PReflSchema::ERecordType ConvertRecordType(ECxxRecordType type) {
+  switch (type) {
+  case ECxxRecordType::Class:
+    return PReflSchema::ERecordType::Class;
+  case ECxxRecordType::Struct:
+    return PReflSchema::ERecordType::Struct;
+  case ECxxRecordType::None:
+  default:
+    return PReflSchema::ERecordType::None;
+  }
+}
+
+PReflSchema::Attr ConvertAttr(Attr *attr, StringTable &strings) {
+  PReflSchema::Attr result{};
+  auto name = attr->GetName();
+  result.name = strings.Add(name);
+  result.info = strings.Add("");
+  result.type = PReflSchema::EAttrType::Unknown;
+
+  if (name.compare(MetaAnnotate::name) == 0) {
+    result.type = PReflSchema::EAttrType::Meta;
+  } else if (name.compare(InfoAnnotate::name) == 0) {
+    result.type = PReflSchema::EAttrType::Info;
+    result.info = strings.Add(static_cast<InfoAnnotate *>(attr)->info);
+  } else if (name.compare(RangeAnnotate::name) == 0) {
+    auto *range = static_cast<RangeAnnotate *>(attr);
+    result.type = PReflSchema::EAttrType::Range;
+    result.values[0] = range->vmin;
+    result.values[1] = range->vmax;
+  } else if (name.compare(StepAnnotate::name) == 0) {
+    result.type = PReflSchema::EAttrType::Step;
+    result.values[0] = static_cast<StepAnnotate *>(attr)->step;
+  }
+  return result;
+}
+
+template <typename T>
+PReflSchema::Section AppendSection(std::string &out, const std::vector<T> &v) {
+  out.resize((out.size() + 7) & ~size_t(7), '\0');
+  PReflSchema::Section section{static_cast<uint32_t>(out.size()),
+                               static_cast<uint32_t>(v.size())};
+  out.append(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+  return section;
+}
+} // namespace
+
+std::string SchemaWriter::Serialize(
+    const std::vector<std::unique_ptr<CxxRecord>> &records) {
+  // records are sorted by qualified name, so the output does not depend on
+  // the declaration order and readers may also binary search
+  std::vector<std::pair<std::string, const CxxRecord *>> sorted;
+  sorted.reserve(records.size());
+  for (auto &record : records)
+    sorted.emplace_back(record->GetFullName(), record.get());
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](auto &a, auto &b) { return a.first < b.first; });
+
+  std::unordered_map<std::string, uint32_t> recordIndex;
+  for (uint32_t i = 0; i < sorted.size(); ++i)
+    recordIndex.emplace(sorted[i].first, i);
+
+  StringTable strings;
+  std::vector<PReflSchema::Record> outRecords;
+  std::vector<PReflSchema::Field> outFields;
+  std::vector<PReflSchema::Attr> outAttrs;
+  std::vector<PReflSchema::Base> outBases;
+
+  for (auto &[fullName, record] : sorted) {
+    PReflSchema::Record outRecord{};
+    outRecord.name = strings.Add(record->GetName());
+    outRecord.qualifiedName = strings.Add(fullName);
+    outRecord.type = ConvertRecordType(record->GetType());
+    outRecord.templateCount =
+        static_cast<uint32_t>(record->GetTemplates().size());
+
+    outRecord.firstField = static_cast<uint32_t>(outFields.size());
+    outRecord.fieldCount = static_cast<uint32_t>(record->GetFields().size());
+    for (auto &field : record->GetFields()) {
+      PReflSchema::Field outField{};
+      outField.name = strings.Add(field->name);
+      outField.firstAttr = static_cast<uint32_t>(outAttrs.size());
+      outField.attrCount = static_cast<uint32_t>(field->attrs.size());
+      for (auto &attr : field->attrs)
+        outAttrs.push_back(ConvertAttr(attr.get(), strings));
+      outFields.push_back(outField);
+    }
+
+    outRecord.firstBase = static_cast<uint32_t>(outBases.size());
+    outRecord.baseCount = static_cast<uint32_t>(record->GetBases().size());
+    for (auto &base : record->GetBases()) {
+      auto it = recordIndex.find(base);
+      outBases.push_back(
+          {strings.Add(base),
+           it == recordIndex.end() ? PReflSchema::s_invalidIndex : it->second});
+    }
+    outRecords.push_back(outRecord);
+  }
+
+  // at most half full, so probe sequences stay short
+  uint32_t slotCnt = 1;
+  while (slotCnt < outRecords.size() * 2)
+    slotCnt <<= 1;
+  std::vector<uint32_t> slots(outRecords.empty() ? 0 : slotCnt,
+                              PReflSchema::s_invalidIndex);
+  for (uint32_t i = 0; i < sorted.size(); ++i) {
+    uint32_t slot =
+        static_cast<uint32_t>(PReflSchema::Hash(sorted[i].first)) &
+        (slotCnt - 1);
+    while (slots[slot] != PReflSchema::s_invalidIndex)
+      slot = (slot + 1) & (slotCnt - 1);
+    slots[slot] = i;
+  }
+
+  PReflSchema::Header header{};
+  std::copy(std::begin(PReflSchema::s_magic), std::end(PReflSchema::s_magic),
+            header.magic);
+  header.byteOrder = PReflSchema::s_byteOrder;
+  header.version = PReflSchema::s_version;
+
+  std::string out(sizeof(header), '\0');
+  out.resize((out.size() + 7) & ~size_t(7), '\0');
+  header.stringTableOffset = static_cast<uint32_t>(out.size());
+  header.stringTableSize = static_cast<uint32_t>(strings.GetData().size());
+  out += strings.GetData();
+  header.records = AppendSection(out, outRecords);
+  header.fields = AppendSection(out, outFields);
+  header.attrs = AppendSection(out, outAttrs);
+  header.bases = AppendSection(out, outBases);
+  header.hashIndex = AppendSection(out, slots);
+  header.fileSize = static_cast<uint32_t>(out.size());
+
+  std::copy(reinterpret_cast<const char *>(&header),
+            reinterpret_cast<const char *>(&header) + sizeof(header),
+            out.begin());
+  return out;
+}
+
+bool SchemaWriter::Write(
+    const std::filesystem::path &file,
+    const std::vector<std::unique_ptr<CxxRecord>> &records) {
+  std::ofstream out(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!out.is_open())
+    return false;
+  out << Serialize(records);
+  return out.good();
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CxxRecord.h"
+
+#include <filesystem>
+
+namespace PReflTool {
+
+// Backend writing the records as a memory-mappable binary schema, the layout
+// is described in schema/PReflSchema.h.
+class SchemaWriter {
+public:
+  static std::string Serialize(
+      const std::vector<std::unique_ptr<CxxRecord>> &records);
+
+  static bool Write(const std::filesystem::path &file,
+                    const std::vector<std::unique_ptr<CxxRecord>> &records);
+};
+} // namespace PReflTool
@@ -0,0 +1,89 @@
+#include "StubOverlay.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/xxhash.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace PReflTool;
+
+// The directory does not exist on disk, it is only visible to the frontend.
+static const char *s_stubDirName = "__prefl_stubs__";
+
+StubOverlay::StubOverlay() {
+  m_stubDir = std::filesystem::current_path() / s_stubDirName;
+}
+
+bool StubOverlay::Load(const std::filesystem::path &config) {
+  std::ifstream file(config);
+  if (!file.is_open()) {
+    std::cerr << "*** error : can not open stub config " << config.string()
+              << "\n";
+    return false;
+  }
+
+  std::string line;
+  std::string *stub = nullptr;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+
+    if (line.size() > 2 && line.front() == '[' && line.back() == ']') {
+      stub = &m_stubs[line.substr(1, line.size() - 2)];
+      stub->clear();
+      continue;
+    }
+    if (!stub) {
+      // only comments and empty lines before the first section
+      if (!line.empty() && line.front() != '#') {
+        std::cerr << "*** error : " << config.string()
+                  << ": stub content without [header] section\n";
+        return false;
+      }
+      continue;
+    }
+    *stub += line;
+    *stub += '\n';
+  }
+  return true;
+}
+
+bool StubOverlay::IsStubFile(llvm::StringRef file) {
+  for (auto &part : llvm::make_range(llvm::sys::path::begin(file),
+                                     llvm::sys::path::end(file))) {
+    if (part == s_stubDirName)
+      return true;
+  }
+  return false;
+}
+
+uint64_t StubOverlay::GetHash() const {
+  std::string key;
+  for (auto &[name, content] : m_stubs) {
+    key += name;
+    key += '\0';
+    key += content;
+    key += '\0';
+  }
+  return llvm::xxHash64(key);
+}
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>
+StubOverlay::CreateFileSystem() const {
+  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> overlay(
+      new llvm::vfs::OverlayFileSystem(llvm::vfs::getRealFileSystem()));
+  if (m_stubs.empty())
+    return overlay;
+
+  llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> memory(
+      new llvm::vfs::InMemoryFileSystem);
+  for (auto &[name, content] : m_stubs) {
+    auto path = (m_stubDir / name).lexically_normal();
+    memory->addFile(path.string(), 0,
+                    llvm::MemoryBuffer::getMemBufferCopy(content, name));
+  }
+  overlay->pushOverlay(memory);
+  return overlay;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+
+namespace PReflTool {
+
+// Minimal stub declarations for heavy headers (STL, math libraries...), which
+// are mounted through an in-memory file system on top of the real one. The
+// stub directory is searched before the system include paths, so the
+// frontend only parses what the extraction needs.
+//
+// Config file format:
+//   # comment
+//   [vector]
+//   namespace std { template <typename T, typename A = void> class vector; }
+//   [util/math.h]
+//   ...
+// Each [name] section starts a stub header, `name` is spelled as in the
+// #include directive.
+class StubOverlay {
+  std::filesystem::path m_stubDir;
+  std::map<std::string, std::string> m_stubs;
+
+public:
+  StubOverlay();
+  ~StubOverlay() = default;
+
+  bool Load(const std::filesystem::path &config);
+
+  bool IsEmpty() const { return m_stubs.empty(); }
+  size_t GetSize() const { return m_stubs.size(); }
+
+  // Hash of the stub names and contents, stable across runs.
+  uint64_t GetHash() const;
+
+  // Whether `file` is one of the stub headers.
+  static bool IsStubFile(llvm::StringRef file);
+
+  // Virtual directory which has to be added in front of the include paths.
+  std::string GetIncludeDir() const { return m_stubDir.string(); }
+
+  // The real file system overlaid by the stub headers.
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> CreateFileSystem() const;
+};
+} // namespace PReflTool
@@ -0,0 +1,600 @@
+#include "Tool.h"
+#include "Generator.h"
+#include "Visitor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "clang/AST/AST.h"
+#include "clang/AST/ASTConsumer.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Frontend/ASTConsumers.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/Tooling.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace clang;
+using namespace clang::driver;
+using namespace clang::tooling;
+
+namespace PReflTool {
+namespace {
+// Parses run on several threads, keep their messages in one piece.
+std::mutex s_outputMutex;
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+// Target headers of a parse by file. A header without include guard may be
+// entered more than once, so the headers are matched by file entry.
+using TargetFiles = std::map<const clang::FileEntry *, Generator *>;
+
+class Analyzer : public clang::ASTConsumer {
+  Visitor m_visitor;
+  clang::Preprocessor &m_pp;
+  const TargetFiles &m_targets;
+  Milliseconds &m_visitTime;
+
+public:
+  Analyzer(clang::CompilerInstance &ci, const TargetFiles &targets,
+           Milliseconds &visitTime)
+      : m_visitor(ci.getSourceManager()), m_pp(ci.getPreprocessor()),
+        m_targets(targets), m_visitTime(visitTime) {}
+
+  void HandleTranslationUnit(clang::ASTContext &context) final {
+    auto visitStart = std::chrono::steady_clock::now();
+    auto decls = context.getTranslationUnitDecl()->decls();
+    auto &sm = m_visitor.GetSourceManager();
+
+    // Each decl goes to the generator of the target header it is declared
+    // in, decls of the other included files are skipped.
+    clang::FileID lastFile;
+    Generator *generator = nullptr;
+    for (auto &decl : decls) {
+      auto fileID = sm.getFileID(decl->getLocation());
+      if (fileID != lastFile) {
+        lastFile = fileID;
+        auto it = m_targets.find(sm.getFileEntryForID(fileID));
+        generator = it != m_targets.end() ? it->second : nullptr;
+      }
+      if (generator)
+        m_visitor.Visit(decl, generator);
+    }
+    m_visitTime += std::chrono::steady_clock::now() - visitStart;
+
+    // The whole process is shared by the parallel parses, so the memory of
+    // one parse is taken from the allocators of its AST, sources and
+    // preprocessor.
+    auto buffers = sm.getMemoryBufferSizes();
+    size_t memory = context.getASTAllocatedMemory() +
+                    context.getSideTableAllocatedMemory() +
+                    sm.getContentCacheSize() + sm.getDataStructureSizes() +
+                    buffers.malloc_bytes + buffers.mmap_bytes +
+                    m_pp.getTotalMemory();
+    for (auto &[file, target] : m_targets)
+      target->SetParseMemory(memory);
+  }
+};
+
+// Record the user headers included by each target file. The include graph
+// is collected during the parse, since a header shared by several targets of
+// a unity batch is only entered by the first one.
+class DependencyCollector : public clang::PPCallbacks {
+  clang::SourceManager &m_sm;
+  const TargetFiles &m_targets;
+  std::map<const clang::FileEntry *, std::set<const clang::FileEntry *>>
+      m_includes;
+  clang::FileID m_current;
+
+  void AddInclude(const clang::FileEntry *file) {
+    if (auto *includer = m_sm.getFileEntryForID(m_current))
+      m_includes[includer].insert(file);
+  }
+
+public:
+  DependencyCollector(clang::SourceManager &sm, const TargetFiles &targets)
+      : m_sm(sm), m_targets(targets) {}
+
+  void FileChanged(clang::SourceLocation loc, FileChangeReason reason,
+                   clang::SrcMgr::CharacteristicKind fileType,
+                   clang::FileID) final {
+    if (reason != EnterFile && reason != ExitFile)
+      return;
+    auto fileID = m_sm.getFileID(m_sm.getExpansionLoc(loc));
+    if (reason == EnterFile && fileType == clang::SrcMgr::C_User) {
+      if (auto *entry = m_sm.getFileEntryForID(fileID))
+        AddInclude(entry);
+    }
+    m_current = fileID;
+  }
+
+  void FileSkipped(const clang::FileEntryRef &skippedFile, const clang::Token &,
+                   clang::SrcMgr::CharacteristicKind fileType) final {
+    if (fileType == clang::SrcMgr::C_User)
+      AddInclude(&skippedFile.getFileEntry());
+  }
+
+  void EndOfMainFile() final {
+    for (auto &[target, generator] : m_targets) {
+      std::set<const clang::FileEntry *> visited{target};
+      std::vector<const clang::FileEntry *> pending{target};
+      while (!pending.empty()) {
+        auto it = m_includes.find(pending.back());
+        pending.pop_back();
+        if (it == m_includes.end())
+          continue;
+        for (auto *file : it->second) {
+          if (!visited.insert(file).second)
+            continue;
+          generator->AddDependency(file->getName().str());
+          pending.push_back(file);
+        }
+      }
+    }
+  }
+};
+
+// Error diagnostics go to the target header which includes their location,
+// or to all targets of the parse when no target does. Warnings and notes
+// are dropped.
+class ParseDiagConsumer : public clang::DiagnosticConsumer {
+  const TargetFiles &m_targets;
+
+public:
+  explicit ParseDiagConsumer(const TargetFiles &targets)
+      : m_targets(targets) {}
+
+  void HandleDiagnostic(clang::DiagnosticsEngine::Level level,
+                        const clang::Diagnostic &info) final {
+    // counts the errors, which fail the parse
+    DiagnosticConsumer::HandleDiagnostic(level, info);
+    if (level < clang::DiagnosticsEngine::Error)
+      return;
+
+    llvm::SmallString<128> message;
+    info.FormatDiagnostic(message);
+    Generator *target = nullptr;
+    if (info.hasSourceManager() && info.getLocation().isValid()) {
+      auto &sm = info.getSourceManager();
+      auto loc = sm.getFileLoc(info.getLocation());
+      auto presumed = sm.getPresumedLoc(loc);
+      if (presumed.isValid())
+        message.insert(message.begin(),
+                       std::string(presumed.getFilename()) + ":" +
+                           std::to_string(presumed.getLine()) + ": ");
+      // the innermost target header which includes the location
+      for (auto fileID = sm.getFileID(loc); fileID.isValid() && !target;) {
+        auto it = m_targets.find(sm.getFileEntryForID(fileID));
+        if (it != m_targets.end())
+          target = it->second;
+        auto includeLoc = sm.getIncludeLoc(fileID);
+        fileID = includeLoc.isValid() ? sm.getFileID(includeLoc)
+                                      : clang::FileID();
+      }
+    }
+    if (target) {
+      target->AddParseError(message.str().str());
+      return;
+    }
+    for (auto &[file, generator] : m_targets)
+      generator->AddParseError(message.str().str());
+  }
+};
+
+class AnalyzerAction : public clang::ASTFrontendAction {
+  std::vector<Generator *> m_generators;
+  TargetFiles m_targets;
+  Milliseconds &m_visitTime;
+
+public:
+  AnalyzerAction(std::vector<Generator *> generators,
+                 Milliseconds &visitTime)
+      : m_generators(std::move(generators)), m_visitTime(visitTime) {}
+
+  std::unique_ptr<clang::ASTConsumer>
+  CreateASTConsumer(clang::CompilerInstance &ci, clang::StringRef) final {
+    m_targets.clear();
+    ci.getDiagnostics().setClient(new ParseDiagConsumer(m_targets));
+    for (auto *generator : m_generators) {
+      auto file = ci.getFileManager().getFile(
+          generator->GetTargetFilePath().string());
+      if (file)
+        m_targets[*file] = generator;
+    }
+    ci.getPreprocessor().addPPCallbacks(std::make_unique<DependencyCollector>(
+        ci.getSourceManager(), m_targets));
+    return std::unique_ptr<clang::ASTConsumer>(new Analyzer(ci, m_targets, m_visitTime));
+  }
+};
+
+std::unique_ptr<FrontendActionFactory>
+NewAnalyzerActionFactory(std::vector<Generator *> generators,
+                         Milliseconds &visitTime) {
+  class AnalyzerActionFactory : public FrontendActionFactory {
+    std::vector<Generator *> m_generators;
+    Milliseconds &m_visitTime;
+
+  public:
+    AnalyzerActionFactory(std::vector<Generator *> generators,
+                          Milliseconds &visitTime)
+        : m_generators(std::move(generators)), m_visitTime(visitTime) {}
+
+    std::unique_ptr<FrontendAction> create() override {
+      return std::make_unique<AnalyzerAction>(m_generators, m_visitTime);
+    }
+  };
+
+  return std::unique_ptr<FrontendActionFactory>(
+      new AnalyzerActionFactory(std::move(generators), visitTime));
+}
+
+enum class EExtractResult {
+  UpToDate,  // the generated file is newer than the target file
+  FromCache, // records are loaded from the IR cache
+  Parsed,    // records are extracted by clang
+  Failed     // clang reported errors
+};
+
+// Reuse the output or the records of an earlier run. Returns Parsed when the
+// target file has to be parsed.
+EExtractResult CheckUpToDate(Generator &generator, const Options &options,
+                             uint64_t config) {
+  // in memory runs always need the records
+  if (options.writeOutputs && !options.force && generator.CheckModifyTime()) {
+    std::lock_guard<std::mutex> lock(s_outputMutex);
+    std::cout << generator.GetGeneratedFilePath().stem()
+              << "'s reflection file does not need to be regenerated.\n";
+    return EExtractResult::UpToDate;
+  }
+  if (options.useIRCache && generator.LoadIRCache(config))
+    return EExtractResult::FromCache;
+  return EExtractResult::Parsed;
+}
+
+// Compiler arguments of every parse, besides the stub include directory.
+std::vector<std::string> GetCompileArgs() {
+  return {
+      "-xc++",
+      "-D",
+      MetaAnnotate::GetMarco(),
+      "-D",
+      RangeAnnotate::GetMarco(),
+      "-D",
+      InfoAnnotate::GetMarco(),
+      "-D",
+      StepAnnotate::GetMarco(),
+      "-D",
+      SoAAnnotate::GetMarco(),
+      "INFO(str)=clang::annotate(\"info\", str)",
+      "-std=c++20",                     // use c++ 20
+      "-Wno-pragma-once-outside-header" // ignore #pragma once warning
+  };
+}
+
+// Hash of what changes the records extracted from unchanged sources, stored
+// in the IR caches: the compiler arguments and the stub headers. The path of
+// the stub directory is left out, it only depends on the working directory.
+uint64_t GetExtractionConfig(const StubOverlay &stubs) {
+  std::string key;
+  for (auto &arg : GetCompileArgs()) {
+    key += arg;
+    key += '\0';
+  }
+  if (!stubs.IsEmpty())
+    key += std::to_string(stubs.GetHash());
+  return llvm::xxHash64(key);
+}
+
+// Fill the generators with the records of their target files, parsed in one
+// translation unit. Several targets are included by a unity file named
+// `unityFile`, which only exists in memory.
+void RunTool(const std::vector<Generator *> &generators,
+             const std::string &unityFile, const Options &options,
+             const StubOverlay &stubs) {
+  auto args = GetCompileArgs();
+  // stub headers are found before the real ones
+  if (!stubs.IsEmpty())
+    args.push_back("-I" + stubs.GetIncludeDir());
+
+  // A fixed database instead of CommonOptionsParser, which parses into the
+  // global llvm::cl options and can not be used by parallel parses.
+  FixedCompilationDatabase compilations(".", args);
+  auto parseStart = std::chrono::steady_clock::now();
+  Milliseconds visitTime{0};
+  {
+    // The CompilerInstance, and so the AST, is destroyed at the end of run,
+    // before the file is generated.
+    std::string source = generators.size() == 1
+                             ? generators[0]->GetTargetFilePath().string()
+                             : unityFile;
+    ClangTool tool(compilations, {source},
+                   std::make_shared<PCHContainerOperations>(),
+                   stubs.CreateFileSystem());
+    if (generators.size() > 1) {
+      std::string includes;
+      for (auto *generator : generators) {
+        auto target = std::filesystem::absolute(generator->GetTargetFilePath());
+        includes += "#include \"" + target.generic_string() + "\"\n";
+      }
+      tool.mapVirtualFile(unityFile, includes);
+    }
+    // errors before the action starts, such as bad arguments, are printed
+    // by clang and not given to the targets
+    if (tool.run(NewAnalyzerActionFactory(generators, visitTime).get()) != 0) {
+      for (auto *generator : generators) {
+        if (generator->GetParseErrors().empty())
+          generator->AddParseError("clang could not parse the header");
+      }
+    }
+  }
+  auto parseEnd = std::chrono::steady_clock::now();
+
+  if (options.stats) {
+    Milliseconds parseTime = parseEnd - parseStart;
+    std::lock_guard<std::mutex> lock(s_outputMutex);
+    std::cout << "*** stats: parse " << parseTime.count() << " ms";
+    if (generators.size() > 1)
+      std::cout << " (" << generators.size() << " headers)";
+    std::cout << ", visit " << visitTime.count() << " ms\n";
+  }
+}
+
+// Type IDs are hashes of the qualified names, so two records of the project
+// may get the same ID. Records of up to date headers are only known by the
+// index.
+bool CheckTypeIds(const std::vector<std::unique_ptr<Generator>> &generators,
+                  const ProjectIndex *index) {
+  std::map<uint64_t, std::string> ids;
+  bool unique = true;
+  auto check = [&](const std::string &name) {
+    auto [it, inserted] = ids.emplace(Generator::GetTypeId(name), name);
+    if (!inserted && it->second != name) {
+      std::cerr << "*** error : type id collision between " << it->second
+                << " and " << name << "\n";
+      unique = false;
+    }
+  };
+  if (index) {
+    for (auto &[usr, entry] : index->GetEntries()) {
+      if (entry.name.find('<') == std::string::npos)
+        check(entry.name);
+    }
+  }
+  for (auto &generator : generators) {
+    for (auto &name : generator->GetTypeNames())
+      check(name);
+  }
+  return unique;
+}
+
+Options ResolveJobs(Options options) {
+  if (options.jobs == 0)
+    options.jobs = std::max(1u, std::thread::hardware_concurrency());
+  return options;
+}
+
+// The parses hold the ASTs and need by far the most memory. Without a budget
+// only an explicit number of jobs runs them in parallel.
+unsigned GetParseJobs(const Options &options, size_t memoryBudget) {
+  if (options.jobs == 0 && memoryBudget == 0)
+    return 1;
+  return ResolveJobs(options).jobs;
+}
+} // namespace
+
+Tool::Tool(Options options, size_t memoryBudget)
+    : m_options(ResolveJobs(options)),
+      m_scheduler(GetParseJobs(options, memoryBudget), memoryBudget) {}
+
+void Tool::LoadIndex(const std::filesystem::path &file) {
+  m_index.Load(file);
+  m_useIndex = true;
+}
+
+// Extract the records of all files first, so the index knows every reflected
+// record before the first file is generated.
+std::vector<ToolOutput> Tool::Run(const std::vector<std::string> &files,
+                                  bool needDependencies) {
+  const auto &options = m_options;
+  m_failed = false;
+  ProjectIndex *index = m_useIndex ? &m_index : nullptr;
+  uint64_t config = GetExtractionConfig(m_stubs);
+  std::vector<std::string> targets;
+  std::vector<std::unique_ptr<Generator>> candidates;
+  std::set<std::string> visited;
+  for (auto &fileName : files) {
+    std::filesystem::path filePath{fileName};
+    if (!std::filesystem::exists(filePath)) {
+      std::cerr << "*** error : " << fileName << " does not exist\n";
+      m_failed = true;
+      continue;
+    }
+    // the same header may be passed twice or reached through other paths
+    auto normalized = ProjectIndex::NormalizePath(filePath);
+    if (!visited.insert(normalized).second)
+      continue;
+
+    filePath.make_preferred();
+    targets.push_back(normalized);
+    candidates.push_back(
+        std::make_unique<Generator>(filePath.string(), options));
+  }
+
+  // the checks only read the outputs and the IR caches
+  std::vector<EExtractResult> extracted(candidates.size());
+  std::atomic<size_t> next{0};
+  auto check = [&]() {
+    for (size_t i = next++; i < candidates.size(); i = next++)
+      extracted[i] = CheckUpToDate(*candidates[i], options, config);
+  };
+  std::vector<std::thread> threads;
+  unsigned threadCnt = std::min<size_t>(options.jobs, candidates.size());
+  for (unsigned i = 1; i < threadCnt; ++i)
+    threads.emplace_back(check);
+  check();
+  for (auto &t : threads)
+    t.join();
+
+  // Headers which have to be parsed, in batches of options.unityBatch headers
+  // sharing one translation unit. The memory profile keeps one entry per
+  // batch.
+  std::vector<std::vector<size_t>> batches;
+  std::vector<std::string> batchNames;
+  size_t batchSize = std::max(1u, options.unityBatch);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (extracted[i] != EExtractResult::Parsed)
+      continue;
+    if (batches.empty() || batches.back().size() >= batchSize) {
+      batches.emplace_back();
+      batchNames.emplace_back();
+    }
+    batches.back().push_back(i);
+    batchNames.back() +=
+        (batchNames.back().empty() ? "" : " + ") + targets[i];
+  }
+
+  if (options.merge) {
+    size_t parsed = std::count(extracted.begin(), extracted.end(),
+                               EExtractResult::Parsed);
+    std::cout << "*** merge: " << candidates.size() - parsed << " of "
+              << candidates.size() << " headers extracted by the shards\n";
+  }
+
+  m_scheduler.Run(batchNames, [&](size_t b) -> size_t {
+    std::vector<Generator *> generators;
+    {
+      std::lock_guard<std::mutex> lock(s_outputMutex);
+      for (auto i : batches[b]) {
+        generators.push_back(candidates[i].get());
+        std::cout << "*** start file: "
+                  << candidates[i]->GetTargetFilePath().string() << "\n";
+      }
+    }
+    auto unityFile = std::filesystem::absolute(
+        "prefl.unity." + std::to_string(b) + ".h");
+    RunTool(generators, unityFile.string(), options, m_stubs);
+    for (auto i : batches[b]) {
+      if (!candidates[i]->GetParseErrors().empty())
+        extracted[i] = EExtractResult::Failed;
+    }
+    return generators[0]->GetParseMemory();
+  });
+
+  // The records of a failed parse are incomplete. Neither the output nor the
+  // IR cache is written, so the next run parses the header again.
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (extracted[i] != EExtractResult::Failed)
+      continue;
+    auto &errors = candidates[i]->GetParseErrors();
+    std::cerr << "*** error : " << targets[i] << " has " << errors.size()
+              << " parse error(s), no file is generated\n";
+    for (size_t e = 0; e < std::min<size_t>(errors.size(), 3); ++e)
+      std::cerr << "    " << errors[e] << "\n";
+    if (!m_stubs.IsEmpty())
+      std::cerr << "    (parsed with --stubs, a stub header may lack a "
+                   "declaration the header uses)\n";
+    m_failed = true;
+  }
+
+  if (options.extractOnly) {
+    // the outputs are generated by --merge, which needs the records of all
+    // shards
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      if (extracted[i] == EExtractResult::Parsed)
+        candidates[i]->SaveIRCache(config);
+    }
+    return {};
+  }
+
+  std::vector<ToolOutput> processed;
+  std::vector<std::unique_ptr<Generator>> generators;
+  std::vector<EExtractResult> results;
+  std::vector<size_t> slots; // generator -> processed file
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    auto &generator = candidates[i];
+    auto result = extracted[i];
+    if (result == EExtractResult::Failed)
+      continue;
+
+    if (result == EExtractResult::UpToDate) {
+      // the dependencies of up to date files are only known by the cache
+      if (needDependencies && options.useIRCache)
+        generator->LoadIRCache(config);
+      auto &output = processed.emplace_back();
+      output.target = targets[i];
+      output.generated = generator->GetGeneratedFilePath();
+      output.dependencies = generator->GetDependencies();
+      output.upToDate = true;
+      continue;
+    }
+    if (index)
+      index->Update(targets[i], generator->GetRecords());
+    slots.push_back(processed.size());
+    auto &output = processed.emplace_back();
+    output.target = targets[i];
+    output.generated = generator->GetGeneratedFilePath();
+    generators.push_back(std::move(generator));
+    results.push_back(result);
+  }
+
+  // Colliding IDs would make lookups return the wrong record, no output is
+  // generated. The extracted records are still cached.
+  bool idCollision = !CheckTypeIds(generators, index);
+  if (idCollision) {
+    m_failed = true;
+    std::cerr << "*** error : no file is generated\n";
+  }
+
+  for (size_t i = 0; i < generators.size(); ++i) {
+    auto &generator = generators[i];
+    if (index)
+      generator->SetProjectIndex(index);
+
+    auto &output = processed[slots[i]];
+    auto genStart = std::chrono::steady_clock::now();
+    if (idCollision) {
+      // the earlier outputs are left as they are
+    } else if (options.writeOutputs) {
+      generator->Generate();
+    } else {
+      std::ostringstream content;
+      generator->Generate(content);
+      output.content = content.str();
+    }
+    for (auto &warning : generator->GetWarnings())
+      std::cerr << "*** warning : " << warning << "\n";
+    for (auto &error : generator->GetErrors()) {
+      std::cerr << "*** error : " << error << "\n";
+      m_failed = true;
+    }
+    auto genEnd = std::chrono::steady_clock::now();
+    // after Generate, which may append the include to the target file; the
+    // caches of the shards were written before
+    if (options.useIRCache && options.writeOutputs &&
+        (results[i] == EExtractResult::Parsed ||
+         (options.merge && results[i] == EExtractResult::FromCache)))
+      generator->SaveIRCache(config);
+    output.dependencies = generator->GetDependencies();
+
+    if (options.stats) {
+      std::chrono::duration<double, std::milli> genTime = genEnd - genStart;
+      std::cout << "*** stats: generate "
+                << generator->GetGeneratedFilePath().filename().string() << " "
+                << genTime.count() << " ms\n";
+    }
+    output.records = generator->ReleaseRecords();
+    output.enums = generator->ReleaseEnums();
+  }
+  return processed;
+}
+} // namespace PReflTool
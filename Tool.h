@@ -0,0 +1,95 @@
+#pragma once
+
+#include "BatchScheduler.h"
+#include "CxxEnum.h"
+#include "CxxRecord.h"
+#include "Options.h"
+#include "ProjectIndex.h"
+#include "StubOverlay.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+// Records and output of one target header.
+struct ToolOutput {
+  std::string target; // normalized path
+  std::filesystem::path generated;
+  // user headers included by the target
+  std::vector<std::string> dependencies;
+  // The output was newer than the target and has not been regenerated, the
+  // records are not loaded.
+  bool upToDate = false;
+  std::vector<std::unique_ptr<CxxRecord>> records;
+  std::vector<std::unique_ptr<CxxEnum>> enums;
+  // generated code, only kept when the outputs are not written
+  std::string content;
+};
+
+// Extraction and generation of a set of headers, used by PupilReflTool and
+// by build systems embedding it in their own process. The options, stubs,
+// index and memory profile stay loaded between the runs, so a run only costs
+// the headers it is given.
+//
+//   PReflTool::Options options;
+//   options.writeOutputs = false;
+//   PReflTool::Tool tool{options};
+//   for (auto &output : tool.Run({"src/scene/Light.h"}))
+//     consume(output.records, output.content);
+class Tool {
+  Options m_options;
+  StubOverlay m_stubs;
+  ProjectIndex m_index;
+  bool m_useIndex = false;
+  BatchScheduler m_scheduler;
+  bool m_failed = false;
+
+public:
+  // options.jobs == 0 is resolved to the number of hardware threads, but the
+  // headers are then parsed one at a time unless a `memoryBudget` is given.
+  // Parses only start while their expected memory fits in `memoryBudget`
+  // bytes, 0 does not limit them.
+  explicit Tool(Options options, size_t memoryBudget = 0);
+  ~Tool() = default;
+
+  // Changes apply to the next run.
+  Options &GetOptions() { return m_options; }
+  const Options &GetOptions() const { return m_options; }
+
+  bool LoadStubs(const std::filesystem::path &config) {
+    return m_stubs.Load(config);
+  }
+  // Enables the project index, a missing file starts an empty index.
+  void LoadIndex(const std::filesystem::path &file);
+  bool SaveIndex(const std::filesystem::path &file) {
+    return !m_useIndex || m_index.Save(file);
+  }
+  // null while no index is loaded
+  const ProjectIndex *GetIndex() const {
+    return m_useIndex ? &m_index : nullptr;
+  }
+
+  bool LoadProfile(const std::filesystem::path &file) {
+    return m_scheduler.LoadProfile(file);
+  }
+  bool SaveProfile(const std::filesystem::path &file) {
+    return m_scheduler.SaveProfile(file);
+  }
+
+  // Extract the records of all headers, then generate their outputs. Headers
+  // which do not exist or do not parse without errors are reported and
+  // skipped. The dependencies of up to
+  // date headers are only loaded when `needDependencies` is set. Returns
+  // nothing with options.extractOnly, the records only go to the IR caches.
+  std::vector<ToolOutput> Run(const std::vector<std::string> &headers,
+                              bool needDependencies = false);
+  // False when the last run found an error. A missing or broken header only
+  // gets no output, two records with the same type ID prevent generating any
+  // output of the run, a hash collision in a table only leaves that table out
+  // of its generated file.
+  bool Succeeded() const { return !m_failed; }
+};
+} // namespace PReflTool
@@ -1,6 +1,9 @@
 #include "Visitor.h"
+#include "StubOverlay.h"
 
-#include "llvm/IR/Constants.h"
+#include "clang/AST/QualTypeNames.h"
+#include "clang/AST/RecordLayout.h"
+#include "clang/Index/USRGeneration.h"
 
 #include <iostream>
 
@@ -24,313 +27,619 @@ bool HasAnnotate(clang::Decl *decl, llvm::StringRef targetAnnotate) {
   return false;
 }
 
-int ConvertToBaseNumber(llvm::APInt integer) {
-  SmallVector<char, 32> buffer;
-  integer.toString(buffer, 10, true);
-  buffer.push_back('\0');
-
-  std::string numString(buffer.data());
-  return std::stoi(numString);
+// Value of an argument of RANGE or STEP. The arguments are constant
+// expressions, e.g. RANGE(-1, 1) or RANGE(0, 2 * kPi), which are evaluated
+// rather than read from their literals.
+bool EvaluateNumber(const clang::Expr *arg, const clang::ASTContext &context,
+                    double &value) {
+  clang::Expr::EvalResult result;
+  if (arg->isValueDependent() || !arg->EvaluateAsRValue(result, context))
+    return false;
+  if (result.Val.isInt()) {
+    auto &integer = result.Val.getInt();
+    value = integer.roundToDouble(integer.isSigned());
+    return true;
+  }
+  if (result.Val.isFloat()) {
+    auto floating = result.Val.getFloat();
+    bool losesInfo = false;
+    floating.convert(llvm::APFloat::IEEEdouble(),
+                     llvm::APFloat::rmNearestTiesToEven, &losesInfo);
+    value = floating.convertToDouble();
+    return true;
+  }
+  return false;
 }
 
-double ConvertToBaseNumber(llvm::APFloat floating) {
-  SmallVector<char, 32> buffer;
-  floating.toString(buffer);
-  buffer.push_back('\0');
+// Reads an argument of the annotation `attr`, false when it has no value the
+// annotation can use.
+bool ReadAnnotateArg(const clang::Expr *arg, const clang::ASTContext &context,
+                     Attr *attr) {
+  auto name = attr->GetName();
+  if (name.compare(InfoAnnotate::name) == 0) {
+    auto *str = llvm::dyn_cast<StringLiteral>(arg->IgnoreParenImpCasts());
+    if (!str)
+      return false;
+    static_cast<InfoAnnotate *>(attr)->info = str->getString().str();
+    return true;
+  }
 
-  std::string numString(buffer.data());
-  return std::stod(numString);
+  double value = 0.;
+  if (!EvaluateNumber(arg, context, value))
+    return false;
+  if (name.compare(RangeAnnotate::name) == 0)
+    static_cast<RangeAnnotate *>(attr)->SetRange(value);
+  else if (name.compare(StepAnnotate::name) == 0)
+    static_cast<StepAnnotate *>(attr)->step = value;
+  return true;
 }
 
-} // namespace
-
-void Visitor::Visit(clang::Decl *decl) {
-  bool flag = llvm::isa<NamespaceDecl>(decl) ||
-              llvm::isa<CXXRecordDecl>(decl) ||
-              llvm::isa<ClassTemplateDecl>(decl);
+std::string GetUSR(const clang::Decl *decl) {
+  llvm::SmallString<128> usr;
+  // generateUSRForDecl returns true when it fails
+  if (!decl || clang::index::generateUSRForDecl(decl, usr))
+    return "";
+  return usr.str().str();
+}
 
-  if (flag) {
-    m_cxxRecordFinder.TraverseDecl(decl);
+// The record which has to be reflected for a base: the base record itself, or
+// the template of a (dependent) template specialization.
+const clang::Decl *GetBaseRecordDecl(const clang::CXXBaseSpecifier &base) {
+  auto type = base.getType();
+  if (auto *tmpType = type->getAs<TemplateSpecializationType>()) {
+    if (auto *tmp = tmpType->getTemplateName().getAsTemplateDecl())
+      return tmp->getTemplatedDecl();
+  }
+  if (auto *record = type->getAsCXXRecordDecl()) {
+    if (auto *spec = llvm::dyn_cast<ClassTemplateSpecializationDecl>(record))
+      return spec->getSpecializedTemplate()->getTemplatedDecl();
+    return record;
   }
+  return nullptr;
 }
 
-bool CXXRecordFinder::TraverseDecl(clang::Decl *decl) {
-  if (!decl)
-    return true;
-
-  // As a syntax visitor, by default we want to ignore declarations for
-  // implicit declarations (ones not typed explicitly by the user).
-  if (!getDerived().shouldVisitImplicitCode() && decl->isImplicit()) {
-    // Pupil Reflection Tool do not interesting in implicit template type
-    // parameter. Just skip
-    // if (auto *TTPD = dyn_cast<TemplateTypeParmDecl>(D))
-    //  return TraverseTemplateTypeParamDeclConstraints(TTPD);
-    return true;
+void AppendTemplateArg(const clang::TemplateArgument &arg,
+                       const clang::PrintingPolicy &policy,
+                       std::vector<std::string> &args) {
+  switch (arg.getKind()) {
+  case TemplateArgument::Pack:
+    for (auto &elem : arg.pack_elements())
+      AppendTemplateArg(elem, policy, args);
+    break;
+  case TemplateArgument::Type:
+    // the generated code lives in namespace PRefl, so print the fully
+    // qualified canonical type
+    args.push_back(arg.getAsType().getCanonicalType().getAsString(policy));
+    break;
+  default: {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    arg.print(policy, os, /*IncludeType*/ true);
+    args.push_back(os.str());
+    break;
   }
+  }
+}
 
-  switch (decl->getKind()) {
-  case Decl::CXXRecord: {
-    auto cxxRecordDecl = llvm::cast<CXXRecordDecl>(decl);
-    if (!m_records.empty()) {
-      // current CXXRecord is declared inside a class/struct
-      m_namespaces.push_back(m_records.top()->GetName());
-    }
-
-    bool ifContinue = getDerived().TraverseCXXRecordDecl(cxxRecordDecl);
+std::vector<std::string>
+GetTemplateArgs(const clang::ClassTemplateSpecializationDecl *spec) {
+  clang::PrintingPolicy policy(spec->getASTContext().getLangOpts());
+  policy.SuppressTagKeyword = true;
+  policy.FullyQualifiedName = true;
 
-    if (m_records.top()->IsNeedGenerate())
-      m_generator->PushCxxRecord(m_records.top());
-    m_records.pop();
+  std::vector<std::string> args;
+  for (auto &arg : spec->getTemplateArgs().asArray())
+    AppendTemplateArg(arg, policy, args);
+  return args;
+}
 
-    if (!m_records.empty()) {
-      m_namespaces.pop_back();
+// Template parameters of a class template, as names ("T", "Ts...") and
+// declarations ("typename T", "int N", "template <typename> class C").
+void GetTemplateParams(const clang::TemplateParameterList *params,
+                       std::vector<std::string> &names,
+                       std::vector<std::string> &decls) {
+  for (auto *param : *params) {
+    auto name = param->getNameAsString();
+    if (auto *tmp = llvm::dyn_cast<TemplateTypeParmDecl>(param)) {
+      names.push_back(tmp->isParameterPack() ? name + "..." : name);
+      decls.push_back((tmp->isParameterPack() ? "typename... " : "typename ") +
+                      name);
+    } else if (auto *tmp = llvm::dyn_cast<NonTypeTemplateParmDecl>(param)) {
+      auto type = tmp->getType().getAsString();
+      names.push_back(tmp->isParameterPack() ? name + "..." : name);
+      decls.push_back(type + (tmp->isParameterPack() ? "... " : " ") + name);
+    } else if (auto *tmp = llvm::dyn_cast<TemplateTemplateParmDecl>(param)) {
+      std::string tmpDecl;
+      llvm::raw_string_ostream os(tmpDecl);
+      tmp->print(os);
+      os.flush();
+      names.push_back(tmp->isParameterPack() ? name + "..." : name);
+      decls.push_back(tmpDecl);
     }
-
-    if (!ifContinue)
-      return false;
-    break;
   }
-  case Decl::Namespace: {
-    auto nspDecl = llvm::cast<NamespaceDecl>(decl);
-    m_namespaces.push_back(nspDecl->getNameAsString());
-    bool ifContinue = getDerived().TraverseNamespaceDecl(nspDecl);
-    m_namespaces.pop_back();
+}
 
-    if (!ifContinue)
+// 32 bit integers (and enums of them), float, double and bool.
+bool ReadGpuScalar(QualType type, ASTContext &context,
+                   GpuType::EScalar *scalar) {
+  type = type.getCanonicalType();
+  if (auto *enumType = type->getAs<EnumType>()) {
+    type = enumType->getDecl()->getIntegerType();
+    if (type.isNull())
       return false;
-    break;
+    type = type.getCanonicalType();
   }
-  case Decl::TemplateTypeParm: {
-    auto tmpDecl = llvm::cast<TemplateTypeParmDecl>(decl);
-    bool ifContinue = getDerived().TraverseTemplateTypeParmDecl(tmpDecl);
-
-    if (!ifContinue)
-      return false;
+  auto *builtin = type->getAs<BuiltinType>();
+  if (!builtin)
+    return false;
+  switch (builtin->getKind()) {
+  case BuiltinType::Float:
+    *scalar = GpuType::EScalar::Float;
+    return true;
+  case BuiltinType::Double:
+    *scalar = GpuType::EScalar::Double;
+    return true;
+  case BuiltinType::Bool:
+    *scalar = GpuType::EScalar::Bool;
+    return true;
+  default:
     break;
   }
-#define ABSTRACT_DECL(DECL)
-#define DECL(CLASS, BASE)                                                      \
-  case Decl::CLASS: {                                                          \
-    bool ifContinue =                                                          \
-        getDerived().Traverse##CLASS##Decl(static_cast<CLASS##Decl *>(decl));  \
-    m_templates.clear();                                                       \
-    if (!ifContinue)                                                           \
-      return false;                                                            \
-    break;                                                                     \
+  if (!builtin->isInteger() || context.getTypeSize(type) != 32)
+    return false;
+  *scalar = builtin->isSignedInteger() ? GpuType::EScalar::Int
+                                       : GpuType::EScalar::UInt;
+  return true;
+}
+
+// Public non-static data members of a plain record, the first member of
+// anonymous unions (glm declares `union { T x, r, s; }`). Empty when the
+// record has bases, virtual functions, bit fields or non-public members.
+std::vector<const FieldDecl *> GetPlainFields(const RecordDecl *decl) {
+  std::vector<const FieldDecl *> fields;
+  auto *cxxDecl = llvm::dyn_cast<CXXRecordDecl>(decl);
+  if (!decl->isCompleteDefinition() || decl->isInvalidDecl() ||
+      decl->isDependentType() || decl->isUnion() ||
+      (cxxDecl && (cxxDecl->getNumBases() != 0 || cxxDecl->isPolymorphic())))
+    return {};
+  for (auto *field : decl->fields()) {
+    if (field->isBitField() ||
+        (field->getAccess() != AS_public && field->getAccess() != AS_none))
+      return {};
+    if (field->isAnonymousStructOrUnion()) {
+      auto *inner = field->getType()->getAsRecordDecl();
+      if (!inner || !inner->isUnion() || inner->field_empty())
+        return {};
+      fields.push_back(*inner->field_begin());
+    } else {
+      fields.push_back(field);
+    }
   }
-#include "PDeclNodes.inc"
+  return fields;
+}
+
+// A vector of 2 to 4 components: fields named x, y, z(, w) or r, g, b(, a)
+// of one scalar type, without padding.
+bool ReadGpuVector(const RecordDecl *decl, ASTContext &context, GpuType *gpu) {
+  auto fields = GetPlainFields(decl);
+  if (fields.size() < 2 || fields.size() > 4)
+    return false;
+  GpuType::EScalar scalar;
+  bool match = false;
+  for (auto *names : {"xyzw", "rgba"}) {
+    match = true;
+    for (size_t i = 0; match && i < fields.size(); ++i) {
+      GpuType::EScalar component;
+      match = fields[i]->getName() == llvm::StringRef(names + i, 1) &&
+              ReadGpuScalar(fields[i]->getType(), context, &component) &&
+              (i == 0 || component == scalar);
+      scalar = component;
+    }
+    if (match)
+      break;
   }
+  if (!match)
+    return false;
+  auto scalarSize = context.getTypeSizeInChars(fields[0]->getType());
+  if (context.getTypeSizeInChars(context.getRecordType(decl)) !=
+      scalarSize * static_cast<int64_t>(fields.size()))
+    return false;
+  gpu->kind = GpuType::EKind::Scalar;
+  gpu->scalar = scalar;
+  gpu->rows = static_cast<uint32_t>(fields.size());
   return true;
 }
 
-bool CXXRecordFinder::VisitTemplateTypeParmDecl(
-    clang::TemplateTypeParmDecl *decl) {
-  m_templates.push_back(decl->getNameAsString());
+// A matrix of 2 to 4 columns: a single array of vectors, or a single two
+// dimensional array of scalars, m[column][row].
+bool ReadGpuMatrix(const RecordDecl *decl, ASTContext &context, GpuType *gpu) {
+  auto fields = GetPlainFields(decl);
+  if (fields.size() != 1)
+    return false;
+  auto *array = context.getAsConstantArrayType(fields[0]->getType());
+  if (!array)
+    return false;
+  GpuType column;
+  auto element = array->getElementType();
+  if (auto *rows = context.getAsConstantArrayType(element)) {
+    auto count = rows->getSize().getZExtValue();
+    if (count < 2 || count > 4 ||
+        !ReadGpuScalar(rows->getElementType(), context, &column.scalar))
+      return false;
+    column.rows = static_cast<uint32_t>(count);
+  } else if (auto *vector = element->getAsRecordDecl()) {
+    if (!ReadGpuVector(vector, context, &column))
+      return false;
+  } else {
+    return false;
+  }
+  auto columns = array->getSize().getZExtValue();
+  if (columns < 2 || columns > 4 || column.scalar == GpuType::EScalar::Bool)
+    return false;
+  gpu->kind = GpuType::EKind::Scalar;
+  gpu->scalar = column.scalar;
+  gpu->rows = column.rows;
+  gpu->columns = static_cast<uint32_t>(columns);
   return true;
 }
 
-bool CXXRecordFinder::VisitCXXRecordDecl(clang::CXXRecordDecl *decl) {
-  ECxxRecordType declType = ECxxRecordType::None;
-  if (decl->isClass())
-    declType = ECxxRecordType::Class;
-  else if (decl->isStruct())
-    declType = ECxxRecordType::Struct;
-
-  auto record = std::make_unique<CxxRecord>(
-      decl->getNameAsString(), m_namespaces, m_templates,
-      HasAnnotate(decl, MetaAnnotate::name), declType);
+// Shape of `type` in a GPU buffer, kind None when it has none. Arrays have
+// one dimension, their elements are scalars, vectors, matrices or structs of
+// them.
+void ReadGpuType(QualType type, ASTContext &context, GpuType *gpu) {
+  if (type->isDependentType() || type->isIncompleteType() ||
+      type->isReferenceType())
+    return;
+  gpu->cpuSize = context.getTypeSizeInChars(type).getQuantity();
+  if (auto *array = context.getAsConstantArrayType(type)) {
+    GpuType element;
+    ReadGpuType(array->getElementType(), context, &element);
+    if (element.kind == GpuType::EKind::None || element.count != 0)
+      return;
+    auto count = array->getSize().getZExtValue();
+    if (count == 0)
+      return;
+    auto cpuSize = gpu->cpuSize;
+    *gpu = std::move(element);
+    gpu->count = static_cast<uint32_t>(count);
+    gpu->cpuSize = cpuSize;
+    return;
+  }
+  if (ReadGpuScalar(type, context, &gpu->scalar)) {
+    gpu->kind = GpuType::EKind::Scalar;
+    return;
+  }
+  auto *decl = type->getAsRecordDecl();
+  if (!decl)
+    return;
+  if (ReadGpuVector(decl, context, gpu) || ReadGpuMatrix(decl, context, gpu))
+    return;
+
+  auto fields = GetPlainFields(decl);
+  if (fields.empty())
+    return;
+  const auto &layout = context.getASTRecordLayout(decl);
+  std::vector<GpuMember> members;
+  for (auto *field : decl->fields()) {
+    // members of anonymous unions have no place of their own
+    if (field->isAnonymousStructOrUnion())
+      return;
+    auto &member = members.emplace_back();
+    member.name = field->getNameAsString();
+    member.cpuOffset = context
+                           .toCharUnitsFromBits(
+                               layout.getFieldOffset(field->getFieldIndex()))
+                           .getQuantity();
+    ReadGpuType(field->getType(), context, &member.type);
+    if (member.type.kind == GpuType::EKind::None)
+      return;
+  }
+  gpu->members = std::move(members);
+  gpu->kind = GpuType::EKind::Struct;
+}
 
-  for (auto it = decl->bases_begin(); it != decl->bases_end(); ++it) {
-    auto base = *it;
-    if (base.getAccessSpecifier() == AS_public) {
-      record->AddBase(base.getType().getAsString());
-    }
+// Whether `type`, or the type of one of its bases or fields, is declared in a
+// stub header.
+bool IsDeclaredByStubs(QualType type, const SourceManager &sm) {
+  auto *decl = type->getBaseElementTypeUnsafe()->getAsTagDecl();
+  if (!decl)
+    return false;
+  if (StubOverlay::IsStubFile(
+          sm.getFilename(sm.getSpellingLoc(decl->getLocation()))))
+    return true;
+  auto *record = llvm::dyn_cast<CXXRecordDecl>(decl);
+  if (!record || !record->hasDefinition())
+    return false;
+  record = record->getDefinition();
+  for (auto &base : record->bases()) {
+    if (IsDeclaredByStubs(base.getType(), sm))
+      return true;
   }
+  for (auto *field : record->fields()) {
+    if (IsDeclaredByStubs(field->getType(), sm))
+      return true;
+  }
+  return false;
+}
+} // namespace
 
-  m_records.push(std::move(record));
-  // template parameters must reset for the next CXXRecord
-  m_templates.clear();
+void Visitor::Visit(clang::Decl *decl, PReflTool::Generator *g) {
+  m_generator = g;
+  m_targetFile = m_sm.getFileID(decl->getLocation());
+  m_namespaces.clear();
+  VisitDecl(decl, nullptr);
+}
 
-  // deep into record to find fields
-  m_cxxRecordVisitor.SetCxxRecord(m_records.top().get());
-  m_cxxRecordVisitor.TraverseDecl(decl);
-  return true;
+void Visitor::VisitContext(clang::DeclContext *context, CxxRecord *record) {
+  for (auto *decl : context->decls())
+    VisitDecl(decl, record);
 }
 
-bool CXXRecordVisitor::TraverseDecl(clang::Decl *decl) {
-  if (!decl)
-    return true;
+// `record` is the record the declaration is a member of, or nullptr.
+void Visitor::VisitDecl(clang::Decl *decl, CxxRecord *record) {
+  // implicit declarations (e.g. the injected class name) are not written by
+  // the user
+  if (decl->isImplicit())
+    return;
 
   switch (decl->getKind()) {
-  case Decl::Namespace:          // no namespace
-  case Decl::TemplateTypeParm: { // skip template
+  case Decl::Namespace: {
+    m_namespaces.push_back(llvm::cast<NamespaceDecl>(decl)->getNameAsString());
+    VisitContext(llvm::cast<NamespaceDecl>(decl), nullptr);
+    m_namespaces.pop_back();
     break;
   }
-  case Decl::CXXRecord: // skip cxxRecord(skip fields which belong to internal
-                        // classes)
-  {
-    if (!m_entered) {
-      m_entered = true;
-      bool ifContinue = getDerived().TraverseCXXRecordDecl(
-          static_cast<CXXRecordDecl *>(decl));
-      if (!ifContinue)
-        return false;
-    }
+  case Decl::LinkageSpec: // extern "C++" { ... }
+  case Decl::Export:
+    VisitContext(llvm::cast<DeclContext>(decl), record);
+    break;
+  case Decl::CXXRecord:
+    VisitRecord(llvm::cast<CXXRecordDecl>(decl), nullptr, record != nullptr);
+    break;
+  case Decl::ClassTemplate: {
+    auto *tmp = llvm::cast<ClassTemplateDecl>(decl);
+    VisitRecord(tmp->getTemplatedDecl(), tmp->getTemplateParameters(),
+                record != nullptr);
     break;
   }
-#define ABSTRACT_DECL(DECL)
-#define DECL(CLASS, BASE)                                                      \
-  case Decl::CLASS: {                                                          \
-    bool ifContinue =                                                          \
-        getDerived().Traverse##CLASS##Decl(static_cast<CLASS##Decl *>(decl));  \
-    if (!ifContinue)                                                           \
-      return false;                                                            \
-    break;                                                                     \
-  }
-#include "PDeclNodes.inc"
-  }
-  return true;
-}
-
-bool CXXRecordVisitor::VisitAccessSpecDecl(clang::AccessSpecDecl *decl) {
-  auto access = decl->getAccess();
-  EAccessPermission perm = EAccessPermission::Private;
-  switch (access) {
-  case clang::AS_public:
-    perm = EAccessPermission::Public;
+  case Decl::Enum:
+    VisitEnum(llvm::cast<EnumDecl>(decl));
     break;
-  case clang::AS_protected:
-    perm = EAccessPermission::Protected;
+  case Decl::AccessSpec:
+    if (record) {
+      EAccessPermission perm = EAccessPermission::Private;
+      switch (decl->getAccess()) {
+      case clang::AS_public:
+        perm = EAccessPermission::Public;
+        break;
+      case clang::AS_protected:
+        perm = EAccessPermission::Protected;
+        break;
+      case clang::AS_private:
+      case clang::AS_none:
+      default:
+        break;
+      }
+      record->SetCurrentAccessPermission(perm);
+    }
+    break;
+  case Decl::Field:
+    if (record)
+      VisitField(llvm::cast<FieldDecl>(decl), record, false);
+    break;
+  case Decl::Var: // [constexpr] static members
+    if (record)
+      VisitField(llvm::cast<VarDecl>(decl), record, true);
+    break;
+  case Decl::CXXMethod:
+    if (record)
+      VisitMethod(llvm::cast<CXXMethodDecl>(decl), record);
     break;
-  case clang::AS_private:
-  case clang::AS_none:
   default:
+    // explicit and partial specializations, functions, member templates,
+    // aliases, ... are not reflected and contain nothing reflected
     break;
   }
-  m_record->SetCurrentAccessPermission(perm);
-  return true;
 }
 
-bool CXXRecordVisitor::VisitFieldDecl(clang::FieldDecl *decl) {
-  // only store parameters with meta annotation and in public permission
-  if (HasAnnotate(decl, MetaAnnotate::name) &&
-      m_record->IsCurrentFieldPublic()) {
-    auto field = std::make_unique<Field>();
-    field->name = decl->getNameAsString();
+void Visitor::VisitRecord(clang::CXXRecordDecl *decl,
+                          clang::TemplateParameterList *params,
+                          bool isNested) {
+  // forward declarations and redeclarations have nothing to reflect
+  if (!decl->isThisDeclarationADefinition())
+    return;
+
+  ECxxRecordType declType = ECxxRecordType::None;
+  if (decl->isClass())
+    declType = ECxxRecordType::Class;
+  else if (decl->isStruct())
+    declType = ECxxRecordType::Struct;
+
+  std::vector<std::string> templates;
+  std::vector<std::string> templateDecls;
+  if (params)
+    GetTemplateParams(params, templates, templateDecls);
 
-    m_attrVisitor.SetField(field.get());
-    m_attrVisitor.TraverseFieldDecl(decl);
+  auto record = std::make_unique<CxxRecord>(
+      decl->getNameAsString(), m_namespaces, templates,
+      HasAnnotate(decl, MetaAnnotate::name), declType);
 
-    m_record->PushField(field);
+  for (auto it = decl->bases_begin(); it != decl->bases_end(); ++it) {
+    auto base = *it;
+    if (base.getAccessSpecifier() == AS_public) {
+      record->AddBase(base.getType().getAsString(),
+                      GetUSR(GetBaseRecordDecl(base)));
+    }
+  }
+  record->SetUSR(GetUSR(decl));
+  record->SetGenerateSoA(HasAnnotate(decl, SoAAnnotate::name));
+  record->SetNested(isNested);
+  record->SetTemplateDecls(templateDecls);
+
+  // concrete specializations used by the target file get their own full
+  // specialization, so consumers do not instantiate them again
+  if (auto *tmp = decl->getDescribedClassTemplate()) {
+    for (auto *spec : tmp->specializations()) {
+      auto kind = spec->getSpecializationKind();
+      // explicit specializations are records of their own
+      if (kind == TSK_Undeclared || kind == TSK_ExplicitSpecialization)
+        continue;
+      auto loc = m_sm.getExpansionLoc(spec->getPointOfInstantiation());
+      if (loc.isInvalid() || m_sm.getFileID(loc) != m_targetFile)
+        continue;
+      record->AddSpecialization(GetTemplateArgs(spec));
+    }
   }
 
-  return true;
+  // members, including the nested records which are named with this record
+  // as scope
+  m_namespaces.push_back(record->GetName());
+  VisitContext(decl, record.get());
+  m_namespaces.pop_back();
+
+  // nested records are pushed before their outer record. A record nested in
+  // a class template can only be named through its parameters, which the
+  // generated code does not have
+  if (record->IsNeedGenerate() && !decl->getDeclContext()->isDependentContext())
+    m_generator->PushCxxRecord(record);
 }
 
-/* FIXME: need to filter VarDecl under Stmt
-* void fun(){
-*   int a; <- also is a VarDecl
-* }
-*/
-bool CXXRecordVisitor::VisitVarDecl(clang::VarDecl *decl) {
-  // same as field
-  // to solve [constexpr] static members
-  if (HasAnnotate(decl, MetaAnnotate::name) &&
-      m_record->IsCurrentFieldPublic()) {
-    auto field = std::make_unique<Field>();
-    field->name = decl->getNameAsString();
-
-    m_attrVisitor.SetField(field.get());
-    m_attrVisitor.TraverseVarDecl(decl);
-
-    m_record->PushField(field);
+void Visitor::VisitEnum(clang::EnumDecl *decl) {
+  if (!HasAnnotate(decl, MetaAnnotate::name) ||
+      !decl->isThisDeclarationADefinition() || decl->enumerator_empty() ||
+      decl->getName().empty() || decl->getParentFunctionOrMethod())
+    return;
+  // enums of class templates can not be named without template arguments,
+  // and non-public member enums can not be named at all
+  if (decl->isDependentContext() ||
+      (decl->getAccess() != AS_public && decl->getAccess() != AS_none))
+    return;
+
+  bool isSigned = decl->getIntegerType()->isSignedIntegerOrEnumerationType();
+  auto cxxEnum = std::make_unique<CxxEnum>(decl->getNameAsString(),
+                                           m_namespaces, isSigned);
+  cxxEnum->SetUSR(GetUSR(decl));
+  for (auto *enumerator : decl->enumerators()) {
+    auto &value = enumerator->getInitVal();
+    cxxEnum->PushEnumerator(enumerator->getNameAsString(),
+                            value.isSigned()
+                                ? static_cast<uint64_t>(value.getExtValue())
+                                : value.getZExtValue());
   }
-  return true;
+  m_generator->PushCxxEnum(cxxEnum);
 }
 
-bool AttributeVisitor::VisitAnnotateAttr(clang::AnnotateAttr *an) {
-  auto anName = an->getAnnotation();
-  if (anName.equals(RangeAnnotate::name)) {
-    auto pRange = std::make_unique<RangeAnnotate>();
-    m_annotateValueGetter.SetAttr(pRange.get());
-    m_annotateValueGetter.TraverseAnnotateAttr(an);
-
-    m_field->attrs.emplace_back(std::move(pRange));
-  } else if (anName.equals(InfoAnnotate::name)) {
-    auto pInfo = std::make_unique<InfoAnnotate>();
-    m_annotateValueGetter.SetAttr(pInfo.get());
-    m_annotateValueGetter.TraverseAnnotateAttr(an);
-
-    m_field->attrs.emplace_back(std::move(pInfo));
-  } else if (anName.equals(StepAnnotate::name)) {
-    auto pStep = std::make_unique<StepAnnotate>();
-    m_annotateValueGetter.SetAttr(pStep.get());
-    m_annotateValueGetter.TraverseAnnotateAttr(an);
-
-    m_field->attrs.emplace_back(std::move(pStep));
-  }
-  return true;
+void Visitor::VisitField(clang::DeclaratorDecl *decl, CxxRecord *record,
+                         bool isStatic) {
+  // only store parameters with meta annotation and in public permission
+  if (!HasAnnotate(decl, MetaAnnotate::name) ||
+      !record->IsCurrentFieldPublic())
+    return;
+
+  auto field = std::make_unique<Field>();
+  field->name = decl->getNameAsString();
+  field->isStatic = isStatic;
+  if (!isStatic)
+    ReadLayout(llvm::cast<FieldDecl>(decl), field.get());
+  ReadAttributes(decl, field.get());
+  record->PushField(field);
 }
 
-//bool RangeAnnotateVisitor::VisitConstantExpr(clang::ConstantExpr *ce) {
-//  auto t = ce->getType();
-//  if (t.getAsString() == "double" || t.getAsString() == "float") {
-//    SmallVector<char, 32> buffer;
-//    ce->getAPValueResult().getFloat().toString(buffer);
-//    buffer.push_back('\0');
-//
-//    std::string numString(buffer.data());
-//    double num = std::stod(numString);
-//    m_rangeAnnotate->SetRange(num);
-//  } else {
-//    SmallVector<char, 32> buffer;
-//    ce->getAPValueResult().getInt().toString(buffer);
-//    buffer.push_back('\0');
-//
-//    std::string numString(buffer.data());
-//    int num = std::stoi(numString);
-//    m_rangeAnnotate->SetRange(num);
-//  }
-//  return true;
-//}
-
-bool AnnotateValueGetter::VisitStringLiteral(clang::StringLiteral *str) {
-  if (!m_attr)
-    return true;
-
-  if (m_attr->GetName().compare(InfoAnnotate::name) == 0) {
-    auto *attr = static_cast<InfoAnnotate *>(m_attr);
-    attr->info = str->getString().str();
-  }
-  return true;
+void Visitor::ReadLayout(clang::FieldDecl *decl, Field *field) {
+  auto *parent = decl->getParent();
+  auto type = decl->getType();
+  if (parent->isDependentType() || parent->isInvalidDecl() ||
+      type->isDependentType() || decl->isBitField())
+    return;
+
+  auto &context = decl->getASTContext();
+  const auto &layout = context.getASTRecordLayout(parent);
+  field->offset = context.toCharUnitsFromBits(
+                             layout.getFieldOffset(decl->getFieldIndex()))
+                      .getQuantity();
+  field->size = context.getTypeSizeInChars(type).getQuantity();
+
+  // floating point values are hashed and compared by their bits as well,
+  // unless they have padding (x87 long double)
+  auto *element = type->getBaseElementTypeUnsafe();
+  bool isUnpaddedFloat =
+      element->isRealFloatingType() &&
+      context.getTypeSize(element) ==
+          llvm::APFloat::getSizeInBits(
+              context.getFloatTypeSemantics(QualType(element, 0)));
+  // the layout of a stub is not the one of the real type
+  field->isPlainBytes =
+      !type->isReferenceType() && type.isTriviallyCopyableType(context) &&
+      (context.hasUniqueObjectRepresentations(type) || isUnpaddedFloat) &&
+      !IsDeclaredByStubs(type, m_sm);
+  ReadGpuType(type, context, &field->gpu);
 }
 
-bool AnnotateValueGetter::VisitIntegerLiteral(clang::IntegerLiteral *integer) {
-  if (!m_attr)
-    return true;
-
-  if (m_attr->GetName().compare(RangeAnnotate::name) == 0) {
-    auto *attr = static_cast<RangeAnnotate *>(m_attr);
-    attr->SetRange(ConvertToBaseNumber(integer->getValue()));
-  } else if (m_attr->GetName().compare(StepAnnotate::name) == 0) {
-    auto *attr = static_cast<StepAnnotate *>(m_attr);
-    attr->step = ConvertToBaseNumber(integer->getValue());
-  }
-  return true;
+void Visitor::VisitMethod(clang::CXXMethodDecl *decl, CxxRecord *record) {
+  if (!HasAnnotate(decl, MetaAnnotate::name) ||
+      !record->IsCurrentFieldPublic())
+    return;
+  // only methods which can be called by name with a known signature,
+  // constructors, destructors and conversions have kinds of their own and
+  // member templates are FunctionTemplateDecls
+  if (decl->isOverloadedOperator() ||
+      decl->getReturnType()->getContainedDeducedType())
+    return;
+
+  // the generated code lives in namespace PRefl, so aliases and nested types
+  // of the user namespaces and records are printed fully qualified
+  auto &context = decl->getASTContext();
+  clang::PrintingPolicy policy(context.getLangOpts());
+  policy.SuppressTagKeyword = true;
+  auto typeName = [&](QualType type) {
+    return clang::TypeName::getFullyQualifiedName(type, context, policy);
+  };
+
+  Method method;
+  method.name = decl->getNameAsString();
+  method.returnType = typeName(decl->getReturnType());
+  method.isConst = decl->isConst();
+  method.isStatic = decl->isStatic();
+  for (auto *param : decl->parameters())
+    method.params.push_back({typeName(param->getType()),
+                             param->getNameAsString()});
+  record->PushMethod(std::move(method));
 }
 
-bool AnnotateValueGetter::VisitFloatingLiteral(clang::FloatingLiteral *floating) {
-  if (!m_attr)
-    return true;
-
-  if (m_attr->GetName().compare(RangeAnnotate::name) == 0) {
-    auto *attr = static_cast<RangeAnnotate *>(m_attr);
-    attr->SetRange(ConvertToBaseNumber(floating->getValue()));
-  } else if (m_attr->GetName().compare(StepAnnotate::name) == 0) {
-    auto *attr = static_cast<StepAnnotate *>(m_attr);
-    attr->step = ConvertToBaseNumber(floating->getValue());
+// An argument without a constant value is a parse error of the target, so
+// its records are neither generated nor cached.
+void Visitor::ReadAttributes(clang::Decl *decl, Field *field) {
+  auto &context = decl->getASTContext();
+  auto &diags = context.getDiagnostics();
+  for (auto *an : decl->specific_attrs<AnnotateAttr>()) {
+    auto anName = an->getAnnotation();
+    std::unique_ptr<Attr> attr;
+    if (anName.equals(RangeAnnotate::name))
+      attr = std::make_unique<RangeAnnotate>();
+    else if (anName.equals(InfoAnnotate::name))
+      attr = std::make_unique<InfoAnnotate>();
+    else if (anName.equals(StepAnnotate::name))
+      attr = std::make_unique<StepAnnotate>();
+    else
+      continue;
+
+    bool valid = true;
+    unsigned index = 0;
+    for (auto *arg : an->args()) {
+      ++index;
+      if (ReadAnnotateArg(arg, context, attr.get()))
+        continue;
+      unsigned id = diags.getCustomDiagID(
+          clang::DiagnosticsEngine::Error,
+          "argument %0 of annotation '%1' is not a constant %2");
+      diags.Report(arg->getExprLoc(), id)
+          << index << anName
+          << (anName.equals(InfoAnnotate::name) ? "string" : "number");
+      valid = false;
+    }
+    if (valid)
+      field->attrs.emplace_back(std::move(attr));
   }
-  return true;
 }
 
 } // namespace PReflTool
\ No newline at end of file
@@ -4,96 +4,46 @@
 
 #include "Generator.h"
 
-#include <stack>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace PReflTool {
 
-class AnnotateValueGetter
-    : public clang::RecursiveASTVisitor<AnnotateValueGetter> {
-  Attr *m_attr;
-
-public:
-  AnnotateValueGetter() : m_attr(nullptr) {}
-  void SetAttr(Attr *attr) { m_attr = attr; }
-
-  bool VisitStringLiteral(clang::StringLiteral *str);
-  bool VisitIntegerLiteral(clang::IntegerLiteral *integer);
-  bool VisitFloatingLiteral(clang::FloatingLiteral *floating);
-};
-
-// used to get the parameters of annotate::range(min, max)
-//class RangeAnnotateVisitor
-//    : public clang::RecursiveASTVisitor<RangeAnnotateVisitor> {
-//  RangeAnnotate *m_rangeAnnotate;
-//
-//public:
-//  RangeAnnotateVisitor() : m_rangeAnnotate(nullptr) {}
-//  void SetRangeAnnotate(RangeAnnotate *rangeAnnotate) {
-//    m_rangeAnnotate = rangeAnnotate;
-//  }
-//  bool VisitConstantExpr(clang::ConstantExpr *ce);
-//};
-
-class AttributeVisitor : public clang::RecursiveASTVisitor<AttributeVisitor> {
-  AnnotateValueGetter m_annotateValueGetter;
-  Field *m_field;
-
-public:
-  AttributeVisitor() : m_field(nullptr) {}
-  void SetField(Field *field) { m_field = field; }
-  bool VisitAnnotateAttr(clang::AnnotateAttr *an);
-};
-
-// used to traverse cxx record to get the information of fields/inheritance
-class CXXRecordVisitor : public clang::RecursiveASTVisitor<CXXRecordVisitor> {
-  AttributeVisitor m_attrVisitor;
-
-  CxxRecord *m_record;
-
-  bool m_entered;
-
-public:
-  CXXRecordVisitor(CxxRecord *record = nullptr)
-      : m_record(record), m_attrVisitor(), m_entered(false) {}
-
-  void SetCxxRecord(CxxRecord *record) {
-    m_record = record;
-    m_entered = false;
-  }
-
-  bool VisitFieldDecl(clang::FieldDecl *decl);
-  bool VisitVarDecl(clang::VarDecl *decl);
-  bool VisitAccessSpecDecl(clang::AccessSpecDecl *decl);
-  bool TraverseDecl(clang::Decl *decl);
-};
-
-// used to find cxx records (with namespaces and templates)
-class CXXRecordFinder : public clang::RecursiveASTVisitor<CXXRecordFinder> {
-  CXXRecordVisitor m_cxxRecordVisitor;
+// Collects the reflected records and enums of a target file in one walk over
+// the declaration contexts: namespaces, records and the member declarations of
+// records. Function bodies, initializers and all other declarations can not
+// contain reflected declarations and are never entered, so every declaration
+// is visited at most once whatever the nesting depth.
+class Visitor {
+  clang::SourceManager &m_sm;
   PReflTool::Generator *m_generator;
+  // file of the declarations being visited, several target headers may be
+  // parsed in one translation unit
+  clang::FileID m_targetFile;
+  // namespaces and outer records of the current declaration
   std::vector<std::string> m_namespaces;
-  std::vector<std::string> m_templates;
 
-  std::stack<std::unique_ptr<CxxRecord>> m_records;
-
-public:
-  CXXRecordFinder(PReflTool::Generator *g) : m_generator(g) {}
-  bool VisitCXXRecordDecl(clang::CXXRecordDecl *decl);
-  bool VisitTemplateTypeParmDecl(clang::TemplateTypeParmDecl *decl);
-  bool TraverseDecl(clang::Decl *decl);
-};
-
-class Visitor {
-  CXXRecordFinder m_cxxRecordFinder;
-  clang::SourceManager &m_sm;
+  void VisitContext(clang::DeclContext *context, CxxRecord *record);
+  void VisitDecl(clang::Decl *decl, CxxRecord *record);
+  void VisitRecord(clang::CXXRecordDecl *decl,
+                   clang::TemplateParameterList *params, bool isNested);
+  void VisitEnum(clang::EnumDecl *decl);
+  void VisitField(clang::DeclaratorDecl *decl, CxxRecord *record,
+                  bool isStatic);
+  void VisitMethod(clang::CXXMethodDecl *decl, CxxRecord *record);
+  void ReadAttributes(clang::Decl *decl, Field *field);
+  // offset, size, plain bytes and GPU shape of a non-static field from the
+  // clang layout
+  void ReadLayout(clang::FieldDecl *decl, Field *field);
 
 public:
-  Visitor(clang::SourceManager &sm, PReflTool::Generator *g)
-      : m_sm(sm), m_cxxRecordFinder(g) {}
+  Visitor(clang::SourceManager &sm) : m_sm(sm), m_generator(nullptr) {}
 
   clang::SourceManager &GetSourceManager() const { return m_sm; }
 
-  void Visit(clang::Decl *decl);
+  // Extract the records of a top level declaration of the target file of
+  // generator g.
+  void Visit(clang::Decl *decl, PReflTool::Generator *g);
 };
 } // namespace PReflTool
\ No newline at end of file
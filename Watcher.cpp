@@ -0,0 +1,96 @@
+#include "Watcher.h"
+#include "ProjectIndex.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace PReflTool;
+
+Watcher::Watcher(unsigned debounceMs) : m_debounceMs(debounceMs) {
+#if defined(__linux__)
+  m_fd = inotify_init1(IN_CLOEXEC);
+#endif
+}
+
+Watcher::~Watcher() {
+#if defined(__linux__)
+  if (m_fd >= 0)
+    close(m_fd);
+#endif
+}
+
+bool Watcher::Watch(const std::filesystem::path &file) {
+  if (!IsSupported())
+    return false;
+
+  auto normalized = ProjectIndex::NormalizePath(file);
+  if (!m_files.insert(normalized).second)
+    return true;
+
+#if defined(__linux__)
+  auto dir = std::filesystem::path{normalized}.parent_path().generic_string();
+  int wd = inotify_add_watch(m_fd, dir.c_str(),
+                             IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (wd < 0)
+    return false;
+  m_dirs[wd] = dir;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool Watcher::Wait(Batch &batch) {
+  batch.files.clear();
+  if (!IsSupported())
+    return false;
+
+#if defined(__linux__)
+  std::set<std::string> modified;
+  alignas(inotify_event) char buffer[16 * 1024];
+  while (true) {
+    // block until the first event, then wait for the burst to settle
+    pollfd pfd{m_fd, POLLIN, 0};
+    int timeout = modified.empty() ? -1 : static_cast<int>(m_debounceMs);
+    int ready = poll(&pfd, 1, timeout);
+    if (ready < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (ready == 0)
+      break;
+
+    auto len = read(m_fd, buffer, sizeof(buffer));
+    if (len <= 0) {
+      if (len < 0 && errno == EINTR)
+        continue;
+      return false;
+    }
+
+    auto now = Clock::now();
+    for (char *ptr = buffer; ptr < buffer + len;) {
+      auto *event = reinterpret_cast<inotify_event *>(ptr);
+      ptr += sizeof(inotify_event) + event->len;
+
+      auto dir = m_dirs.find(event->wd);
+      if (event->len == 0 || dir == m_dirs.end())
+        continue;
+      auto file = dir->second + "/" + event->name;
+      if (m_files.count(file) == 0)
+        continue;
+      if (modified.empty())
+        batch.firstEvent = now;
+      modified.insert(file);
+    }
+  }
+  batch.files.assign(modified.begin(), modified.end());
+  return true;
+#else
+  return false;
+#endif
+}
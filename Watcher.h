@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace PReflTool {
+
+// Watch headers for modifications (inotify, only available on Linux).
+// The parent directories are watched instead of the files themselves, since
+// most editors save by writing a temporary file and renaming it.
+class Watcher {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Batch {
+    // normalized paths of the modified files
+    std::vector<std::string> files;
+    // time of the first event of the batch
+    Clock::time_point firstEvent;
+  };
+
+private:
+  unsigned m_debounceMs;
+  int m_fd = -1;
+  // watch descriptor -> directory
+  std::map<int, std::string> m_dirs;
+  std::set<std::string> m_files;
+
+public:
+  explicit Watcher(unsigned debounceMs = 100);
+  ~Watcher();
+
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+
+  bool IsSupported() const { return m_fd >= 0; }
+
+  bool Watch(const std::filesystem::path &file);
+
+  // Block until watched files are modified. Events are collected until no
+  // new one arrives during the debounce interval, so one save (often several
+  // writes and a rename) gives one batch. Return false on error.
+  bool Wait(Batch &batch);
+};
+} // namespace PReflTool
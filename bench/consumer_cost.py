@@ -0,0 +1,187 @@
+"""Compile cost of the generated code for the TUs which use it.
+
+Usage: python consumer_cost.py <PupilReflTool> --runtime <header>
+           [--cxx <compiler>] [--ops <header>] [--records N ...] [--fields N]
+           [--names template|pooled|both]
+
+For each corpus mode and size, a header with N reflected records is
+generated, PupilReflTool writes its .gen.inl, and a consumer TU which calls
+PReflBench::Use<T>() (consumer_ops.h, or --ops) for every record is compiled
+with the host compiler. The consumer is also compiled without the generated
+file as baseline. Compile time, peak compiler memory (Linux and macOS) and
+object size are printed for both, with the number of class template
+instantiations the generated file adds (GCC and clang).
+
+--names chooses how fields and attributes are named: one Name<"..."> class
+template instantiation each (template, the default) or an index into one
+character table per record (pooled, PupilReflTool --pooled-names).
+
+--runtime is the header of the PupilReflect runtime (ReflData, FieldArray,
+...); runtime/ of this repository is added to the include paths.
+
+Modes:
+  fields      META fields only
+  attributes  fields with RANGE, STEP and INFO (adds the batch kernels)
+  bases       each record derives from the previous one
+  methods     fields and META methods (adds the invoker tables)
+  soa         fields of records annotated with SOA (adds SoA<T>)
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+MODES = ["fields", "attributes", "bases", "methods", "soa"]
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+RUNTIME_DIR = os.path.join(os.path.dirname(BENCH_DIR), "runtime")
+
+
+def write_corpus(path, mode, records, fields):
+    lines = ["#pragma once", "#include <cstdint>", "", "namespace Corpus {"]
+    for r in range(records):
+        annotation = "META, SOA" if mode == "soa" else "META"
+        base = f" : public R{r - 1}" if mode == "bases" and r > 0 else ""
+        lines.append(f"struct [[{annotation}]] R{r}{base} {{")
+        for f in range(fields):
+            if mode == "attributes":
+                lines.append(f"    [[META, RANGE(0, {f + 1}), STEP(0.5), "
+                             f"INFO(\"field {f}\")]] float r{r}f{f};")
+            else:
+                lines.append(f"    [[META]] float r{r}f{f};")
+        if mode == "methods":
+            lines.append(f"    [[META]] float Sum(float scale) const "
+                         f"{{ return r{r}f0 * scale; }}")
+            lines.append(f"    [[META]] void Reset() {{ r{r}f0 = 0.f; }}")
+        lines.append("};")
+    lines.append("} // namespace Corpus")
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def write_consumer(path, corpus, runtime, ops, records, reflected):
+    lines = [f'#include "{runtime}"']
+    if reflected:
+        stem = os.path.splitext(os.path.basename(corpus))[0]
+        lines += [f'#include "generated/{stem}.gen.inl"', f'#include "{ops}"',
+                  "", "void UseAll() {"]
+        lines += [f"    PReflBench::Use<Corpus::R{r}>();" for r in range(records)]
+        lines.append("}")
+    else:
+        lines += [f'#include "{os.path.basename(corpus)}"']
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def compiler_kind(cxx):
+    if os.path.splitext(os.path.basename(cxx))[0].lower() == "cl":
+        return "msvc"
+    result = subprocess.run([cxx, "--version"], capture_output=True, text=True)
+    return "clang" if "clang" in result.stdout else "gcc"
+
+
+def count_instantiations(kind, obj):
+    """Class template instantiations of the last compile, None if unknown."""
+    if kind == "gcc":
+        # every class laid out by the front end, see -fdump-lang-class
+        with open(obj + ".class") as f:
+            return sum(1 for line in f
+                       if line.startswith("Class ") and "<" in line)
+    if kind == "clang":
+        with open(os.path.splitext(obj)[0] + ".json") as f:
+            events = json.load(f)["traceEvents"]
+        return sum(1 for event in events if event.get("name") == "InstantiateClass")
+    return None
+
+
+def compile_cost(cxx, kind, source, obj):
+    """Seconds, peak memory in MB (None if unknown), object size in KB and
+    class template instantiations (None if unknown)."""
+    include = ["-I", RUNTIME_DIR, "-I", os.path.dirname(source)]
+    if kind == "msvc":
+        cmd = [cxx, "/nologo", "/std:c++20", "/c", source, "/Fo" + obj,
+               "/I", RUNTIME_DIR, "/I", os.path.dirname(source)]
+    else:
+        cmd = [cxx, "-std=c++20", "-O1", "-c", source, "-o", obj, *include]
+        if kind == "gcc":
+            cmd.append(f"-fdump-lang-class={obj}.class")
+        else:
+            cmd += ["-ftime-trace", "-ftime-trace-granularity=0"]
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    peak = None
+    if hasattr(os, "wait4"):
+        _, status, usage = os.wait4(proc.pid, 0)
+        proc.returncode = os.waitstatus_to_exitcode(status)
+        # kilobytes on Linux, bytes on macOS
+        scale = 1 if sys.platform == "darwin" else 1024
+        peak = usage.ru_maxrss * scale / (1024 * 1024)
+        output = proc.stdout.read()
+    else:
+        output, _ = proc.communicate()
+    seconds = time.perf_counter() - start
+    if proc.returncode != 0:
+        sys.exit(f"compiling {source} failed:\n" + output.decode(errors="replace"))
+    return (seconds, peak, os.path.getsize(obj) / 1024,
+            count_instantiations(kind, obj))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("tool")
+    parser.add_argument("--runtime", required=True)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--ops", default=os.path.join(BENCH_DIR, "consumer_ops.h"))
+    parser.add_argument("--records", type=int, nargs="+", default=[16, 64, 256, 1024])
+    parser.add_argument("--fields", type=int, default=8)
+    parser.add_argument("--modes", nargs="+", default=MODES, choices=MODES)
+    parser.add_argument("--names", default="template",
+                        choices=["template", "pooled", "both"])
+    args = parser.parse_args()
+    runtime = os.path.abspath(args.runtime)
+    ops = os.path.abspath(args.ops)
+    kind = compiler_kind(args.cxx)
+    names = ["template", "pooled"] if args.names == "both" else [args.names]
+
+    def mb(value):
+        return f"{value:9.1f}" if value is not None else f"{'n/a':>9}"
+
+    def count(value):
+        return f"{value:9}" if value is not None else f"{'n/a':>9}"
+
+    print(f"{'mode':11} {'names':8} {'records':>7} {'base s':>8} "
+          f"{'base MB':>9} {'refl s':>8} {'refl MB':>9} {'obj KB':>9} "
+          f"{'inst':>9}")
+    with tempfile.TemporaryDirectory() as tmp:
+        for mode in args.modes:
+            for records in args.records:
+                corpus = os.path.join(tmp, "corpus.h")
+                write_corpus(corpus, mode, records, args.fields)
+                source = os.path.join(tmp, "consumer.cpp")
+                obj = os.path.join(tmp, "consumer.o")
+                write_consumer(source, corpus, runtime, ops, records, False)
+                base_s, base_mb, _, base_inst = compile_cost(
+                    args.cxx, kind, source, obj)
+
+                for name_mode in names:
+                    shutil.rmtree(os.path.join(tmp, "generated"),
+                                  ignore_errors=True)
+                    extra = ["--pooled-names"] if name_mode == "pooled" else []
+                    subprocess.run([args.tool, "--no-modify-source",
+                                    "--no-cache", "--force", *extra, corpus],
+                                   check=True, capture_output=True)
+                    write_consumer(source, corpus, runtime, ops, records, True)
+                    refl_s, refl_mb, obj_kb, refl_inst = compile_cost(
+                        args.cxx, kind, source, obj)
+                    inst = (refl_inst - base_inst
+                            if refl_inst is not None else None)
+                    print(f"{mode:11} {name_mode:8} {records:7} {base_s:8.2f} "
+                          f"{mb(base_mb)} {refl_s:8.2f} {mb(refl_mb)} "
+                          f"{obj_kb:9.1f} {count(inst)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,21 @@
+// Operations of the consumer TUs compiled by consumer_cost.py.
+//
+// PReflBench::Use<T>() is instantiated once for every record of the corpus.
+// The default only reads the generated tables, which is what instantiates and
+// evaluates them; pass --ops <header> to measure the iteration helpers of the
+// runtime (e.g. a for-each over the fields and their attributes) instead.
+
+#pragma once
+
+namespace PReflBench {
+// Keep the addresses of the tables, so they are emitted.
+inline const void *volatile g_sink;
+
+template <typename T> void Use() {
+  using Data = PRefl::ReflData<T>;
+  if constexpr (Data::hasData)
+    g_sink = &Data::fields;
+  if constexpr (Data::hasBases)
+    g_sink = &Data::bases;
+}
+} // namespace PReflBench
@@ -0,0 +1,114 @@
+// Cost of a run with nothing to do, per process and in process (Tool.h).
+//
+// Usage: PReflEmptyRunBench <PupilReflTool> <header>... [--runs <n>]
+//
+// The headers are generated once, then every measured run finds them up to
+// date, as a build system checking its reflection step does on each build:
+//   startup             PupilReflTool --help, process creation and static
+//                       initialization only
+//   process per call    PupilReflTool <header>...
+//   new Tool per call   PReflTool::Tool constructed and run in this process
+//   reused Tool         one PReflTool::Tool run over and over
+// The generated files of the headers are written next to them.
+
+#include "Tool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+#ifdef _WIN32
+const char *s_null = "NUL";
+#else
+const char *s_null = "/dev/null";
+#endif
+
+std::string Quote(const std::string &arg) { return "\"" + arg + "\""; }
+
+// median of `runs` calls, in ms
+template <typename F> double Measure(size_t runs, F &&call) {
+  std::vector<double> times;
+  for (size_t i = 0; i < runs; ++i) {
+    auto start = Clock::now();
+    call();
+    times.push_back(
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string tool;
+  std::vector<std::string> headers;
+  size_t runs = 20;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg == "--runs" && i + 1 < argc)
+      runs = std::max<size_t>(1, std::stoul(argv[++i]));
+    else if (tool.empty())
+      tool = arg;
+    else
+      headers.push_back(arg);
+  }
+  if (tool.empty() || headers.empty()) {
+    std::fprintf(stderr,
+                 "Usage: PReflEmptyRunBench <PupilReflTool> <header>... "
+                 "[--runs <n>]\n");
+    return 1;
+  }
+
+  std::string command = Quote(tool) + " --no-modify-source";
+  for (auto &header : headers)
+    command += " " + Quote(header);
+  command += std::string(" > ") + s_null + " 2>&1";
+  std::string help = Quote(tool) + " --help > " + s_null + " 2>&1";
+
+  // generate the headers, so every measured run is empty
+  if (std::system(command.c_str()) != 0) {
+    std::fprintf(stderr, "%s failed\n", command.c_str());
+    return 1;
+  }
+
+  PReflTool::Options options;
+  options.modifySource = false;
+
+  // the tool reports the up to date headers on std::cout
+  std::ostringstream discarded;
+  auto *coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+  size_t upToDate = 0;
+  double newTool = Measure(runs, [&]() {
+    PReflTool::Tool fresh{options};
+    upToDate = 0;
+    for (auto &output : fresh.Run(headers))
+      upToDate += output.upToDate;
+    discarded.str({});
+  });
+  PReflTool::Tool reused{options};
+  double reusedTool = Measure(runs, [&]() {
+    reused.Run(headers);
+    discarded.str({});
+  });
+  std::cout.rdbuf(coutBuffer);
+
+  double startup = Measure(runs, [&]() { std::system(help.c_str()); });
+  double process = Measure(runs, [&]() { std::system(command.c_str()); });
+
+  std::printf("%zu headers, %zu up to date, median of %zu runs\n",
+              headers.size(), upToDate, runs);
+  std::printf("%-20s %10.3f ms\n", "startup", startup);
+  std::printf("%-20s %10.3f ms\n", "process per call", process);
+  std::printf("%-20s %10.3f ms\n", "new Tool per call", newTool);
+  std::printf("%-20s %10.3f ms\n", "reused Tool", reusedTool);
+  return 0;
+}
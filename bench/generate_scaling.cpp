@@ -0,0 +1,94 @@
+// Scaling benchmark of Generator::Generate with parallel record formatting.
+//
+// Usage: PReflGenerateBench [record count] [fields per record]
+//
+// Generates the same synthetic records with 1-16 threads, prints the time of
+// each run and checks that every output is byte-identical to the
+// single-threaded one.
+
+#include "Generator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace PReflTool;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+void PushRecords(Generator &generator, size_t recordCnt, size_t fieldCnt) {
+  for (size_t i = 0; i < recordCnt; ++i) {
+    std::vector<std::string> nsps{"Pupil", "Module" + std::to_string(i % 64)};
+    std::vector<std::string> tmps;
+    if (i % 8 == 0)
+      tmps = {"T1", "T2"};
+    auto record = std::make_unique<CxxRecord>(
+        "Record" + std::to_string(i), nsps, tmps, true, ECxxRecordType::Struct);
+    if (i % 4 == 0)
+      record->AddBase("Pupil::Base" + std::to_string(i % 16));
+    for (size_t j = 0; j < fieldCnt; ++j) {
+      auto field = std::make_unique<Field>();
+      field->name = "field" + std::to_string(j);
+      auto range = std::make_unique<RangeAnnotate>();
+      range->SetRange(0.);
+      range->SetRange(j + 0.5);
+      field->attrs.emplace_back(std::move(range));
+      if (j % 3 == 0) {
+        auto info = std::make_unique<InfoAnnotate>();
+        info->info = "description of field " + std::to_string(j);
+        field->attrs.emplace_back(std::move(info));
+      }
+      record->PushField(field);
+    }
+    generator.PushCxxRecord(record);
+  }
+}
+
+std::string ReadFile(const std::filesystem::path &file) {
+  std::ifstream in(file, std::ios::binary);
+  std::ostringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t recordCnt = argc > 1 ? std::stoul(argv[1]) : 50000;
+  size_t fieldCnt = argc > 2 ? std::stoul(argv[2]) : 8;
+
+  auto dir = std::filesystem::temp_directory_path() / "prefl_generate_bench";
+  std::filesystem::create_directories(dir);
+  auto header = dir / "bench.h";
+  std::ofstream(header) << "#pragma once\n";
+
+  std::printf("records %zu, fields/record %zu\n", recordCnt, fieldCnt);
+  std::string reference;
+  double baseTime = 0.;
+  for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+    Options options;
+    options.modifySource = false;
+    options.useIRCache = false;
+    options.jobs = threads;
+
+    Generator generator{header.string(), options};
+    PushRecords(generator, recordCnt, fieldCnt);
+
+    auto start = Clock::now();
+    generator.Generate();
+    double time = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto output = ReadFile(generator.GetGeneratedFilePath());
+    if (threads == 1) {
+      reference = output;
+      baseTime = time;
+    }
+    std::printf("threads %2u  %9.2f ms  speedup %5.2fx  %s\n", threads,
+                time * 1e3, baseTime / time,
+                output == reference ? "identical" : "DIFFERENT");
+  }
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,210 @@
+// Layout and throughput of the generated GPU block packing
+// (runtime/PReflGpu.h).
+//
+// Usage: PReflGpuBench [record count] [passes]
+//
+// Packs an array of per-view parameter blocks into a std140 buffer with the
+// generated GpuBlock<T>::PackTo, with a packer written by hand and with a
+// generic path as written on top of runtime reflection: a table of fields
+// with their kind and offsets, walked for each record. The offsets of the
+// generated block are checked against the std140 rules at compile time and
+// the bytes of the three packers are compared, so the layout is verified
+// without a GPU. The block is the golden std140 output of TestCase23
+// (test/test.h), so the benchmark follows the generator.
+
+#include "stand_in.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.std140.gen.inl"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace PRefl;
+using FrameParams = TestCase23Nsp::TestCase23;
+using Clock = std::chrono::steady_clock;
+
+// std140: vec3 is aligned to 16 bytes, scalars of arrays and structs to 16
+// bytes, bool is 4 bytes.
+using Block = GpuBlock<FrameParams>;
+static_assert(Block::size == 368 && Block::align == 16);
+static_assert(Block::members[2].offset == 128 && Block::members[3].offset == 140);
+static_assert(Block::members[4].offset == 144 && Block::members[6].offset == 156);
+static_assert(Block::members[7].offset == 160 && Block::members[7].size == 64);
+static_assert(Block::members[8].offset == 224 && Block::members[8].size == 128);
+static_assert(Block::members[9].offset == 352);
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Put(unsigned char *dst, const void *src, size_t size) {
+  std::memcpy(dst, src, size);
+}
+
+void PutBool(unsigned char *dst, bool value) {
+  uint32_t word = value;
+  std::memcpy(dst, &word, sizeof(word));
+}
+
+// Field by field, as written by hand from the GLSL declaration.
+void PackByHand(const FrameParams &params, unsigned char *out) {
+  Put(out + 0, &params.view, 64);
+  Put(out + 64, &params.projection, 64);
+  Put(out + 128, &params.eye, 12);
+  Put(out + 140, &params.time, 4);
+  Put(out + 144, &params.jitter, 8);
+  Put(out + 152, &params.frame, 4);
+  PutBool(out + 156, params.taa);
+  for (size_t i = 0; i < 4; ++i)
+    Put(out + 160 + i * 16, &params.cascadeSplits[i], 4);
+  for (size_t i = 0; i < 4; ++i) {
+    auto &light = params.lights[i];
+    auto *dst = out + 224 + i * 32;
+    Put(dst + 0, &light.position, 12);
+    Put(dst + 12, &light.radius, 4);
+    Put(dst + 16, &light.color, 12);
+    PutBool(dst + 28, light.castShadows);
+  }
+  Put(out + 352, &params.lightCount, 4);
+}
+
+// Generic path: a runtime field table.
+enum class EKind { Bytes, Bool, Struct };
+struct FieldEntry {
+  EKind kind;
+  size_t cpuOffset;
+  size_t gpuOffset;
+  size_t size; // bytes on the CPU
+  size_t count;
+  size_t cpuStride;
+  size_t gpuStride;
+  const FieldEntry *members = nullptr;
+  size_t memberCnt = 0;
+};
+const FieldEntry s_lightFields[] = {
+    {EKind::Bytes, offsetof(TestCase23Nsp::PointLight, position), 0, 12, 1, 0, 0},
+    {EKind::Bytes, offsetof(TestCase23Nsp::PointLight, radius), 12, 4, 1, 0, 0},
+    {EKind::Bytes, offsetof(TestCase23Nsp::PointLight, color), 16, 12, 1, 0, 0},
+    {EKind::Bool, offsetof(TestCase23Nsp::PointLight, castShadows), 28, 1, 1, 0, 0}};
+const FieldEntry s_fields[] = {
+    {EKind::Bytes, offsetof(FrameParams, view), 0, 64, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, projection), 64, 64, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, eye), 128, 12, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, time), 140, 4, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, jitter), 144, 8, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, frame), 152, 4, 1, 0, 0},
+    {EKind::Bool, offsetof(FrameParams, taa), 156, 1, 1, 0, 0},
+    {EKind::Bytes, offsetof(FrameParams, cascadeSplits), 160, 4, 4,
+     sizeof(float), 16},
+    {EKind::Struct, offsetof(FrameParams, lights), 224, 0, 4,
+     sizeof(TestCase23Nsp::PointLight), 32, s_lightFields, 4},
+    {EKind::Bytes, offsetof(FrameParams, lightCount), 352, 4, 1, 0, 0}};
+
+void PackFields(const FieldEntry *fields, size_t fieldCnt,
+                const unsigned char *src, unsigned char *out) {
+  for (size_t f = 0; f < fieldCnt; ++f) {
+    auto &field = fields[f];
+    for (size_t i = 0; i < field.count; ++i) {
+      auto *from = src + field.cpuOffset + i * field.cpuStride;
+      auto *to = out + field.gpuOffset + i * field.gpuStride;
+      switch (field.kind) {
+      case EKind::Bytes:
+        Put(to, from, field.size);
+        break;
+      case EKind::Bool:
+        PutBool(to, *reinterpret_cast<const bool *>(from));
+        break;
+      case EKind::Struct:
+        PackFields(field.members, field.memberCnt, from, to);
+        break;
+      }
+    }
+  }
+}
+
+void PackGeneric(const FrameParams &params, unsigned char *out) {
+  PackFields(s_fields, sizeof(s_fields) / sizeof(s_fields[0]),
+             reinterpret_cast<const unsigned char *>(&params), out);
+}
+
+float Value(size_t i, size_t k) {
+  return static_cast<float>((i * 31 + k * 7) % 1000) * 0.01f;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t recordCnt = argc > 1 ? std::stoul(argv[1]) : 4096;
+  size_t passes = argc > 2 ? std::stoul(argv[2]) : 200;
+
+  std::vector<FrameParams> records(recordCnt);
+  for (size_t i = 0; i < recordCnt; ++i) {
+    auto &params = records[i];
+    auto *matrices = reinterpret_cast<float *>(&params.view);
+    for (size_t k = 0; k < 32; ++k)
+      matrices[k] = Value(i, k);
+    params.eye = {Value(i, 32), Value(i, 33), Value(i, 34)};
+    params.time = Value(i, 35);
+    params.jitter = {Value(i, 36), Value(i, 37)};
+    params.frame = static_cast<int32_t>(i);
+    params.taa = i % 2 == 0;
+    for (size_t k = 0; k < 4; ++k) {
+      params.cascadeSplits[k] = Value(i, 38 + k);
+      auto &light = params.lights[k];
+      light.position = {Value(i, 42 + k), Value(i, 46 + k), Value(i, 50 + k)};
+      light.radius = Value(i, 54 + k);
+      light.color = {Value(i, 58 + k), Value(i, 62 + k), Value(i, 66 + k)};
+      light.castShadows = (i + k) % 3 == 0;
+    }
+    params.lightCount = static_cast<uint32_t>(i % 5);
+  }
+
+  // padding is left as it is, start from the same bytes
+  size_t bytes = recordCnt * Block::size;
+  std::vector<unsigned char> generated(bytes), byHand(bytes), generic(bytes);
+
+  auto start = Clock::now();
+  for (size_t p = 0; p < passes; ++p)
+    PackArrayTo(records.data(), records.size(), generated.data());
+  double generatedTime = Seconds(start);
+
+  start = Clock::now();
+  for (size_t p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < recordCnt; ++i)
+      PackByHand(records[i], byHand.data() + i * Block::size);
+  }
+  double byHandTime = Seconds(start);
+
+  start = Clock::now();
+  for (size_t p = 0; p < passes; ++p) {
+    for (size_t i = 0; i < recordCnt; ++i)
+      PackGeneric(records[i], generic.data() + i * Block::size);
+  }
+  double genericTime = Seconds(start);
+
+  bool ok = generated == byHand && generated == generic;
+  auto mbps = [&](double seconds) {
+    return static_cast<double>(bytes) * passes / seconds / (1 << 20);
+  };
+  std::printf("records %zu, passes %zu, %zu bytes per block\n", recordCnt,
+              passes, Block::size);
+  std::printf("%-18s %10s\n", "", "pack MB/s");
+  std::printf("%-18s %10.1f\n", "generated PackTo", mbps(generatedTime));
+  std::printf("%-18s %10.1f\n", "by hand", mbps(byHandTime));
+  std::printf("%-18s %10.1f\n", "generic reflection", mbps(genericTime));
+  if (!ok) {
+    std::fprintf(stderr, "the packers do not write the same bytes\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,372 @@
+// Throughput of the generated JSON writer and reader (runtime/PReflJson.h).
+//
+// Usage: PReflJsonBench [light count] [passes]
+//
+// Writes and reads an array of scene lights with the generated JsonCodec and
+// with a generic path as written on top of runtime reflection: the writer
+// escapes each field name and formats each value into a temporary string, the
+// reader parses a document tree and then looks the fields up by name.
+// JsonCodec<Light> below is written exactly as PupilReflTool --json generates
+// it for
+//   struct [[META]] Light { [[META]] std::string name; ... };
+
+#include "runtime/PReflJson.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Bench {
+struct Light {
+  std::string name;
+  float color[3];
+  float intensity;
+  float range;
+  int32_t type;
+  bool castShadows;
+  std::vector<float> cascadeSplits;
+};
+} // namespace Bench
+
+namespace PRefl {
+template<>
+struct JsonCodec<Bench::Light>
+{
+    constexpr static std::array<std::string_view, 7> keys = {"name", "color", "intensity", "range", "type", "castShadows", "cascadeSplits"};
+    constexpr static auto keyIndex = EnumHashIndex<4, 8> {
+        {2, 1, 0, 0},
+        {1, 7, 4, 0, 2, 3, 6, 5}
+    };
+    template <typename Record>
+    static void Write(JsonWriter &out, const Record &record) {
+        out.Raw("{\"name\":");
+        JsonDetail::Write(out, record.name);
+        out.Raw(",\"color\":");
+        JsonDetail::Write(out, record.color);
+        out.Raw(",\"intensity\":");
+        JsonDetail::Write(out, record.intensity);
+        out.Raw(",\"range\":");
+        JsonDetail::Write(out, record.range);
+        out.Raw(",\"type\":");
+        JsonDetail::Write(out, record.type);
+        out.Raw(",\"castShadows\":");
+        JsonDetail::Write(out, record.castShadows);
+        out.Raw(",\"cascadeSplits\":");
+        JsonDetail::Write(out, record.cascadeSplits);
+        out.Char('}');
+    }
+    template <typename Record>
+    static bool Read(JsonReader &in, Record &record) {
+        return in.ReadObject([&](std::string_view key) {
+            switch (JsonDetail::FindKey(keyIndex, keys, key)) {
+            case 0:
+                return JsonDetail::Read(in, record.name);
+            case 1:
+                return JsonDetail::Read(in, record.color);
+            case 2:
+                return JsonDetail::Read(in, record.intensity);
+            case 3:
+                return JsonDetail::Read(in, record.range);
+            case 4:
+                return JsonDetail::Read(in, record.type);
+            case 5:
+                return JsonDetail::Read(in, record.castShadows);
+            case 6:
+                return JsonDetail::Read(in, record.cascadeSplits);
+            default:
+                return in.Skip();
+            }
+        });
+    }
+};
+} // namespace PRefl
+
+using namespace PRefl;
+using Bench::Light;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Generic path: a runtime field table.
+enum class EKind { String, Float, Float3, Int, Bool, FloatList };
+struct FieldEntry {
+  const char *name;
+  EKind kind;
+  size_t offset;
+};
+const FieldEntry s_fields[] = {
+    {"name", EKind::String, offsetof(Light, name)},
+    {"color", EKind::Float3, offsetof(Light, color)},
+    {"intensity", EKind::Float, offsetof(Light, intensity)},
+    {"range", EKind::Float, offsetof(Light, range)},
+    {"type", EKind::Int, offsetof(Light, type)},
+    {"castShadows", EKind::Bool, offsetof(Light, castShadows)},
+    {"cascadeSplits", EKind::FloatList, offsetof(Light, cascadeSplits)}};
+
+std::string Escape(const std::string &str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+std::string FormatFloat(float value) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+  return buffer;
+}
+
+void WriteGeneric(const std::vector<Light> &lights, std::string &out) {
+  out += '[';
+  for (size_t i = 0; i < lights.size(); ++i) {
+    auto *base = reinterpret_cast<const char *>(&lights[i]);
+    out += i > 0 ? ",{" : "{";
+    bool first = true;
+    for (auto &field : s_fields) {
+      std::string value;
+      auto *ptr = base + field.offset;
+      switch (field.kind) {
+      case EKind::String:
+        value = "\"" + Escape(*reinterpret_cast<const std::string *>(ptr)) +
+                "\"";
+        break;
+      case EKind::Float:
+        value = FormatFloat(*reinterpret_cast<const float *>(ptr));
+        break;
+      case EKind::Float3: {
+        auto *v = reinterpret_cast<const float *>(ptr);
+        value = "[" + FormatFloat(v[0]) + "," + FormatFloat(v[1]) + "," +
+                FormatFloat(v[2]) + "]";
+        break;
+      }
+      case EKind::Int:
+        value = std::to_string(*reinterpret_cast<const int32_t *>(ptr));
+        break;
+      case EKind::Bool:
+        value = *reinterpret_cast<const bool *>(ptr) ? "true" : "false";
+        break;
+      case EKind::FloatList: {
+        auto &list = *reinterpret_cast<const std::vector<float> *>(ptr);
+        value = "[";
+        for (size_t j = 0; j < list.size(); ++j)
+          value += (j > 0 ? "," : "") + FormatFloat(list[j]);
+        value += "]";
+        break;
+      }
+      }
+      out += (first ? "\"" : ",\"") + Escape(field.name) + "\":" + value;
+      first = false;
+    }
+    out += '}';
+  }
+  out += ']';
+}
+
+// Document tree of the generic reader.
+struct Value {
+  enum { Null, Bool, Number, String, Array, Object } type = Null;
+  bool boolean = false;
+  double number = 0.;
+  std::string string;
+  std::vector<Value> array;
+  std::map<std::string, Value> object;
+};
+
+struct Parser {
+  const char *p;
+
+  void Space() {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+      ++p;
+  }
+  std::string ParseString() {
+    std::string str;
+    for (++p; *p != '"'; ++p) {
+      if (*p == '\\')
+        ++p;
+      str += *p;
+    }
+    ++p;
+    return str;
+  }
+  Value Parse() {
+    Space();
+    Value value;
+    if (*p == '{') {
+      value.type = Value::Object;
+      ++p;
+      Space();
+      while (*p != '}') {
+        Space();
+        auto key = ParseString();
+        Space();
+        ++p; // ':'
+        value.object[key] = Parse();
+        Space();
+        if (*p == ',')
+          ++p;
+      }
+      ++p;
+    } else if (*p == '[') {
+      value.type = Value::Array;
+      ++p;
+      Space();
+      while (*p != ']') {
+        value.array.push_back(Parse());
+        Space();
+        if (*p == ',')
+          ++p;
+      }
+      ++p;
+    } else if (*p == '"') {
+      value.type = Value::String;
+      value.string = ParseString();
+    } else if (*p == 't' || *p == 'f') {
+      value.type = Value::Bool;
+      value.boolean = *p == 't';
+      p += value.boolean ? 4 : 5;
+    } else if (*p == 'n') {
+      p += 4;
+    } else {
+      value.type = Value::Number;
+      char *end;
+      value.number = std::strtod(p, &end);
+      p = end;
+    }
+    return value;
+  }
+};
+
+void ReadGeneric(const std::string &text, std::vector<Light> &lights) {
+  Parser parser{text.c_str()};
+  auto document = parser.Parse();
+  lights.clear();
+  for (auto &element : document.array) {
+    auto &light = lights.emplace_back();
+    auto *base = reinterpret_cast<char *>(&light);
+    for (auto &field : s_fields) {
+      auto it = element.object.find(field.name);
+      if (it == element.object.end())
+        continue;
+      auto &value = it->second;
+      auto *ptr = base + field.offset;
+      switch (field.kind) {
+      case EKind::String:
+        *reinterpret_cast<std::string *>(ptr) = value.string;
+        break;
+      case EKind::Float:
+        *reinterpret_cast<float *>(ptr) = static_cast<float>(value.number);
+        break;
+      case EKind::Float3:
+        for (size_t j = 0; j < 3 && j < value.array.size(); ++j)
+          reinterpret_cast<float *>(ptr)[j] =
+              static_cast<float>(value.array[j].number);
+        break;
+      case EKind::Int:
+        *reinterpret_cast<int32_t *>(ptr) = static_cast<int32_t>(value.number);
+        break;
+      case EKind::Bool:
+        *reinterpret_cast<bool *>(ptr) = value.boolean;
+        break;
+      case EKind::FloatList: {
+        auto &list = *reinterpret_cast<std::vector<float> *>(ptr);
+        list.clear();
+        for (auto &number : value.array)
+          list.push_back(static_cast<float>(number.number));
+        break;
+      }
+      }
+    }
+  }
+}
+
+bool Same(const std::vector<Light> &a, const std::vector<Light> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].name != b[i].name || a[i].intensity != b[i].intensity ||
+        a[i].range != b[i].range || a[i].type != b[i].type ||
+        a[i].castShadows != b[i].castShadows ||
+        a[i].cascadeSplits != b[i].cascadeSplits ||
+        std::memcmp(a[i].color, b[i].color, sizeof(a[i].color)) != 0)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t lightCnt = argc > 1 ? std::stoul(argv[1]) : 2000;
+  size_t passes = argc > 2 ? std::stoul(argv[2]) : 100;
+
+  std::vector<Light> lights(lightCnt);
+  for (size_t i = 0; i < lightCnt; ++i) {
+    auto &light = lights[i];
+    light.name = "light \"" + std::to_string(i) + "\"";
+    for (int c = 0; c < 3; ++c)
+      light.color[c] = static_cast<float>((i * 7 + c) % 256) / 255.f;
+    light.intensity = 1.f + static_cast<float>(i % 100) * 0.37f;
+    light.range = 10.f + static_cast<float>(i % 17);
+    light.type = static_cast<int32_t>(i % 3);
+    light.castShadows = i % 2 == 0;
+    if (light.type == 0)
+      light.cascadeSplits = {0.05f, 0.15f, 0.4f, 1.f};
+  }
+
+  std::string generated, generic;
+  auto start = Clock::now();
+  for (size_t p = 0; p < passes; ++p) {
+    generated.clear();
+    ToJson(lights, generated);
+  }
+  double writeTime = Seconds(start);
+
+  start = Clock::now();
+  for (size_t p = 0; p < passes; ++p) {
+    generic.clear();
+    WriteGeneric(lights, generic);
+  }
+  double genericWriteTime = Seconds(start);
+
+  std::vector<Light> read;
+  bool ok = true;
+  start = Clock::now();
+  for (size_t p = 0; p < passes; ++p)
+    ok &= FromJson(generated, read);
+  double readTime = Seconds(start);
+  ok &= Same(lights, read);
+
+  std::vector<Light> genericRead;
+  start = Clock::now();
+  for (size_t p = 0; p < passes; ++p)
+    ReadGeneric(generic, genericRead);
+  double genericReadTime = Seconds(start);
+
+  auto mbps = [&](const std::string &text, double seconds) {
+    return static_cast<double>(text.size()) * passes / seconds / (1 << 20);
+  };
+  std::printf("lights %zu, passes %zu, %zu bytes of JSON\n", lightCnt, passes,
+              generated.size());
+  std::printf("%-18s %10s %10s\n", "", "write MB/s", "read MB/s");
+  std::printf("%-18s %10.1f %10.1f\n", "generated codec",
+              mbps(generated, writeTime), mbps(generated, readTime));
+  std::printf("%-18s %10.1f %10.1f\n", "generic reflection",
+              mbps(generic, genericWriteTime),
+              mbps(generic, genericReadTime));
+  if (!ok) {
+    std::fprintf(stderr, "the generated reader does not round trip\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Dispatch benchmark of the reflected method thunks (runtime/PReflMethod.h).
+//
+// Usage: PReflMethodBench [call count]
+//
+// Calls the same method directly, through the generated invoker table, through
+// a stored std::function and through a std::function built for every call, as
+// script and UI bindings do. MethodData<Calc> below is written exactly as
+// PupilReflTool generates it for
+//   struct Calc { [[META]] float Scale(float x, float y) const; ... };
+
+#include "runtime/PReflMethod.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Bench {
+struct Calc {
+  float k = 1.0001f;
+  float bias = 0.f;
+
+  float Scale(float x, float y) const { return k * x + y; }
+  void Accumulate(float x) { bias += x; }
+};
+} // namespace Bench
+
+namespace PRefl {
+template<>
+struct MethodData<Bench::Calc>
+{
+    static void Invoke0(void *object, void *const *args, void *result) {
+        MethodDetail::Store<float>(result, [&]() -> decltype(auto) {
+            return static_cast<const Bench::Calc *>(object)->Scale(MethodDetail::Arg<float>(args[0]), MethodDetail::Arg<float>(args[1]));
+        });
+    }
+    constexpr static auto params0 = std::array<MethodParam, 2> {{
+        { "x", TypeTagOf<float>() },
+        { "y", TypeTagOf<float>() }
+    }};
+    static void Invoke1(void *object, void *const *args, void *result) {
+        MethodDetail::Store<void>(result, [&]() -> decltype(auto) {
+            return static_cast<Bench::Calc *>(object)->Accumulate(MethodDetail::Arg<float>(args[0]));
+        });
+    }
+    constexpr static auto params1 = std::array<MethodParam, 1> {{
+        { "x", TypeTagOf<float>() }
+    }};
+    constexpr static auto methods = std::array<Method, 2> {{
+        { "Scale", &Invoke0, TypeTagOf<float>(), params0.data(), params0.size(), true, false },
+        { "Accumulate", &Invoke1, TypeTagOf<void>(), params1.data(), params1.size(), false, false }
+    }};
+};
+} // namespace PRefl
+
+using namespace PRefl;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// keep the compiler from folding the loops away
+volatile float s_sink;
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t callCnt = argc > 1 ? std::stoul(argv[1]) : 20000000;
+
+  Bench::Calc calc;
+  std::vector<float> inputs(1024);
+  for (size_t i = 0; i < inputs.size(); ++i)
+    inputs[i] = static_cast<float>(i) * 0.5f;
+
+  // direct call
+  float sum = 0.f;
+  auto start = Clock::now();
+  for (size_t i = 0; i < callCnt; ++i)
+    sum += calc.Scale(inputs[i & 1023], sum * 1e-9f);
+  double directTime = Seconds(start);
+  s_sink = sum;
+
+  // generated invoker, looked up by name once like a binding does
+  const Method *method = FindMethod<Bench::Calc>("Scale");
+  sum = 0.f;
+  start = Clock::now();
+  for (size_t i = 0; i < callCnt; ++i) {
+    float x = inputs[i & 1023];
+    float y = sum * 1e-9f;
+    void *args[] = {&x, &y};
+    float result;
+    method->invoke(&calc, args, &result);
+    sum += result;
+  }
+  double thunkTime = Seconds(start);
+  s_sink = sum;
+
+  // stored std::function
+  std::function<float(const Bench::Calc &, float, float)> stored =
+      &Bench::Calc::Scale;
+  sum = 0.f;
+  start = Clock::now();
+  for (size_t i = 0; i < callCnt; ++i)
+    sum += stored(calc, inputs[i & 1023], sum * 1e-9f);
+  double storedTime = Seconds(start);
+  s_sink = sum;
+
+  // std::function built for every call, capturing the object and arguments
+  sum = 0.f;
+  start = Clock::now();
+  for (size_t i = 0; i < callCnt; ++i) {
+    float x = inputs[i & 1023];
+    float y = sum * 1e-9f;
+    float result;
+    std::function<void()> call = [&calc, x, y, &result]() {
+      result = calc.Scale(x, y);
+    };
+    call();
+    sum += result;
+  }
+  double perCallTime = Seconds(start);
+  s_sink = sum;
+
+  auto ns = [callCnt](double seconds) { return seconds * 1e9 / callCnt; };
+  std::printf("calls %zu\n", callCnt);
+  std::printf("direct call                   %8.2f ns/call\n", ns(directTime));
+  std::printf("generated invoker             %8.2f ns/call\n", ns(thunkTime));
+  std::printf("stored std::function          %8.2f ns/call\n", ns(storedTime));
+  std::printf("std::function per call        %8.2f ns/call\n",
+              ns(perCallTime));
+  return 0;
+}
@@ -0,0 +1,80 @@
+"""Visit time of deeply nested records.
+
+Usage: python nested_records.py <PupilReflTool> [--records N] [--runs N]
+
+Generates headers with the same number of reflected records, nested in
+chains of growing depth (record i + 1 is declared inside record i), each with
+fields, a method with a body and a nested enum. The median visit time reported
+by --stats is printed per depth. Every declaration is visited once, so the
+time per record should not grow with the depth.
+"""
+import argparse
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+STATS = re.compile(r"\*\*\* stats: parse ([0-9.]+) ms.*, visit ([0-9.]+) ms")
+DEPTHS = [1, 4, 16, 64, 128]
+
+
+def record(level, depth, chain):
+    name = f"C{chain}L{level}"
+    lines = [
+        f"struct [[META]] {name} {{",
+        f"    [[META, RANGE(0, 1)]] float a{level};",
+        f"    [[META, INFO(\"level {level}\")]] int b{level}[4];",
+        f"    enum [[META]] E{level} {{ X{level}, Y{level} }};",
+        f"    [[META]] int Sum(int n) const {{",
+        f"        int s = 0;",
+        f"        for (int i = 0; i < n; ++i) s += b{level}[i & 3] * i;",
+        f"        return s;",
+        f"    }}",
+    ]
+    if level + 1 < depth:
+        lines += record(level + 1, depth, chain)
+    lines.append("};")
+    return lines
+
+
+def write_header(path, records, depth):
+    lines = ["#pragma once", ""]
+    for chain in range(records // depth):
+        lines += record(0, depth, chain)
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def run(tool, header):
+    out = subprocess.run([tool, "--no-modify-source", "--no-cache", "--force",
+                          "--stats", header],
+                         check=True, capture_output=True, text=True).stdout
+    match = STATS.search(out)
+    if not match:
+        sys.exit("no stats in tool output:\n" + out)
+    return float(match.group(1)), float(match.group(2))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("tool")
+    parser.add_argument("--records", type=int, default=512)
+    parser.add_argument("--runs", type=int, default=5)
+    args = parser.parse_args()
+
+    print(f"{'depth':>6} {'records':>8} {'parse ms':>10} {'visit ms':>10} {'us/record':>10}")
+    with tempfile.TemporaryDirectory() as tmp:
+        for depth in DEPTHS:
+            header = os.path.join(tmp, f"nested_{depth}.h")
+            write_header(header, args.records, depth)
+            records = args.records // depth * depth
+            results = [run(args.tool, header) for _ in range(args.runs)]
+            parse = statistics.median(r[0] for r in results)
+            visit = statistics.median(r[1] for r in results)
+            print(f"{depth:6} {records:8} {parse:10.1f} {visit:10.2f} {visit * 1e3 / records:10.2f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,191 @@
+// Throughput of the generated record hashes (runtime/PReflHash.h).
+//
+// Usage: PReflHashBench [record count] [passes]
+//
+// Hashes an array of material parameter blocks, as cache and dedupe keys do,
+// with the generated Hasher, with a generic hasher which folds over the
+// reflected fields one at a time (as written on top of ReflData<T>::fields)
+// and with a type erased table of fields, as runtime reflection does.
+// Hasher<Material> below is written exactly as PupilReflTool generates it for
+//   struct [[META]] Material { [[META]] float baseColor[4]; ... };
+
+#include "runtime/PReflHash.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Bench {
+struct Material {
+  float baseColor[4];
+  float emissive[3];
+  float roughness;
+  float metallic;
+  float ior;
+  float transmission;
+  float clearcoat;
+  uint32_t textureIds[8];
+  uint32_t flags;
+  uint8_t blendMode;
+  uint8_t cullMode;
+  double alphaCutoff;
+  std::string name;
+};
+} // namespace Bench
+
+namespace PRefl {
+template<>
+struct Hasher<Bench::Material>
+{
+    template <typename Record>
+    static uint64_t Hash(const Record &record, uint64_t seed) {
+        uint64_t h = seed;
+        constexpr size_t run0 = sizeof(record.baseColor) + sizeof(record.emissive) + sizeof(record.roughness) + sizeof(record.metallic) + sizeof(record.ior) + sizeof(record.transmission) + sizeof(record.clearcoat) + sizeof(record.textureIds) + sizeof(record.flags) + sizeof(record.blendMode) + sizeof(record.cullMode);
+        if (HashDetail::IsPlainRun<decltype(record.baseColor), decltype(record.emissive), decltype(record.roughness), decltype(record.metallic), decltype(record.ior), decltype(record.transmission), decltype(record.clearcoat), decltype(record.textureIds), decltype(record.flags), decltype(record.blendMode), decltype(record.cullMode)> &&
+            HashDetail::IsRun(record.baseColor, record.cullMode, run0)) {
+            h = HashDetail::HashRun(h, record.baseColor, run0);
+        } else {
+            h = HashDetail::Combine(h, record.baseColor);
+            h = HashDetail::Combine(h, record.emissive);
+            h = HashDetail::Combine(h, record.roughness);
+            h = HashDetail::Combine(h, record.metallic);
+            h = HashDetail::Combine(h, record.ior);
+            h = HashDetail::Combine(h, record.transmission);
+            h = HashDetail::Combine(h, record.clearcoat);
+            h = HashDetail::Combine(h, record.textureIds);
+            h = HashDetail::Combine(h, record.flags);
+            h = HashDetail::Combine(h, record.blendMode);
+            h = HashDetail::Combine(h, record.cullMode);
+        }
+        h = HashDetail::Combine(h, record.alphaCutoff);
+        h = HashDetail::Combine(h, record.name);
+        return h;
+    }
+};
+} // namespace PRefl
+
+using namespace PRefl;
+using Bench::Material;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// keep the compiler from folding the loops away
+volatile uint64_t s_sink;
+
+// The member pointers of ReflData<Material>::fields.
+constexpr auto s_fields = std::make_tuple(
+    &Material::baseColor, &Material::emissive, &Material::roughness,
+    &Material::metallic, &Material::ior, &Material::transmission,
+    &Material::clearcoat, &Material::textureIds, &Material::flags,
+    &Material::blendMode, &Material::cullMode, &Material::alphaCutoff,
+    &Material::name);
+
+// Generic hasher over the reflected fields, one Combine per field.
+uint64_t HashFieldwise(const Material &record, uint64_t seed) {
+  return std::apply(
+      [&](auto... members) {
+        uint64_t h = seed;
+        ((h = HashDetail::Combine(h, record.*members)), ...);
+        return h;
+      },
+      s_fields);
+}
+
+// Type erased field table, one indirect call per field.
+struct FieldEntry {
+  const char *name;
+  size_t offset;
+  uint64_t (*hash)(uint64_t h, const void *field);
+};
+
+template <auto Member> FieldEntry MakeEntry(const char *name) {
+  using Field = std::remove_reference_t<decltype(std::declval<Material>().*
+                                                 Member)>;
+  Material probe{};
+  auto offset = reinterpret_cast<const char *>(&(probe.*Member)) -
+                reinterpret_cast<const char *>(&probe);
+  return {name, static_cast<size_t>(offset),
+          [](uint64_t h, const void *field) {
+            return HashDetail::Combine(h, *static_cast<const Field *>(field));
+          }};
+}
+
+const std::vector<FieldEntry> s_table = {
+    MakeEntry<&Material::baseColor>("baseColor"),
+    MakeEntry<&Material::emissive>("emissive"),
+    MakeEntry<&Material::roughness>("roughness"),
+    MakeEntry<&Material::metallic>("metallic"),
+    MakeEntry<&Material::ior>("ior"),
+    MakeEntry<&Material::transmission>("transmission"),
+    MakeEntry<&Material::clearcoat>("clearcoat"),
+    MakeEntry<&Material::textureIds>("textureIds"),
+    MakeEntry<&Material::flags>("flags"),
+    MakeEntry<&Material::blendMode>("blendMode"),
+    MakeEntry<&Material::cullMode>("cullMode"),
+    MakeEntry<&Material::alphaCutoff>("alphaCutoff"),
+    MakeEntry<&Material::name>("name")};
+
+uint64_t HashTable(const Material &record, uint64_t seed) {
+  uint64_t h = seed;
+  auto *base = reinterpret_cast<const char *>(&record);
+  for (auto &entry : s_table)
+    h = entry.hash(h, base + entry.offset);
+  return h;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t recordCnt = argc > 1 ? std::stoul(argv[1]) : 4096;
+  size_t passes = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+  std::vector<Material> materials(recordCnt);
+  size_t bytes = 0;
+  for (size_t i = 0; i < recordCnt; ++i) {
+    auto &m = materials[i];
+    for (int c = 0; c < 4; ++c)
+      m.baseColor[c] = static_cast<float>(i % 97) / 97.f + c;
+    m.roughness = static_cast<float>(i % 13) / 13.f;
+    m.flags = static_cast<uint32_t>(i);
+    for (int t = 0; t < 8; ++t)
+      m.textureIds[t] = static_cast<uint32_t>(i * 8 + t);
+    m.name = "material_" + std::to_string(i);
+    // the values of the fields, without padding and string headers
+    bytes += 12 * sizeof(float) + 9 * sizeof(uint32_t) + 2 * sizeof(uint8_t) +
+             sizeof(double) + m.name.size();
+  }
+
+  auto run = [&](auto hash) {
+    uint64_t h = 0;
+    auto start = Clock::now();
+    for (size_t p = 0; p < passes; ++p)
+      for (auto &m : materials)
+        h ^= hash(m, p);
+    double seconds = Seconds(start);
+    s_sink = h;
+    return seconds;
+  };
+  double generated =
+      run([](const Material &m, uint64_t seed) { return Hash(m, seed); });
+  double fieldwise = run(HashFieldwise);
+  double table = run(HashTable);
+
+  auto report = [&](const char *name, double seconds) {
+    double records = static_cast<double>(recordCnt) * passes;
+    std::printf("%-22s %8.2f ns/record %10.1f MB/s\n", name,
+                seconds * 1e9 / records,
+                bytes * static_cast<double>(passes) / seconds / (1 << 20));
+  };
+  std::printf("records %zu, passes %zu, %zu bytes of fields per pass\n",
+              recordCnt, passes, bytes);
+  report("generated Hasher", generated);
+  report("field by field", fieldwise);
+  report("type erased fields", table);
+  return 0;
+}
@@ -0,0 +1,197 @@
+// Multi-threaded lookups in the runtime registry (runtime/PReflRegistry.h).
+//
+// Usage: PReflRegistryBench [record count] [lookups per thread]
+//
+// Every thread looks up records by type ID and by name, with 1 up to the
+// number of hardware threads, compared with an unordered_map behind a
+// shared_mutex. The second half of each run has a writer registering and
+// unregistering records next to the readers, as modules loading and
+// unloading do. The registration of Bench::Transform below is written
+// exactly as PupilReflTool generates it with --registry for
+//   struct [[META]] Transform { [[META]] float position[3]; ... };
+
+#include "runtime/PReflRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Bench {
+struct Transform {
+  float position[3];
+  float rotation[4];
+  float scale;
+};
+} // namespace Bench
+
+namespace PRefl {
+template <typename T> struct ReflData;
+
+template<>
+struct ReflData<Bench::Transform>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x5e23d78585589deaull;
+};
+namespace RegistryDetail {
+inline const Registration registration_5e23d78585589dea {
+    RecordInfo { ReflData<Bench::Transform>::typeId, "Bench::Transform", sizeof(Bench::Transform), alignof(Bench::Transform) },
+    {
+        FieldOf("position", &Bench::Transform::position),
+        FieldOf("rotation", &Bench::Transform::rotation),
+        FieldOf("scale", &Bench::Transform::scale)
+    }
+};
+} // namespace RegistryDetail
+} // namespace PRefl
+
+using namespace PRefl;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// keep the compiler from folding the loops away
+std::atomic<size_t> s_sink;
+
+// The usual alternative: a map guarded by a reader/writer lock.
+class LockedMap {
+  std::unordered_map<uint64_t, RecordInfo> m_records;
+  mutable std::shared_mutex m_mutex;
+
+public:
+  void Insert(const RecordInfo &info) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_records[info.typeId] = info;
+  }
+  void Erase(uint64_t typeId) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_records.erase(typeId);
+  }
+  const RecordInfo *Find(uint64_t typeId) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_records.find(typeId);
+    return it != m_records.end() ? &it->second : nullptr;
+  }
+  const RecordInfo *Find(std::string_view name) const {
+    auto *info = Find(TypeIdOf(name));
+    return info && info->name == name ? info : nullptr;
+  }
+};
+
+template <typename Lookup>
+double Run(unsigned threadCnt, size_t lookupCnt, Lookup &&lookup,
+           const std::function<void(size_t)> &write) {
+  std::atomic<bool> stop{false};
+  std::thread writer;
+  if (write) {
+    writer = std::thread([&]() {
+      for (size_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+        write(i);
+    });
+  }
+
+  std::vector<std::thread> threads;
+  auto start = Clock::now();
+  for (unsigned t = 0; t < threadCnt; ++t) {
+    threads.emplace_back([&, t]() {
+      size_t found = 0;
+      for (size_t i = 0; i < lookupCnt; ++i)
+        found += lookup(i * 7919 + t) != nullptr;
+      s_sink += found;
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  double seconds = Seconds(start);
+
+  stop = true;
+  if (writer.joinable())
+    writer.join();
+  return seconds * 1e9 / lookupCnt;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t recordCnt = argc > 1 ? std::stoul(argv[1]) : 1024;
+  size_t lookupCnt = argc > 2 ? std::stoul(argv[2]) : 4000000;
+
+  static_assert(ReflData<Bench::Transform>::typeId ==
+                TypeIdOf("Bench::Transform"));
+  auto &registry = Registry::Instance();
+  if (!registry.Find("Bench::Transform")) {
+    std::fprintf(stderr, "the generated registration is missing\n");
+    return 1;
+  }
+
+  std::vector<std::string> names;
+  std::vector<uint64_t> ids;
+  std::vector<FieldInfo> fields = {{"x", 0, 4}, {"y", 4, 4}, {"z", 8, 4}};
+  LockedMap locked;
+  for (size_t i = 0; i < recordCnt; ++i) {
+    names.push_back("Bench::Record" + std::to_string(i));
+    ids.push_back(TypeIdOf(names.back()));
+    RecordInfo info{ids.back(), names.back(), 12, 4, fields.data(),
+                    fields.size()};
+    registry.Register(info);
+    locked.Insert(*registry.Find(ids.back()));
+  }
+
+  // records of a module which is loaded and unloaded over and over
+  std::vector<std::string> churnNames;
+  for (size_t i = 0; i < 64; ++i)
+    churnNames.push_back("Bench::Plugin" + std::to_string(i));
+  auto churnRegistry = [&](size_t i) {
+    auto &name = churnNames[i % churnNames.size()];
+    RecordInfo info{TypeIdOf(name), name, 12, 4, fields.data(), fields.size()};
+    registry.Unregister(registry.Register(info));
+  };
+  auto churnLocked = [&](size_t i) {
+    auto &name = churnNames[i % churnNames.size()];
+    RecordInfo info{TypeIdOf(name), name, 12, 4, fields.data(), fields.size()};
+    locked.Insert(info);
+    locked.Erase(info.typeId);
+  };
+
+  auto byId = [&](size_t i) { return registry.Find(ids[i % recordCnt]); };
+  auto byName = [&](size_t i) { return registry.Find(names[i % recordCnt]); };
+  auto lockedById = [&](size_t i) { return locked.Find(ids[i % recordCnt]); };
+  auto lockedByName = [&](size_t i) {
+    return locked.Find(names[i % recordCnt]);
+  };
+
+  unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::printf("records %zu, lookups per thread %zu, ns/lookup per thread\n",
+              recordCnt, lookupCnt);
+  std::printf("%-8s %-10s %10s %10s %10s %10s\n", "threads", "writer",
+              "id", "name", "locked id", "locked name");
+  for (unsigned threadCnt = 1;;
+       threadCnt = std::min(threadCnt * 2, maxThreads)) {
+    for (bool writing : {false, true}) {
+      std::function<void(size_t)> none;
+      std::function<void(size_t)> write = churnRegistry;
+      std::function<void(size_t)> writeLocked = churnLocked;
+      double id = Run(threadCnt, lookupCnt, byId, writing ? write : none);
+      double name = Run(threadCnt, lookupCnt, byName, writing ? write : none);
+      double lockedId =
+          Run(threadCnt, lookupCnt, lockedById, writing ? writeLocked : none);
+      double lockedName =
+          Run(threadCnt, lookupCnt, lockedByName, writing ? writeLocked : none);
+      std::printf("%-8u %-10s %10.2f %10.2f %10.2f %10.2f\n", threadCnt,
+                  writing ? "churn" : "none", id, name, lockedId, lockedName);
+    }
+    if (threadCnt == maxThreads)
+      break;
+  }
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Lookup benchmark of the binary schema (schema/PReflSchema.h).
+//
+// Usage: PReflSchemaBench [record count] [fields per record]
+//
+// Builds a synthetic schema with SchemaWriter, maps it from disk and measures
+// the time to open it, to find records by qualified name and to find fields
+// by name. Building a std::unordered_map from the same data is measured as the
+// deserializing baseline.
+
+#include "SchemaWriter.h"
+#include "schema/PReflSchema.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace PReflTool;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::vector<std::unique_ptr<CxxRecord>> MakeRecords(size_t recordCnt,
+                                                    size_t fieldCnt) {
+  std::vector<std::unique_ptr<CxxRecord>> records;
+  for (size_t i = 0; i < recordCnt; ++i) {
+    std::vector<std::string> nsps{"Pupil", "Module" + std::to_string(i % 64)};
+    std::vector<std::string> tmps;
+    auto record = std::make_unique<CxxRecord>(
+        "Record" + std::to_string(i), nsps, tmps, true, ECxxRecordType::Struct);
+    for (size_t j = 0; j < fieldCnt; ++j) {
+      auto field = std::make_unique<Field>();
+      field->name = "field" + std::to_string(j);
+      auto range = std::make_unique<RangeAnnotate>();
+      range->SetRange(0.);
+      range->SetRange(static_cast<double>(j));
+      field->attrs.emplace_back(std::move(range));
+      record->PushField(field);
+    }
+    records.emplace_back(std::move(record));
+  }
+  return records;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t recordCnt = argc > 1 ? std::stoul(argv[1]) : 10000;
+  size_t fieldCnt = argc > 2 ? std::stoul(argv[2]) : 8;
+  const size_t lookupCnt = 1000000;
+
+  auto records = MakeRecords(recordCnt, fieldCnt);
+  auto file = std::filesystem::temp_directory_path() / "prefl_bench.refl.bin";
+  SchemaWriter::Write(file, records);
+
+  std::vector<std::string> names;
+  for (auto &record : records)
+    names.push_back(record->GetFullName());
+  std::mt19937 rng{42};
+  std::vector<uint32_t> queries(lookupCnt);
+  for (auto &q : queries)
+    q = rng() % recordCnt;
+
+  auto start = Clock::now();
+  PReflSchema::MappedSchema mapped{file.string().c_str()};
+  auto schema = mapped.GetSchema();
+  if (!schema.IsValid()) {
+    std::fprintf(stderr, "invalid schema\n");
+    return 1;
+  }
+  double openTime = Seconds(start);
+
+  // baseline: deserialize the records into a hash map
+  start = Clock::now();
+  std::unordered_map<std::string, std::vector<std::string>> map;
+  for (uint32_t i = 0; i < schema.GetRecordCount(); ++i) {
+    const auto &record = schema.GetRecord(i);
+    auto &fields = map[std::string{schema.GetString(record.qualifiedName)}];
+    for (uint32_t j = 0; j < record.fieldCount; ++j)
+      fields.emplace_back(schema.GetString(schema.GetField(record, j).name));
+  }
+  double loadTime = Seconds(start);
+
+  size_t found = 0;
+  start = Clock::now();
+  for (auto q : queries)
+    found += schema.FindRecord(names[q]) != nullptr;
+  double recordTime = Seconds(start);
+
+  std::string fieldName = "field" + std::to_string(fieldCnt / 2);
+  start = Clock::now();
+  for (auto q : queries) {
+    const auto *record = schema.FindRecord(names[q]);
+    const auto *field = record ? schema.FindField(*record, fieldName) : nullptr;
+    found += field && schema.FindAttr(*field, PReflSchema::EAttrType::Range);
+  }
+  double fieldTime = Seconds(start);
+
+  start = Clock::now();
+  for (auto q : queries)
+    found += map.find(names[q]) != map.end();
+  double mapTime = Seconds(start);
+
+  std::printf("records %zu, fields/record %zu, file %.2f MB\n", recordCnt,
+              fieldCnt, std::filesystem::file_size(file) / (1024. * 1024.));
+  std::printf("open + validate (mmap)          %10.3f ms\n", openTime * 1e3);
+  std::printf("deserialize to unordered_map    %10.3f ms\n", loadTime * 1e3);
+  std::printf("record by name (schema)         %10.1f ns/lookup\n",
+              recordTime * 1e9 / lookupCnt);
+  std::printf("record + field + attr (schema)  %10.1f ns/lookup\n",
+              fieldTime * 1e9 / lookupCnt);
+  std::printf("record by name (unordered_map)  %10.1f ns/lookup\n",
+              mapTime * 1e9 / lookupCnt);
+  std::printf("(found %zu)\n", found);
+
+  mapped.Close();
+  std::filesystem::remove(file);
+  return 0;
+}
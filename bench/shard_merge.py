@@ -0,0 +1,99 @@
+"""Single process run against --shard processes followed by --merge.
+
+Usage: python shard_merge.py <PupilReflTool> <source dir> [--shards N] [-j N]
+
+The source directory is copied twice. One copy is generated by one process
+with --scan, the other by N shard processes running at the same time and a
+--merge step. The wall time of each phase is printed, and the generated files,
+the umbrella header and the project index of both copies are compared byte by
+byte (the index with the copy's root replaced, since it stores absolute paths).
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def tool_args(tool, root, jobs, extra):
+    return [tool, "--scan", root, "--no-modify-source", "-j", str(jobs),
+            "--umbrella", os.path.join(root, "prefl.gen.h"), *extra]
+
+
+def run(args, root):
+    result = subprocess.run(args, cwd=root, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit(f"{' '.join(args)} failed:\n{result.stdout}{result.stderr}")
+    return result.stdout
+
+
+def outputs(root):
+    files = {}
+    for dirpath, _, names in os.walk(root):
+        for name in names:
+            path = os.path.join(dirpath, name)
+            rel = os.path.relpath(path, root)
+            if name.endswith((".gen.inl", ".refl.bin")) or rel in (
+                    "prefl.gen.h", "prefl.index"):
+                with open(path, "rb") as f:
+                    content = f.read()
+                if rel == "prefl.index":
+                    content = content.replace(
+                        os.path.realpath(root).replace("\\", "/").encode(), b"<root>")
+                files[rel] = content
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("tool")
+    parser.add_argument("source")
+    parser.add_argument("--shards", type=int, default=4)
+    parser.add_argument("-j", "--jobs", type=int, default=1,
+                        help="worker threads of each process")
+    args = parser.parse_args()
+    tool = os.path.abspath(args.tool)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        single = os.path.join(tmp, "single")
+        sharded = os.path.join(tmp, "sharded")
+        shutil.copytree(args.source, single)
+        shutil.copytree(args.source, sharded)
+
+        start = time.perf_counter()
+        run(tool_args(tool, single, args.jobs, []), single)
+        single_time = time.perf_counter() - start
+
+        start = time.perf_counter()
+        shards = [subprocess.Popen(
+            tool_args(tool, sharded, args.jobs, [f"--shard={i}/{args.shards}"]),
+            cwd=sharded, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+            for i in range(args.shards)]
+        for i, shard in enumerate(shards):
+            out, _ = shard.communicate()
+            if shard.returncode != 0:
+                sys.exit(f"shard {i} failed:\n{out}")
+        shard_time = time.perf_counter() - start
+
+        start = time.perf_counter()
+        merge_out = run(tool_args(tool, sharded, args.jobs, ["--merge"]), sharded)
+        merge_time = time.perf_counter() - start
+
+        expected, actual = outputs(single), outputs(sharded)
+        different = sorted(name for name in expected.keys() | actual.keys()
+                           if expected.get(name) != actual.get(name))
+
+    merged = [line for line in merge_out.splitlines()
+              if line.startswith("*** merge")]
+    print(f"single process      {single_time * 1000:10.1f} ms")
+    print(f"{args.shards} shards            {shard_time * 1000:10.1f} ms")
+    print(f"merge               {merge_time * 1000:10.1f} ms  {' '.join(merged)}")
+    print(f"outputs             {len(expected)} files, "
+          + ("identical" if not different else "DIFFERENT: " + ", ".join(different)))
+    return 1 if different else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
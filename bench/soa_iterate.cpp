@@ -0,0 +1,282 @@
+// Field-wise iteration over an array of records (AoS) and over the generated
+// struct-of-arrays container (runtime/PReflSoA.h).
+//
+// Usage: PReflSoABench [particle count] [passes]
+//
+// Each pass integrates the positions (6 of the 10 fields) and sums one field,
+// as particle updates and culling passes do. SoA<Particle> below is written
+// exactly as PupilReflTool generates it for
+//   struct [[META, SOA]] Particle { [[META]] float px; ... };
+
+#include "runtime/PReflSoA.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Bench {
+struct Particle {
+  float px, py, pz;
+  float vx, vy, vz;
+  float color[4];
+  float life;
+  float size;
+  uint32_t id;
+};
+} // namespace Bench
+
+namespace PRefl {
+template<>
+class SoA<Bench::Particle>
+{
+public:
+    using Record = Bench::Particle;
+    size_t Size() const { return m_px.size(); }
+    bool Empty() const { return m_px.empty(); }
+    void Reserve(size_t count) {
+        m_px.reserve(count);
+        m_py.reserve(count);
+        m_pz.reserve(count);
+        m_vx.reserve(count);
+        m_vy.reserve(count);
+        m_vz.reserve(count);
+        m_color.reserve(count);
+        m_life.reserve(count);
+        m_size.reserve(count);
+        m_id.reserve(count);
+    }
+    void Clear() {
+        m_px.clear();
+        m_py.clear();
+        m_pz.clear();
+        m_vx.clear();
+        m_vy.clear();
+        m_vz.clear();
+        m_color.clear();
+        m_life.clear();
+        m_size.clear();
+        m_id.clear();
+    }
+    void Push(const Record &record) {
+        SoADetail::Push(m_px, record.px);
+        SoADetail::Push(m_py, record.py);
+        SoADetail::Push(m_pz, record.pz);
+        SoADetail::Push(m_vx, record.vx);
+        SoADetail::Push(m_vy, record.vy);
+        SoADetail::Push(m_vz, record.vz);
+        SoADetail::Push(m_color, record.color);
+        SoADetail::Push(m_life, record.life);
+        SoADetail::Push(m_size, record.size);
+        SoADetail::Push(m_id, record.id);
+    }
+    void Pop() {
+        m_px.pop_back();
+        m_py.pop_back();
+        m_pz.pop_back();
+        m_vx.pop_back();
+        m_vy.pop_back();
+        m_vz.pop_back();
+        m_color.pop_back();
+        m_life.pop_back();
+        m_size.pop_back();
+        m_id.pop_back();
+    }
+    Record Get(size_t i) const {
+        Record record{};
+        SoADetail::Store(record.px, m_px[i]);
+        SoADetail::Store(record.py, m_py[i]);
+        SoADetail::Store(record.pz, m_pz[i]);
+        SoADetail::Store(record.vx, m_vx[i]);
+        SoADetail::Store(record.vy, m_vy[i]);
+        SoADetail::Store(record.vz, m_vz[i]);
+        SoADetail::Store(record.color, m_color[i]);
+        SoADetail::Store(record.life, m_life[i]);
+        SoADetail::Store(record.size, m_size[i]);
+        SoADetail::Store(record.id, m_id[i]);
+        return record;
+    }
+    void Set(size_t i, const Record &record) {
+        SoADetail::Load(m_px[i], record.px);
+        SoADetail::Load(m_py[i], record.py);
+        SoADetail::Load(m_pz[i], record.pz);
+        SoADetail::Load(m_vx[i], record.vx);
+        SoADetail::Load(m_vy[i], record.vy);
+        SoADetail::Load(m_vz[i], record.vz);
+        SoADetail::Load(m_color[i], record.color);
+        SoADetail::Load(m_life[i], record.life);
+        SoADetail::Load(m_size[i], record.size);
+        SoADetail::Load(m_id[i], record.id);
+    }
+    static SoA FromAoS(const Record *records, size_t count) {
+        SoA soa;
+        soa.m_px.resize(count);
+        soa.m_py.resize(count);
+        soa.m_pz.resize(count);
+        soa.m_vx.resize(count);
+        soa.m_vy.resize(count);
+        soa.m_vz.resize(count);
+        soa.m_color.resize(count);
+        soa.m_life.resize(count);
+        soa.m_size.resize(count);
+        soa.m_id.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_px[i], records[i].px);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_py[i], records[i].py);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_pz[i], records[i].pz);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_vx[i], records[i].vx);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_vy[i], records[i].vy);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_vz[i], records[i].vz);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_color[i], records[i].color);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_life[i], records[i].life);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_size[i], records[i].size);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_id[i], records[i].id);
+        return soa;
+    }
+    void ToAoS(Record *records) const {
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].px, m_px[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].py, m_py[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].pz, m_pz[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].vx, m_vx[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].vy, m_vy[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].vz, m_vz[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].color, m_color[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].life, m_life[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].size, m_size[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].id, m_id[i]);
+    }
+    std::span<SoADetail::ElementT<decltype(Record::px)>> px() { return m_px; }
+    std::span<const SoADetail::ElementT<decltype(Record::px)>> px() const { return m_px; }
+    std::span<SoADetail::ElementT<decltype(Record::py)>> py() { return m_py; }
+    std::span<const SoADetail::ElementT<decltype(Record::py)>> py() const { return m_py; }
+    std::span<SoADetail::ElementT<decltype(Record::pz)>> pz() { return m_pz; }
+    std::span<const SoADetail::ElementT<decltype(Record::pz)>> pz() const { return m_pz; }
+    std::span<SoADetail::ElementT<decltype(Record::vx)>> vx() { return m_vx; }
+    std::span<const SoADetail::ElementT<decltype(Record::vx)>> vx() const { return m_vx; }
+    std::span<SoADetail::ElementT<decltype(Record::vy)>> vy() { return m_vy; }
+    std::span<const SoADetail::ElementT<decltype(Record::vy)>> vy() const { return m_vy; }
+    std::span<SoADetail::ElementT<decltype(Record::vz)>> vz() { return m_vz; }
+    std::span<const SoADetail::ElementT<decltype(Record::vz)>> vz() const { return m_vz; }
+    std::span<SoADetail::ElementT<decltype(Record::color)>> color() { return m_color; }
+    std::span<const SoADetail::ElementT<decltype(Record::color)>> color() const { return m_color; }
+    std::span<SoADetail::ElementT<decltype(Record::life)>> life() { return m_life; }
+    std::span<const SoADetail::ElementT<decltype(Record::life)>> life() const { return m_life; }
+    std::span<SoADetail::ElementT<decltype(Record::size)>> size() { return m_size; }
+    std::span<const SoADetail::ElementT<decltype(Record::size)>> size() const { return m_size; }
+    std::span<SoADetail::ElementT<decltype(Record::id)>> id() { return m_id; }
+    std::span<const SoADetail::ElementT<decltype(Record::id)>> id() const { return m_id; }
+private:
+    std::vector<SoADetail::ElementT<decltype(Record::px)>> m_px;
+    std::vector<SoADetail::ElementT<decltype(Record::py)>> m_py;
+    std::vector<SoADetail::ElementT<decltype(Record::pz)>> m_pz;
+    std::vector<SoADetail::ElementT<decltype(Record::vx)>> m_vx;
+    std::vector<SoADetail::ElementT<decltype(Record::vy)>> m_vy;
+    std::vector<SoADetail::ElementT<decltype(Record::vz)>> m_vz;
+    std::vector<SoADetail::ElementT<decltype(Record::color)>> m_color;
+    std::vector<SoADetail::ElementT<decltype(Record::life)>> m_life;
+    std::vector<SoADetail::ElementT<decltype(Record::size)>> m_size;
+    std::vector<SoADetail::ElementT<decltype(Record::id)>> m_id;
+};
+} // namespace PRefl
+
+using namespace PRefl;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// keep the compiler from folding the loops away
+volatile float s_sink;
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  size_t passes = argc > 2 ? std::stoul(argv[2]) : 50;
+  const float dt = 1.f / 60.f;
+
+  std::vector<Bench::Particle> particles(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto &p = particles[i];
+    p.px = p.py = p.pz = static_cast<float>(i % 1000);
+    p.vx = 1.f;
+    p.vy = 0.5f;
+    p.vz = -0.25f;
+    p.life = static_cast<float>(i % 97);
+    p.size = 1.f;
+    p.id = static_cast<uint32_t>(i);
+  }
+
+  auto start = Clock::now();
+  auto soa = SoA<Bench::Particle>::FromAoS(particles.data(), count);
+  double fromTime = Seconds(start);
+
+  // AoS
+  float sum = 0.f;
+  start = Clock::now();
+  for (size_t pass = 0; pass < passes; ++pass) {
+    for (auto &p : particles) {
+      p.px += p.vx * dt;
+      p.py += p.vy * dt;
+      p.pz += p.vz * dt;
+    }
+    for (auto &p : particles)
+      sum += p.life;
+  }
+  double aosTime = Seconds(start);
+  s_sink = sum;
+
+  // SoA, one span per field
+  sum = 0.f;
+  start = Clock::now();
+  for (size_t pass = 0; pass < passes; ++pass) {
+    auto px = soa.px(), py = soa.py(), pz = soa.pz();
+    auto vx = soa.vx(), vy = soa.vy(), vz = soa.vz();
+    for (size_t i = 0; i < count; ++i) {
+      px[i] += vx[i] * dt;
+      py[i] += vy[i] * dt;
+      pz[i] += vz[i] * dt;
+    }
+    for (float life : soa.life())
+      sum += life;
+  }
+  double soaTime = Seconds(start);
+  s_sink = sum;
+
+  start = Clock::now();
+  soa.ToAoS(particles.data());
+  double toTime = Seconds(start);
+  s_sink = particles[count / 2].px;
+
+  auto ns = [count, passes](double seconds) {
+    return seconds * 1e9 / (count * passes);
+  };
+  std::printf("particles %zu (%zu bytes each), passes %zu\n", count,
+              sizeof(Bench::Particle), passes);
+  std::printf("AoS iteration                 %8.3f ns/particle\n", ns(aosTime));
+  std::printf("SoA iteration                 %8.3f ns/particle\n", ns(soaTime));
+  std::printf("FromAoS                       %8.3f ms\n", fromTime * 1e3);
+  std::printf("ToAoS                         %8.3f ms\n", toTime * 1e3);
+  return 0;
+}
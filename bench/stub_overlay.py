@@ -0,0 +1,60 @@
+"""Parse time per header with and without the --stubs overlay.
+
+Usage: python stub_overlay.py <PupilReflTool> <stubs config> <header>... [--runs N]
+
+Every header is regenerated `runs` times in each mode (the header is touched
+before a run so the modification time check does not skip it). The median
+parse time reported by --stats is printed, and the generated files of both
+modes are compared byte by byte.
+"""
+import argparse
+import os
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+STATS = re.compile(r"\*\*\* stats: parse ([0-9.]+) ms")
+
+
+def generated_path(header):
+    stem = os.path.splitext(os.path.basename(header))[0]
+    return os.path.join(os.path.dirname(header), "generated", stem + ".gen.inl")
+
+
+def run(tool, header, extra):
+    os.utime(header, (time.time(), time.time()))
+    out = subprocess.run([tool, "--no-modify-source", "--stats", *extra, header],
+                         check=True, capture_output=True, text=True).stdout
+    match = STATS.search(out)
+    if not match:
+        sys.exit("no stats in tool output:\n" + out)
+    with open(generated_path(header), "rb") as f:
+        return float(match.group(1)), f.read()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("tool")
+    parser.add_argument("stubs")
+    parser.add_argument("headers", nargs="+")
+    parser.add_argument("--runs", type=int, default=5)
+    args = parser.parse_args()
+
+    print(f"{'header':40} {'real ms':>10} {'stub ms':>10} {'speedup':>8}  output")
+    for header in args.headers:
+        real, stub = [], []
+        real_out = stub_out = None
+        for _ in range(args.runs):
+            ms, real_out = run(args.tool, header, [])
+            real.append(ms)
+            ms, stub_out = run(args.tool, header, ["--stubs", args.stubs])
+            stub.append(ms)
+        r, s = statistics.median(real), statistics.median(stub)
+        same = "identical" if real_out == stub_out else "DIFFERENT"
+        print(f"{os.path.basename(header):40} {r:10.1f} {s:10.1f} {r / s:7.2f}x  {same}")
+
+
+if __name__ == "__main__":
+    main()
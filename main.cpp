@@ -1,131 +1,434 @@
+#include <algorithm>
+#include <chrono>
 #include <string>
-#include <memory>
 #include <vector>
 #include <filesystem>
 #include <iostream>
-
-#include "clang/AST/AST.h"
-#include "clang/AST/ASTConsumer.h"
-#include "clang/AST/RecursiveASTVisitor.h"
-#include "clang/Frontend/ASTConsumers.h"
-#include "clang/Frontend/CompilerInstance.h"
-#include "clang/Frontend/FrontendActions.h"
-#include "clang/Tooling/CommonOptionsParser.h"
-#include "clang/Tooling/Tooling.h"
+#include <limits>
+#include <map>
+#include <set>
 
 #include "Generator.h"
-#include "Visitor.h"
+#include "Scanner.h"
+#include "Tool.h"
+#include "Watcher.h"
+#include "llvm/Support/xxhash.h"
 
-using namespace clang;
-using namespace clang::driver;
-using namespace clang::tooling;
+// Editors write a file in several steps, wait until they are done.
+static const unsigned s_watchDebounceMs = 100;
 
-static llvm::cl::OptionCategory s_toolingCategory("Tooling Sample");
+// The umbrella of the project, or with --umbrella-per-dir one umbrella per
+// generated/ directory, so a TU which force-includes the umbrella of its own
+// directory is not rebuilt when a header of another directory is regenerated.
+void WriteUmbrellas(const PReflTool::Options &options,
+                    const std::vector<std::filesystem::path> &generatedFiles) {
+  if (!options.umbrellaPerDir) {
+    PReflTool::Generator::WriteUmbrella(options.umbrella, generatedFiles);
+    return;
+  }
+  std::map<std::filesystem::path, std::vector<std::filesystem::path>> dirs;
+  for (auto &file : generatedFiles) {
+    auto path = std::filesystem::absolute(file).lexically_normal();
+    dirs[path.parent_path()].push_back(path);
+  }
+  for (auto &[dir, files] : dirs)
+    PReflTool::Generator::WriteUmbrella(dir / options.umbrella.filename(),
+                                        files);
+}
 
-class Analyzer : public clang::ASTConsumer {
-  PReflTool::Visitor m_visitor;
+// Keep the tool resident and regenerate the headers affected by each change.
+// Options, stubs and the index stay loaded between the events; no clang state
+// is kept, each event parses the affected headers from scratch.
+int RunWatch(std::vector<PReflTool::ToolOutput> processed,
+             PReflTool::Tool &tool, const std::filesystem::path &indexFile,
+             const std::filesystem::path &profileFile) {
+  PReflTool::Watcher watcher{s_watchDebounceMs};
+  if (!watcher.IsSupported()) {
+    std::cerr << "*** error : --watch is not supported on this platform\n";
+    return 1;
+  }
 
-public:
-  Analyzer(clang::SourceManager &sm, PReflTool::Generator *g)
-      : m_visitor(sm, g) {}
+  // watched file -> targets which have to be regenerated when it changes
+  std::map<std::string, std::set<std::string>> dependents;
+  std::map<std::string, PReflTool::ToolOutput> targets;
+  auto track = [&](PReflTool::ToolOutput file) {
+    // only the paths are needed between the events
+    file.records.clear();
+    file.enums.clear();
+    if (auto it = targets.find(file.target); it != targets.end()) {
+      for (auto &dep : it->second.dependencies)
+        dependents[dep].erase(file.target);
+    }
+    dependents[file.target].insert(file.target);
+    watcher.Watch(file.target);
+    for (auto &dep : file.dependencies) {
+      dependents[dep].insert(file.target);
+      watcher.Watch(dep);
+    }
+    targets[file.target] = std::move(file);
+  };
+  for (auto &file : processed)
+    track(std::move(file));
+
+  std::cout << "*** watching " << dependents.size() << " files for "
+            << targets.size() << " targets\n";
 
-  void HandleTranslationUnit(clang::ASTContext &context) final {
-    auto decls = context.getTranslationUnitDecl()->decls();
-    auto &sm = m_visitor.GetSourceManager();
+  // files are regenerated even if the target itself is older than the output
+  tool.GetOptions().force = true;
 
-    for (auto &decl : decls) {
-      const auto &fileID = sm.getFileID(decl->getLocation());
-      // Filter out decls in the include files.
-      if (fileID != sm.getMainFileID())
-        continue;
+  PReflTool::Watcher::Batch batch;
+  while (watcher.Wait(batch)) {
+    std::set<std::string> affected;
+    for (auto &file : batch.files) {
+      auto it = dependents.find(file);
+      if (it != dependents.end())
+        affected.insert(it->second.begin(), it->second.end());
+    }
+    if (affected.empty())
+      continue;
+
+    std::vector<std::string> files{affected.begin(), affected.end()};
+    for (auto &file : tool.Run(files, true))
+      track(std::move(file));
+    auto end = PReflTool::Watcher::Clock::now();
+    // the errors are printed, wait for the next change
+    if (!tool.Succeeded())
+      continue;
 
-      m_visitor.Visit(decl);
+    if (!indexFile.empty() && !tool.SaveIndex(indexFile))
+      std::cerr << "*** error : can not write " << indexFile.string() << "\n";
+    if (!profileFile.empty())
+      tool.SaveProfile(profileFile);
+    if (!tool.GetOptions().umbrella.empty()) {
+      std::vector<std::filesystem::path> generatedFiles;
+      for (auto &[target, file] : targets)
+        generatedFiles.push_back(file.generated);
+      WriteUmbrellas(tool.GetOptions(), generatedFiles);
     }
+
+    std::chrono::duration<double, std::milli> latency = end - batch.firstEvent;
+    std::cout << "*** watch: " << batch.files.size() << " changed, "
+              << files.size() << " regenerated, " << latency.count()
+              << " ms from save to output (debounce " << s_watchDebounceMs
+              << " ms)\n";
   }
-};
+  std::cerr << "*** error : watching files failed\n";
+  return 1;
+}
 
-class AnalyzerAction : public clang::ASTFrontendAction {
-  PReflTool::Generator *m_generator;
+const std::filesystem::path TEST_DIR = CMAKE_DEF_PREFLTOOL_DEFAULT;
 
-public:
-  AnalyzerAction(PReflTool::Generator *g) : m_generator(g) {}
+// Keep the headers of shard `shard` of `shardCnt`. The partition hashes the
+// path relative to the working directory, so every shard started from the
+// same directory agrees on it, even on machines with different checkouts.
+std::vector<std::string> SelectShard(const std::vector<std::string> &files,
+                                     unsigned shard, unsigned shardCnt) {
+  std::filesystem::path cwd =
+      PReflTool::ProjectIndex::NormalizePath(std::filesystem::current_path());
+  std::vector<std::string> selected;
+  for (auto &file : files) {
+    // the same header reached through different paths stays in one shard
+    std::filesystem::path path = PReflTool::ProjectIndex::NormalizePath(file);
+    auto relative = path.lexically_relative(cwd);
+    auto key = relative.empty() ? path.generic_string()
+                                : relative.generic_string();
+    if (llvm::xxHash64(key) % shardCnt == shard)
+      selected.push_back(file);
+  }
+  return selected;
+}
 
-  std::unique_ptr<clang::ASTConsumer>
-  CreateASTConsumer(clang::CompilerInstance &ci, clang::StringRef) final {
-    ci.getDiagnostics().setClient(new IgnoringDiagConsumer());
-    return std::unique_ptr<clang::ASTConsumer>(
-        new Analyzer(ci.getSourceManager(), m_generator));
+bool ParseShard(const std::string &value, unsigned &shard,
+                unsigned &shardCnt) {
+  auto slash = value.find('/');
+  if (slash == std::string::npos)
+    return false;
+  try {
+    shard = static_cast<unsigned>(std::stoul(value.substr(0, slash)));
+    shardCnt = static_cast<unsigned>(std::stoul(value.substr(slash + 1)));
+  } catch (const std::exception &) {
+    return false;
   }
-};
+  return shardCnt > 0 && shard < shardCnt;
+}
 
-std::unique_ptr<FrontendActionFactory>
-NewAnalyzerActionFactory(PReflTool::Generator *g) {
-  class AnalyzerActionFactory : public FrontendActionFactory {
-    PReflTool::Generator *m_generator;
+bool ParseCount(const std::string &value, size_t &count) {
+  // stoull accepts a sign and wraps negative values around
+  if (value.empty() || value[0] == '-' || value[0] == '+')
+    return false;
+  try {
+    size_t end = 0;
+    count = static_cast<size_t>(std::stoull(value, &end));
+    return end == value.size();
+  } catch (const std::exception &) {
+    return false;
+  }
+}
 
-  public:
-    AnalyzerActionFactory(PReflTool::Generator *g) : m_generator(g) {}
+void PrintUsage() {
+  std::cout << "Usage: PupilReflTool [options] <file>...\n"
+            << "  --scan <dir>        find reflected headers under <dir>\n"
+            << "  --manifest <file>   manifest written by --scan (default: "
+               "<dir>/prefl.manifest),\n"
+            << "                      or read when --scan is not given\n"
+            << "  -j <n>              number of worker threads (default: "
+               "hardware threads,\n"
+            << "                      headers are parsed one at a time "
+               "without -j or a\n"
+            << "                      --memory-budget)\n"
+            << "  --no-modify-source  never append the generated include to "
+               "target files\n"
+            << "  --umbrella <file>   write one header including all "
+               "generated files\n"
+            << "  --umbrella-per-dir <name>\n"
+            << "                      write a header <name> including the "
+               "generated files of\n"
+            << "                      each generated/ directory\n"
+            << "  --stubs <file>      replace heavy headers by the stubs "
+               "declared in <file>\n"
+            << "  --schema            also write the binary schema "
+               "(xxx.refl.bin)\n"
+            << "  --registry          register the records in the runtime "
+               "registry\n"
+            << "  --json              also generate a JSON writer and reader "
+               "per record\n"
+            << "  --hash              also generate a Hasher per record\n"
+            << "  --kernels           also generate ClampToRange and "
+               "SnapToStep for the records\n"
+            << "                      with RANGE or STEP fields\n"
+            << "  --pooled-names      name fields and attributes by their "
+               "index in one table per\n"
+            << "                      record instead of a Name<> "
+               "instantiation each\n"
+            << "  --gpu-layout <std140|std430>\n"
+            << "                      also generate a GPU buffer block and "
+               "PackTo per record\n"
+            << "  --force             regenerate files which are up to date\n"
+            << "  --no-cache          do not read or write the IR cache\n"
+            << "  --index <file>      project index of reflected records "
+               "(default with --scan:\n"
+            << "                      <dir>/prefl.index)\n"
+            << "  --query <type>      print the headers reflecting <type> "
+               "and exit\n"
+            << "  --specializations <file>\n"
+            << "                      also generate full specializations "
+               "for the templates\n"
+            << "                      arguments listed in <file>\n"
+            << "  --stats             print parse and generation time of "
+               "each file\n"
+            << "  --memory-budget <MB>\n"
+            << "                      only start parses while their expected "
+               "memory fits\n"
+            << "  --memory-profile <file>\n"
+            << "                      peak memory of each header from the "
+               "earlier runs\n"
+            << "                      (default with --scan: "
+               "<dir>/prefl.memory)\n"
+            << "  --watch             keep running and regenerate the files "
+               "whose sources or\n"
+            << "                      included headers are modified\n"
+            << "  --unity <n>         parse <n> headers in one translation "
+               "unit (default: 1)\n"
+            << "  --shard <i>/<n>     only extract the records of shard i "
+               "(0 based) of n into\n"
+            << "                      the IR caches\n"
+            << "  --merge             generate the outputs of the shards\n"
+            << "Options with a value also accept --option=<value>.\n";
+}
+
+int main(int argc, char** args) {
+  std::vector<std::string> files;
+  std::filesystem::path scanDir;
+  std::filesystem::path manifest;
+  PReflTool::Options options;
+  std::filesystem::path stubConfig;
+  std::filesystem::path indexFile;
+  std::string query;
+  std::filesystem::path specConfig;
+  bool watch = false;
+  size_t memoryBudget = 0; // MB
+  std::filesystem::path profileFile;
+  unsigned shard = 0;
+  unsigned shardCnt = 0; // 0 when the run is not sharded
 
-    std::unique_ptr<FrontendAction> create() override {
-      return std::make_unique<AnalyzerAction>(m_generator);
+  for (int i = 1; i < argc; i++) {
+    std::string arg{args[i]};
+    std::string value;
+    bool hasValue = false;
+    if (auto eq = arg.find('='); arg.rfind("--", 0) == 0 && eq != arg.npos) {
+      value = arg.substr(eq + 1);
+      arg.resize(eq);
+      hasValue = true;
     }
-  };
+    if (arg == "--scan" || arg == "--manifest" || arg == "-j" ||
+        arg == "--umbrella" || arg == "--umbrella-per-dir" ||
+        arg == "--stubs" || arg == "--index" || arg == "--query" ||
+        arg == "--specializations" || arg == "--memory-budget" ||
+        arg == "--memory-profile" || arg == "--unity" || arg == "--shard" ||
+        arg == "--gpu-layout") {
+      if (!hasValue && i + 1 >= argc) {
+        std::cerr << "*** error : missing value of " << arg << "\n";
+        PrintUsage();
+        return 1;
+      }
+      if (!hasValue)
+        value = args[++i];
+      if (arg == "--scan")
+        scanDir = value;
+      else if (arg == "--manifest")
+        manifest = value;
+      else if (arg == "--umbrella" || arg == "--umbrella-per-dir") {
+        options.umbrella = value;
+        options.umbrellaPerDir = arg == "--umbrella-per-dir";
+      }
+      else if (arg == "--stubs")
+        stubConfig = value;
+      else if (arg == "--index")
+        indexFile = value;
+      else if (arg == "--query")
+        query = value;
+      else if (arg == "--specializations")
+        specConfig = value;
+      else if (arg == "--memory-profile")
+        profileFile = value;
+      else if (arg == "--gpu-layout") {
+        if (value == "std140")
+          options.gpuLayout = PReflTool::Options::EGpuLayout::Std140;
+        else if (value == "std430")
+          options.gpuLayout = PReflTool::Options::EGpuLayout::Std430;
+        else {
+          std::cerr << "*** error : invalid GPU layout " << value
+                    << ", expected std140 or std430\n";
+          return 1;
+        }
+      }
+      else if (arg == "--shard") {
+        if (!ParseShard(value, shard, shardCnt)) {
+          std::cerr << "*** error : invalid shard " << value
+                    << ", expected <i>/<n> with i < n\n";
+          return 1;
+        }
+      }
+      else {
+        // the budget is converted from MB to bytes
+        size_t maxCount = arg == "--memory-budget"
+                              ? std::numeric_limits<size_t>::max() /
+                                    (1024 * 1024)
+                              : std::numeric_limits<unsigned>::max();
+        size_t count = 0;
+        if (!ParseCount(value, count) || count > maxCount) {
+          std::cerr << "*** error : invalid value " << value << " of " << arg
+                    << ", expected a non negative integer\n";
+          PrintUsage();
+          return 1;
+        }
+        if (arg == "--memory-budget")
+          memoryBudget = count;
+        else if (arg == "--unity")
+          options.unityBatch = static_cast<unsigned>(count);
+        else
+          options.jobs = static_cast<unsigned>(count);
+      }
+    } else if (arg == "--no-modify-source") {
+      options.modifySource = false;
+    } else if (arg == "--schema") {
+      options.emitSchema = true;
+    } else if (arg == "--force") {
+      options.force = true;
+    } else if (arg == "--no-cache") {
+      options.useIRCache = false;
+    } else if (arg == "--registry") {
+      options.emitRegistry = true;
+    } else if (arg == "--json") {
+      options.emitJson = true;
+    } else if (arg == "--hash") {
+      options.emitHash = true;
+    } else if (arg == "--kernels") {
+      options.emitKernels = true;
+    } else if (arg == "--pooled-names") {
+      options.pooledNames = true;
+    } else if (arg == "--stats") {
+      options.stats = true;
+    } else if (arg == "--watch") {
+      watch = true;
+    } else if (arg == "--merge") {
+      options.merge = true;
+    } else if (arg == "-h" || arg == "--help") {
+      PrintUsage();
+      return 0;
+    } else {
+      files.push_back(arg);
+    }
+  }
 
-  return std::unique_ptr<FrontendActionFactory>(new AnalyzerActionFactory(g));
-}
+  // the dependencies of up to date headers are only known by their IR cache
+  if (watch && !options.useIRCache) {
+    std::cerr << "*** error : --watch can not be used with --no-cache\n";
+    return 1;
+  }
 
-void RunTool(std::string file) {
-  PReflTool::Generator generator{file};
-  if (generator.CheckModifyTime()) {
-    std::cout << generator.GetGeneratedFilePath().stem()
-              << "'s reflection file does not need to be regenerated.\n";
-    return;
+  if (shardCnt > 0) {
+    if (options.merge || watch || !options.useIRCache) {
+      std::cerr << "*** error : --shard can not be used with --merge, "
+                   "--watch or --no-cache\n";
+      return 1;
+    }
+    options.extractOnly = true;
   }
-  const char *args[] = {
-      "",
-      file.data(),
-      "--",
-      "-xc++",
-      "-D",
-      PReflTool::MetaAnnotate::GetMarco(),
-      "-D",
-      PReflTool::RangeAnnotate::GetMarco(),
-      "-D",
-      PReflTool::InfoAnnotate::GetMarco(),
-      "-D",
-      PReflTool::StepAnnotate::GetMarco(),
-      "INFO(str)=clang::annotate(\"info\", str)",
-      "-std=c++20",                     // use c++ 20
-      "-Wno-pragma-once-outside-header" // ignore #pragma once warning
-  };
-  int argc = _countof(args);
-  auto expectedParser =
-      CommonOptionsParser::create(argc, args, s_toolingCategory);
 
-  if (!expectedParser) {
-    // Fail gracefully for unsupported options.
-    llvm::errs() << expectedParser.takeError();
-    return;
+  if (indexFile.empty() && !scanDir.empty())
+    indexFile = scanDir / "prefl.index";
+  if (profileFile.empty() && !scanDir.empty())
+    profileFile = scanDir / "prefl.memory";
+
+  PReflTool::Tool tool{options, memoryBudget * 1024 * 1024};
+  if (!indexFile.empty())
+    tool.LoadIndex(indexFile);
+
+  if (!query.empty()) {
+    if (auto *index = tool.GetIndex()) {
+      for (auto &header : index->FindHeaders(query))
+        std::cout << header << "\n";
+    }
+    return 0;
+  }
+
+  if (!specConfig.empty() &&
+      !PReflTool::Generator::LoadSpecializations(
+          specConfig, tool.GetOptions().specializations)) {
+    std::cerr << "*** error : can not open " << specConfig.string() << "\n";
+    return 1;
   }
 
-  CommonOptionsParser &optionsParser = expectedParser.get();
-  ClangTool tool(optionsParser.getCompilations(),
-                 optionsParser.getSourcePathList());
+  if (!stubConfig.empty() && !tool.LoadStubs(stubConfig))
+    return 1;
 
-  tool.run(NewAnalyzerActionFactory(&generator).get());
-  generator.Generate();
-}
+  if (!scanDir.empty()) {
+    if (manifest.empty())
+      manifest = scanDir / "prefl.manifest";
 
-const std::filesystem::path TEST_DIR = CMAKE_DEF_PREFLTOOL_DEFAULT;
+    PReflTool::Scanner scanner{tool.GetOptions().jobs};
+    auto headers = scanner.Scan(scanDir);
+    const auto &stats = scanner.GetStats();
+    double seconds = std::max(stats.seconds, 1e-9);
+    std::cout << "*** scan: " << stats.matched << " of " << stats.files
+              << " headers reflected, "
+              << static_cast<size_t>(stats.files / seconds) << " files/s, "
+              << stats.bytes / seconds / (1024. * 1024. * 1024.)
+              << " GB/s\n";
 
-int main(int argc, char** args) {
-  std::vector<std::string> files;
+    // the shards scan the same tree, only one process writes the manifest
+    if (!options.extractOnly &&
+        !PReflTool::Scanner::WriteManifest(manifest, headers))
+      std::cerr << "*** error : can not write " << manifest.string() << "\n";
+    for (auto &header : headers)
+      files.push_back(header.string());
+  } else if (!manifest.empty()) {
+    for (auto &header : PReflTool::Scanner::ReadManifest(manifest))
+      files.push_back(header.string());
+  }
 
-  if (argc > 1) {
-    files.reserve(static_cast<size_t>(argc) - 1);
-    for (int i = 1; i < argc; i++)
-      files.push_back(std::string{args[i]});
-  } else {
+  if (files.empty() && scanDir.empty() && manifest.empty()) {
 #if defined(DEBUG) || defined(_DEBUG)
     files.resize(1);
     files[0] = (TEST_DIR / "test/test.h").string();
@@ -135,15 +438,43 @@ int main(int argc, char** args) {
 #endif // DEBUG
   }
 
-  for (auto &fileName : files) {
-    std::filesystem::path filePath{fileName};
-    if (std::filesystem::exists(filePath)) {
-      filePath.make_preferred();
-      std::cout << "*** start file: " << filePath.string().data() << "\n";
-      RunTool(filePath.string());
-    } else {
-      std::cerr << "*** error : " << fileName << " does not exist\n";
-    }
+  if (options.extractOnly) {
+    size_t total = files.size();
+    files = SelectShard(files, shard, shardCnt);
+    std::cout << "*** shard " << shard << "/" << shardCnt << ": "
+              << files.size() << " of " << total << " headers\n";
+    if (files.empty())
+      return 0;
   }
+
+  if (!profileFile.empty())
+    tool.LoadProfile(profileFile);
+  auto processed = tool.Run(files, watch);
+  if (!tool.Succeeded())
+    return 1;
+  // the index, umbrella and profile are written once by --merge
+  if (options.extractOnly)
+    return 0;
+
+  std::vector<std::filesystem::path> generatedFiles;
+  for (auto &file : processed)
+    generatedFiles.push_back(file.generated);
+  if (!indexFile.empty() && !tool.SaveIndex(indexFile))
+    std::cerr << "*** error : can not write " << indexFile.string() << "\n";
+  if (!options.umbrella.empty())
+    WriteUmbrellas(options, generatedFiles);
+  if (!profileFile.empty() && !tool.SaveProfile(profileFile))
+    std::cerr << "*** error : can not write " << profileFile.string() << "\n";
+
+  std::cout << "*** memory: peak "
+            << PReflTool::BatchScheduler::GetPeakProcessMemory() /
+                   (1024 * 1024)
+            << " MB";
+  if (memoryBudget > 0)
+    std::cout << " (budget " << memoryBudget << " MB)";
+  std::cout << "\n";
+
+  if (watch)
+    return RunWatch(std::move(processed), tool, indexFile, profileFile);
   return 0;
 }
@@ -0,0 +1,110 @@
+#pragma once
+
+// Enum reflection support for the code generated by PupilReflTool.
+// Header only, no dependency besides the standard library.
+//
+// For an enum annotated with [[META]] the tool generates EnumData<E>:
+//   count              number of enumerators
+//   min, max           smallest and largest value
+//   entries            value and name of each enumerator, in declaration order
+//   isDense            values are contiguous, names are indexed by value - min
+//   names              (dense only) name of each value in [min, max]
+//   valueIndex         (sparse only) perfect hash of the values into entries
+//   nameIndex          perfect hash of the names into entries
+// Every lookup below is constant time and usable in constant expressions.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace PRefl {
+
+template <typename E> struct EnumData;
+
+template <typename E> struct EnumEntry {
+  E value;
+  std::string_view name;
+};
+
+namespace EnumDetail {
+// splitmix64 finalizer
+constexpr uint64_t Mix(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+// FNV-1a
+constexpr uint64_t Hash(std::string_view str) {
+  uint64_t h = 14695981039346656037ull;
+  for (char c : str) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 1099511628211ull;
+  }
+  return Mix(h);
+}
+
+constexpr uint64_t Hash(uint64_t value) { return Mix(value); }
+
+template <typename E> constexpr uint64_t ToBits(E value) {
+  return static_cast<uint64_t>(static_cast<std::underlying_type_t<E>>(value));
+}
+} // namespace EnumDetail
+
+// Perfect hash (hash and displace) of a fixed key set. The key hash selects a
+// bucket, the displacement of the bucket moves its keys into free slots.
+// B and S are powers of two. A slot holds the entry index + 1, 0 is empty.
+template <size_t B, size_t S> struct EnumHashIndex {
+  std::array<uint32_t, B> displacements;
+  std::array<uint32_t, S> slots;
+
+  constexpr static uint64_t Slot(uint64_t hash, uint32_t displacement) {
+    return EnumDetail::Mix(hash ^ displacement) & (S - 1);
+  }
+
+  // Index into entries of the candidate for `hash`, or -1. The caller has to
+  // compare the key, since a missing key may land on any slot.
+  constexpr ptrdiff_t Find(uint64_t hash) const {
+    auto slot = slots[Slot(hash, displacements[hash & (B - 1)])];
+    return static_cast<ptrdiff_t>(slot) - 1;
+  }
+};
+
+template <typename E> constexpr size_t EnumCount() {
+  return EnumData<E>::count;
+}
+
+template <typename E> constexpr std::string_view EnumToName(E value) {
+  using Data = EnumData<E>;
+  if constexpr (Data::isDense) {
+    auto offset = EnumDetail::ToBits(value) - EnumDetail::ToBits(Data::min);
+    return offset < Data::names.size() ? Data::names[offset]
+                                       : std::string_view{};
+  } else {
+    auto hash = EnumDetail::Hash(EnumDetail::ToBits(value));
+    auto index = Data::valueIndex.Find(hash);
+    if (index < 0 || Data::entries[index].value != value)
+      return {};
+    return Data::entries[index].name;
+  }
+}
+
+template <typename E>
+constexpr std::optional<E> EnumFromName(std::string_view name) {
+  using Data = EnumData<E>;
+  auto index = Data::nameIndex.Find(EnumDetail::Hash(name));
+  if (index < 0 || Data::entries[index].name != name)
+    return std::nullopt;
+  return Data::entries[index].value;
+}
+
+template <typename E> constexpr bool EnumContains(E value) {
+  return !EnumToName(value).empty();
+}
+} // namespace PRefl
@@ -0,0 +1,90 @@
+#pragma once
+
+// Packing of the reflected records into GPU buffers, used by the GpuBlock<T>
+// specializations PupilReflTool generates with --gpu-layout std140|std430.
+// Header only, no dependency besides the standard library.
+//
+// The tool computes the std140 or std430 layout of each record from the
+// fields and types clang sees, as GLSL and HLSL (-fvk-use-gl-layout) place a
+// block of the same members:
+//   scalars      float, double, bool (as a 32 bit integer), 32 bit integers
+//                and enums of them
+//   vectors      records of 2 to 4 components named x, y, z(, w) or r, g,
+//                b(, a), without padding (glm, DirectXMath, ...)
+//   matrices     records holding one array of 2 to 4 column vectors or one
+//                two dimensional array m[column][row], column major
+//   structs      other records of public fields of these types
+//   arrays       one dimension of any of the above
+// Records with other fields get no block.
+//
+//   static_assert(GpuBlock<Light>::size == 48);
+//   static_assert(GpuBlock<Light>::members[1].offset == 16);
+//   PackTo(light, mapped);
+//   PackArrayTo(lights.data(), lights.size(), mapped);
+// PackTo copies each run of fields which is contiguous on the CPU and in the
+// block with one memcpy, and the rest field by field. Padding bytes of the
+// destination are left as they are.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace PRefl {
+
+enum class EGpuLayout { Std140, Std430 };
+
+// A reflected field in the block, in bytes.
+struct GpuMember {
+  std::string_view name;
+  size_t offset;
+  size_t size;
+};
+
+// Specialized for each reflected record by the generated files:
+//   constexpr static EGpuLayout layout;
+//   constexpr static size_t size, align;
+//   constexpr static std::array<GpuMember, N> members;
+//   template <typename Record>
+//   static void PackTo(const Record &record, void *dst);
+template <typename T> struct GpuBlock;
+
+namespace GpuDetail {
+template <typename T> const unsigned char *Bytes(const T &value) {
+  return reinterpret_cast<const unsigned char *>(std::addressof(value));
+}
+
+// The bytes begin..end of the record are `size` bytes. The layout of the
+// consumer compiler may differ from the one seen by clang, the check folds to
+// a constant.
+inline bool IsRun(const unsigned char *begin, const unsigned char *end,
+                  size_t size) {
+  return static_cast<size_t>(end - begin) == size;
+}
+
+// bool is one byte on the CPU and a 32 bit integer in the block.
+inline void PackBools(unsigned char *dst, const unsigned char *src,
+                      size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t value = src[i] != 0;
+    std::memcpy(dst + i * sizeof(value), &value, sizeof(value));
+  }
+}
+} // namespace GpuDetail
+
+// dst holds at least GpuBlock<T>::size bytes.
+template <typename T> void PackTo(const T &record, void *dst) {
+  GpuBlock<T>::PackTo(record, dst);
+}
+
+// Blocks are placed one after the other, their size is a multiple of their
+// alignment. dst holds at least count * GpuBlock<T>::size bytes.
+template <typename T>
+void PackArrayTo(const T *records, size_t count, void *dst) {
+  auto *out = static_cast<unsigned char *>(dst);
+  for (size_t i = 0; i < count; ++i)
+    GpuBlock<T>::PackTo(records[i], out + i * GpuBlock<T>::size);
+}
+} // namespace PRefl
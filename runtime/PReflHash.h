@@ -0,0 +1,174 @@
+#pragma once
+
+// Hashing of the reflected records, used by the Hasher<T> specializations
+// generated by PupilReflTool.
+// Header only, no dependency besides the standard library.
+//
+// Hash(value, seed) returns a 64-bit hash of every reflected non-static field.
+// The generated Hasher<T> hashes each run of adjacent fields which are
+// trivially copyable and have no padding as one byte range, using the layout
+// clang computed for the record, and combines the other fields one at a time:
+//   arithmetic, enum and pointer   by their bytes (floating point values by
+//                                  their bits, so 0.0 and -0.0 differ)
+//   reflected records              through their Hasher
+//   strings, vectors of scalars    by their bytes, with the length
+//   other ranges                   element by element, with the length
+//   anything else                  through std::hash
+// The result does not depend on the seed of std::hash, but it depends on the
+// byte order and on the layout of the records, so it is not meant to be
+// stored across platforms.
+
+#include "PReflEnum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace PRefl {
+
+// Specialized for each reflected record by the generated files.
+template <typename T> struct Hasher;
+
+namespace HashDetail {
+constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+
+inline uint64_t Load64(const unsigned char *p) {
+  uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t word) {
+  acc += word * kPrime2;
+  acc = (acc << 31) | (acc >> 33);
+  return acc * kPrime1;
+}
+
+// Two independent lanes of 8 bytes, so the multiplications of consecutive
+// words overlap.
+inline uint64_t HashBytes(uint64_t h, const void *data, size_t size) {
+  auto *p = static_cast<const unsigned char *>(data);
+  uint64_t a = h ^ kPrime1;
+  uint64_t b = h + size * kPrime2;
+  for (; size >= 16; p += 16, size -= 16) {
+    a = Round(a, Load64(p));
+    b = Round(b, Load64(p + 8));
+  }
+  if (size >= 8) {
+    a = Round(a, Load64(p));
+    p += 8;
+    size -= 8;
+  }
+  if (size > 0) {
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, size);
+    b = Round(b, tail);
+  }
+  return EnumDetail::Mix(a ^ ((b << 27) | (b >> 37)));
+}
+
+template <typename T, typename = void> struct HasHasher : std::false_type {};
+template <typename T>
+struct HasHasher<
+    T, std::void_t<decltype(Hasher<T>::Hash(std::declval<const T &>(), 0))>>
+    : std::true_type {};
+
+template <typename T, typename = void> struct IsRange : std::false_type {};
+template <typename T>
+struct IsRange<T, std::void_t<decltype(std::begin(std::declval<const T &>())),
+                              decltype(std::end(std::declval<const T &>()))>>
+    : std::true_type {};
+
+// Element type of contiguous ranges (strings, vectors, ...), void for the
+// other types.
+template <typename T, typename = void> struct ContiguousElement {
+  using type = void;
+};
+template <typename T>
+struct ContiguousElement<
+    T, std::void_t<decltype(std::data(std::declval<const T &>())),
+                   decltype(std::size(std::declval<const T &>()))>> {
+  using type = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(
+      std::declval<const T &>()))>>;
+};
+
+template <typename T, typename = void> struct HasStdHash : std::false_type {};
+template <typename T>
+struct HasStdHash<
+    T, std::void_t<decltype(std::hash<T>{}(std::declval<const T &>()))>>
+    : std::true_type {};
+
+// Types whose bytes are their value. float and double have no padding bits,
+// long double has.
+template <typename T>
+constexpr bool IsPlainBytes =
+    std::is_trivially_copyable_v<T> &&
+    (std::has_unique_object_representations_v<T> ||
+     std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+template <typename T> uint64_t Combine(uint64_t h, const T &value) {
+  if constexpr (HasHasher<T>::value) {
+    return Hasher<T>::Hash(value, h);
+  } else if constexpr (std::is_array_v<T> &&
+                       IsPlainBytes<std::remove_all_extents_t<T>>) {
+    return HashBytes(h, &value, sizeof(T));
+  } else if constexpr (IsPlainBytes<T> || std::is_enum_v<T> ||
+                       std::is_pointer_v<T>) {
+    return HashBytes(h, &value, sizeof(T));
+  } else if constexpr (IsPlainBytes<typename ContiguousElement<T>::type>) {
+    // strings, vectors of scalars, ...
+    uint64_t size = std::size(value);
+    return HashBytes(h ^ size, std::data(value),
+                     size * sizeof(*std::data(value)));
+  } else if constexpr (IsRange<T>::value) {
+    uint64_t count = 0;
+    for (auto &element : value) {
+      h = Combine(h, element);
+      ++count;
+    }
+    return HashBytes(h, &count, sizeof(count));
+  } else if constexpr (HasStdHash<T>::value) {
+    uint64_t hash = std::hash<T>{}(value);
+    return HashBytes(h, &hash, sizeof(hash));
+  } else {
+    static_assert(HasStdHash<T>::value,
+                  "the field type is neither reflected, a range nor has a "
+                  "std::hash specialization");
+    return h;
+  }
+}
+
+// The fields of a run are plain bytes for the compiler building the generated
+// code. clang may have seen other types (e.g. a trivial stub of std::string),
+// so the generated code checks it again.
+template <typename... F>
+constexpr bool IsPlainRun =
+    (IsPlainBytes<std::remove_cv_t<std::remove_all_extents_t<F>>> && ...);
+
+// Adjacent fields first..last occupy exactly `size` bytes. The layout of the
+// consumer compiler may differ from the one seen by clang, the check folds to
+// a constant.
+template <typename F, typename L>
+bool IsRun(const F &first, const L &last, size_t size) {
+  auto *begin = reinterpret_cast<const unsigned char *>(std::addressof(first));
+  auto *end =
+      reinterpret_cast<const unsigned char *>(std::addressof(last)) + sizeof(L);
+  return static_cast<size_t>(end - begin) == size;
+}
+
+template <typename F>
+uint64_t HashRun(uint64_t h, const F &first, size_t size) {
+  return HashBytes(h, std::addressof(first), size);
+}
+} // namespace HashDetail
+
+template <typename T> uint64_t Hash(const T &value, uint64_t seed = 0) {
+  return HashDetail::Combine(seed, value);
+}
+} // namespace PRefl
@@ -0,0 +1,475 @@
+#pragma once
+
+// JSON writer and reader for the JsonCodec<T> specializations generated by
+// PupilReflTool with --json.
+// Header only, no dependency besides the standard library (C++17 with
+// floating point std::to_chars/from_chars).
+//
+// ToJson(value, out) appends the JSON of value to out, FromJson(text, value)
+// reads it back. Reflected records are objects with one key per reflected
+// non-static field; the generated writer appends pre-escaped key literals and
+// the generated reader dispatches each key through a perfect hash of the
+// field names (EnumHashIndex). Neither builds a document tree, and the writer
+// only allocates when the output string grows.
+//   bool, numbers          true/false, shortest round trip number, NaN and
+//                          infinities as null
+//   enums                  their underlying value
+//   strings                escaped string
+//   arrays and ranges      array, read into std::array, C arrays and
+//                          containers with emplace_back
+// Unknown keys are skipped, missing keys leave the field untouched and const
+// fields are written but never read.
+
+#include "PReflEnum.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace PRefl {
+
+// Specialized for each reflected record by the generated files.
+template <typename T> struct JsonCodec;
+
+class JsonWriter {
+  std::string &m_out;
+
+public:
+  explicit JsonWriter(std::string &out) : m_out(out) {}
+
+  // Text which is already valid JSON, e.g. the generated keys.
+  void Raw(std::string_view text) { m_out.append(text); }
+  void Char(char c) { m_out.push_back(c); }
+
+  void String(std::string_view str) {
+    m_out.push_back('"');
+    size_t start = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+      auto c = static_cast<unsigned char>(str[i]);
+      if (c >= 0x20 && c != '"' && c != '\\')
+        continue;
+      m_out.append(str.data() + start, i - start);
+      start = i + 1;
+      switch (c) {
+      case '"':
+        m_out.append("\\\"");
+        break;
+      case '\\':
+        m_out.append("\\\\");
+        break;
+      case '\n':
+        m_out.append("\\n");
+        break;
+      case '\r':
+        m_out.append("\\r");
+        break;
+      case '\t':
+        m_out.append("\\t");
+        break;
+      default: {
+        const char *hex = "0123456789abcdef";
+        char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+        m_out.append(escaped, sizeof(escaped));
+      }
+      }
+    }
+    m_out.append(str.data() + start, str.size() - start);
+    m_out.push_back('"');
+  }
+
+  template <typename T> void Number(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (!std::isfinite(value)) {
+        m_out.append("null");
+        return;
+      }
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_out.append(buffer, result.ptr);
+  }
+};
+
+class JsonReader {
+  const char *m_pos;
+  const char *m_end;
+  bool m_ok = true;
+  // unescaped keys and strings, reused between the values
+  std::string m_scratch;
+
+  static bool IsSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  static void AppendUtf8(std::string &out, uint32_t code) {
+    if (code < 0x80) {
+      out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+      out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else {
+      out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    }
+  }
+
+  bool ReadHex4(uint32_t &code) {
+    if (m_end - m_pos < 4)
+      return Fail();
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = *m_pos++;
+      code <<= 4;
+      if (c >= '0' && c <= '9')
+        code |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        code |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        code |= c - 'A' + 10;
+      else
+        return Fail();
+    }
+    return true;
+  }
+
+  // The rest of a string after the opening quote. Strings without escapes
+  // are returned in place, the others are unescaped into m_scratch.
+  bool ReadStringView(std::string_view &str) {
+    const char *start = m_pos;
+    while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+      ++m_pos;
+    if (m_pos >= m_end)
+      return Fail();
+    if (*m_pos == '"') {
+      str = std::string_view(start, m_pos - start);
+      ++m_pos;
+      return true;
+    }
+
+    m_scratch.assign(start, m_pos);
+    while (m_pos < m_end && *m_pos != '"') {
+      char c = *m_pos++;
+      if (c != '\\') {
+        m_scratch.push_back(c);
+        continue;
+      }
+      if (m_pos >= m_end)
+        return Fail();
+      switch (char e = *m_pos++) {
+      case '"':
+      case '\\':
+      case '/':
+        m_scratch.push_back(e);
+        break;
+      case 'b':
+        m_scratch.push_back('\b');
+        break;
+      case 'f':
+        m_scratch.push_back('\f');
+        break;
+      case 'n':
+        m_scratch.push_back('\n');
+        break;
+      case 'r':
+        m_scratch.push_back('\r');
+        break;
+      case 't':
+        m_scratch.push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code;
+        if (!ReadHex4(code))
+          return false;
+        // surrogate pair
+        if (code >= 0xd800 && code < 0xdc00 && m_end - m_pos >= 2 &&
+            m_pos[0] == '\\' && m_pos[1] == 'u') {
+          m_pos += 2;
+          uint32_t low;
+          if (!ReadHex4(low))
+            return false;
+          code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        }
+        AppendUtf8(m_scratch, code);
+        break;
+      }
+      default:
+        return Fail();
+      }
+    }
+    if (m_pos >= m_end)
+      return Fail();
+    ++m_pos;
+    str = m_scratch;
+    return true;
+  }
+
+  bool Literal(std::string_view literal) {
+    if (static_cast<size_t>(m_end - m_pos) < literal.size() ||
+        std::string_view(m_pos, literal.size()) != literal)
+      return Fail();
+    m_pos += literal.size();
+    return true;
+  }
+
+public:
+  explicit JsonReader(std::string_view text)
+      : m_pos(text.data()), m_end(text.data() + text.size()) {}
+
+  bool Ok() const { return m_ok; }
+  bool Fail() {
+    m_ok = false;
+    return false;
+  }
+
+  void SkipSpace() {
+    while (m_pos < m_end && IsSpace(*m_pos))
+      ++m_pos;
+  }
+  // Only white space is left.
+  bool AtEnd() {
+    SkipSpace();
+    return m_ok && m_pos == m_end;
+  }
+  char Peek() {
+    SkipSpace();
+    return m_pos < m_end ? *m_pos : '\0';
+  }
+
+  bool ReadNull() { return Peek() == 'n' && Literal("null"); }
+
+  bool ReadBool(bool &value) {
+    char c = Peek();
+    if (c == 't' ? !Literal("true") : c == 'f' ? !Literal("false") : !Fail())
+      return false;
+    value = c == 't';
+    return true;
+  }
+
+  template <typename T> bool ReadNumber(T &value) {
+    if (Peek() == 'n' && std::is_floating_point_v<T>) {
+      value = std::numeric_limits<T>::quiet_NaN();
+      return Literal("null");
+    }
+    const char *start = m_pos;
+    auto result = std::from_chars(start, m_end, value);
+    if constexpr (std::is_integral_v<T>) {
+      // a number written with a fraction or an exponent
+      if (result.ec == std::errc() && result.ptr < m_end &&
+          (*result.ptr == '.' || *result.ptr == 'e' || *result.ptr == 'E')) {
+        double real;
+        result = std::from_chars(start, m_end, real);
+        value = static_cast<T>(real);
+      }
+    }
+    if (result.ec != std::errc())
+      return Fail();
+    m_pos = result.ptr;
+    return true;
+  }
+
+  bool ReadString(std::string &value) {
+    if (Peek() != '"')
+      return Fail();
+    ++m_pos;
+    std::string_view str;
+    if (!ReadStringView(str))
+      return false;
+    value.assign(str);
+    return true;
+  }
+
+  // Calls onKey(key) for each key of an object. onKey reads the value and
+  // returns false on errors. The key is only valid during the call.
+  template <typename F> bool ReadObject(F &&onKey) {
+    if (Peek() != '{')
+      return Fail();
+    ++m_pos;
+    if (Peek() == '}') {
+      ++m_pos;
+      return true;
+    }
+    while (true) {
+      if (Peek() != '"')
+        return Fail();
+      ++m_pos;
+      std::string_view key;
+      if (!ReadStringView(key))
+        return false;
+      if (Peek() != ':')
+        return Fail();
+      ++m_pos;
+      if (!onKey(key))
+        return Fail();
+      char c = Peek();
+      if (c != ',' && c != '}')
+        return Fail();
+      ++m_pos;
+      if (c == '}')
+        return true;
+    }
+  }
+
+  // Calls onElement() for each element of an array, which reads it.
+  template <typename F> bool ReadArray(F &&onElement) {
+    if (Peek() != '[')
+      return Fail();
+    ++m_pos;
+    if (Peek() == ']') {
+      ++m_pos;
+      return true;
+    }
+    while (true) {
+      if (!onElement())
+        return Fail();
+      char c = Peek();
+      if (c != ',' && c != ']')
+        return Fail();
+      ++m_pos;
+      if (c == ']')
+        return true;
+    }
+  }
+
+  // Skip any value.
+  bool Skip() {
+    switch (Peek()) {
+    case '{':
+      return ReadObject([this](std::string_view) { return Skip(); });
+    case '[':
+      return ReadArray([this]() { return Skip(); });
+    case '"': {
+      ++m_pos;
+      std::string_view str;
+      return ReadStringView(str);
+    }
+    case 't':
+      return Literal("true");
+    case 'f':
+      return Literal("false");
+    case 'n':
+      return Literal("null");
+    default: {
+      double number;
+      return ReadNumber(number);
+    }
+    }
+  }
+};
+
+namespace JsonDetail {
+template <typename> constexpr bool kUnsupported = false;
+
+template <typename T, typename = void> struct HasCodec : std::false_type {};
+template <typename T>
+struct HasCodec<T, std::void_t<decltype(JsonCodec<T>::Write(
+                       std::declval<JsonWriter &>(),
+                       std::declval<const T &>()))>> : std::true_type {};
+
+template <typename T, typename = void> struct IsRange : std::false_type {};
+template <typename T>
+struct IsRange<T, std::void_t<decltype(std::begin(std::declval<const T &>())),
+                              decltype(std::end(std::declval<const T &>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct IsGrowable : std::false_type {};
+template <typename T>
+struct IsGrowable<T, std::void_t<decltype(std::declval<T &>().clear()),
+                                 decltype(std::declval<T &>().emplace_back())>>
+    : std::true_type {};
+
+template <typename T> struct IsStdArray : std::false_type {};
+template <typename T, size_t N>
+struct IsStdArray<std::array<T, N>> : std::true_type {};
+
+template <typename T> void Write(JsonWriter &out, const T &value) {
+  if constexpr (HasCodec<T>::value) {
+    JsonCodec<T>::Write(out, value);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    out.Raw(value ? "true" : "false");
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    out.Number(value);
+  } else if constexpr (std::is_enum_v<T>) {
+    out.Number(static_cast<std::underlying_type_t<T>>(value));
+  } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+    out.String(value);
+  } else if constexpr (IsRange<T>::value) {
+    out.Char('[');
+    bool first = true;
+    for (auto &element : value) {
+      if (!first)
+        out.Char(',');
+      first = false;
+      Write(out, element);
+    }
+    out.Char(']');
+  } else {
+    static_assert(kUnsupported<T>, "the field type can not be written as JSON");
+  }
+}
+
+template <typename T> bool Read(JsonReader &in, T &value) {
+  if constexpr (std::is_const_v<T>) {
+    return in.Skip();
+  } else if constexpr (HasCodec<T>::value) {
+    return JsonCodec<T>::Read(in, value);
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return in.ReadBool(value);
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    return in.ReadNumber(value);
+  } else if constexpr (std::is_enum_v<T>) {
+    std::underlying_type_t<T> number;
+    if (!in.ReadNumber(number))
+      return false;
+    value = static_cast<T>(number);
+    return true;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return in.ReadString(value);
+  } else if constexpr (std::is_array_v<T> || IsStdArray<T>::value) {
+    size_t i = 0;
+    return in.ReadArray([&]() {
+      return i < std::size(value) ? Read(in, value[i++]) : in.Skip();
+    });
+  } else if constexpr (IsGrowable<T>::value) {
+    value.clear();
+    return in.ReadArray([&]() { return Read(in, value.emplace_back()); });
+  } else {
+    static_assert(kUnsupported<T>, "the field type can not be read from JSON");
+    return false;
+  }
+}
+
+// Index of `key` in the field names of a record, or -1.
+template <size_t B, size_t S, size_t N>
+ptrdiff_t FindKey(const EnumHashIndex<B, S> &index,
+                  const std::array<std::string_view, N> &keys,
+                  std::string_view key) {
+  auto i = index.Find(EnumDetail::Hash(key));
+  return i >= 0 && keys[i] == key ? i : -1;
+}
+} // namespace JsonDetail
+
+template <typename T> void ToJson(const T &value, std::string &out) {
+  JsonWriter writer(out);
+  JsonDetail::Write(writer, value);
+}
+
+template <typename T> bool FromJson(std::string_view text, T &value) {
+  JsonReader reader(text);
+  return JsonDetail::Read(reader, value) && reader.AtEnd();
+}
+} // namespace PRefl
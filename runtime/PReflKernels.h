@@ -0,0 +1,68 @@
+#pragma once
+
+// Batch kernels for the RANGE and STEP annotations, used by the
+// ClampToRange/SnapToStep functions generated by PupilReflTool.
+// Header only, no dependency besides the standard library.
+//
+// The kernels are plain inline loops without branches or indirect calls, so
+// the compiler can vectorize them over contiguous values (min/max and
+// floor/round instructions). GCC only vectorizes std::floor with
+// -fno-trapping-math, clang does by default.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace PRefl {
+
+// Snap to origin + k * step, rounding to the nearest step. Floating point
+// values are computed in their own precision, integers in double.
+template <typename T>
+inline T SnapToStep(T value, double step, double origin) {
+  if constexpr (std::is_floating_point_v<T>) {
+    auto s = static_cast<T>(step);
+    auto o = static_cast<T>(origin);
+    return o + std::floor((value - o) / s + T(0.5)) * s;
+  } else {
+    auto steps = std::floor((static_cast<double>(value) - origin) / step + 0.5);
+    return static_cast<T>(origin + steps * step);
+  }
+}
+
+template <typename T>
+inline void ClampSpan(T *values, size_t count, T vmin, T vmax) {
+  for (size_t i = 0; i < count; ++i)
+    values[i] = std::min(std::max(values[i], vmin), vmax);
+}
+
+template <typename T>
+inline void SnapSpan(T *values, size_t count, double step, double origin) {
+  for (size_t i = 0; i < count; ++i)
+    values[i] = SnapToStep(values[i], step, origin);
+}
+
+namespace KernelDetail {
+// Per field helpers of the generated record loops, the bounds are constants
+// of the generated code.
+template <typename T> inline void Clamp(T &value, double vmin, double vmax) {
+  value = std::min(std::max(value, static_cast<T>(vmin)),
+                   static_cast<T>(vmax));
+}
+template <typename T, size_t N>
+inline void Clamp(T (&values)[N], double vmin, double vmax) {
+  ClampSpan(values, N, static_cast<T>(vmin), static_cast<T>(vmax));
+}
+// const and constexpr members are left untouched
+template <typename T> inline void Clamp(const T &, double, double) {}
+
+template <typename T> inline void Snap(T &value, double step, double origin) {
+  value = SnapToStep(value, step, origin);
+}
+template <typename T, size_t N>
+inline void Snap(T (&values)[N], double step, double origin) {
+  SnapSpan(values, N, step, origin);
+}
+template <typename T> inline void Snap(const T &, double, double) {}
+} // namespace KernelDetail
+} // namespace PRefl
@@ -0,0 +1,143 @@
+#pragma once
+
+// Method reflection support for the code generated by PupilReflTool.
+// Header only, no dependency besides the standard library.
+//
+// For a record with methods annotated with [[META]] the tool generates
+// MethodData<T>::methods, an array of Method. Each method is called through a
+// static invoker thunk with a fixed signature:
+//   invoke(object, args, result)
+//     object  the T instance (ignored for static methods)
+//     args    one pointer per parameter, to a value of the parameter type
+//     result  uninitialized storage for the return value, which is
+//             constructed in place (the caller destroys it), or nullptr to
+//             discard it; a reference is returned as a pointer
+// A call is one indirect call, nothing is allocated.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace PRefl {
+
+template <typename T> struct MethodData;
+
+enum class ETypeTag : uint8_t {
+  Void,
+  Bool,
+  Char,
+  Int8,
+  Int16,
+  Int32,
+  Int64,
+  UInt8,
+  UInt16,
+  UInt32,
+  UInt64,
+  Float,
+  Double,
+  String,
+  Enum,
+  Pointer,
+  Record,
+  Other
+};
+
+// Tag of a parameter or return type, references and qualifiers removed.
+template <typename T> constexpr ETypeTag TypeTagOf() {
+  using U = std::remove_cv_t<std::remove_reference_t<T>>;
+  if constexpr (std::is_void_v<U>)
+    return ETypeTag::Void;
+  else if constexpr (std::is_same_v<U, bool>)
+    return ETypeTag::Bool;
+  else if constexpr (std::is_same_v<U, char>)
+    return ETypeTag::Char;
+  else if constexpr (std::is_integral_v<U>) {
+    constexpr bool isSigned = std::is_signed_v<U>;
+    if constexpr (sizeof(U) == 1)
+      return isSigned ? ETypeTag::Int8 : ETypeTag::UInt8;
+    else if constexpr (sizeof(U) == 2)
+      return isSigned ? ETypeTag::Int16 : ETypeTag::UInt16;
+    else if constexpr (sizeof(U) == 4)
+      return isSigned ? ETypeTag::Int32 : ETypeTag::UInt32;
+    else
+      return isSigned ? ETypeTag::Int64 : ETypeTag::UInt64;
+  } else if constexpr (std::is_same_v<U, float>)
+    return ETypeTag::Float;
+  else if constexpr (std::is_floating_point_v<U>)
+    return ETypeTag::Double;
+  else if constexpr (std::is_same_v<U, std::string> ||
+                     std::is_same_v<U, std::string_view>)
+    return ETypeTag::String;
+  else if constexpr (std::is_enum_v<U>)
+    return ETypeTag::Enum;
+  else if constexpr (std::is_pointer_v<U>)
+    return ETypeTag::Pointer;
+  else if constexpr (std::is_class_v<U>)
+    return ETypeTag::Record;
+  else
+    return ETypeTag::Other;
+}
+
+using Invoker = void (*)(void *object, void *const *args, void *result);
+
+struct MethodParam {
+  std::string_view name;
+  ETypeTag type;
+};
+
+struct Method {
+  std::string_view name;
+  Invoker invoke;
+  ETypeTag returnType;
+  const MethodParam *params;
+  size_t paramCount;
+  bool isConst;
+  bool isStatic;
+};
+
+namespace MethodDetail {
+// The argument for a parameter of type T.
+template <typename T> constexpr decltype(auto) Arg(void *arg) {
+  using Value = std::remove_reference_t<T>;
+  if constexpr (std::is_rvalue_reference_v<T>)
+    return std::move(*static_cast<Value *>(arg));
+  else
+    return *static_cast<Value *>(arg);
+}
+
+// Call and store the result of type R.
+template <typename R, typename F> void Store(void *result, F &&call) {
+  if constexpr (std::is_void_v<R>) {
+    call();
+  } else if constexpr (std::is_reference_v<R>) {
+    auto *ptr = &call();
+    if (result)
+      *static_cast<decltype(ptr) *>(result) = ptr;
+  } else if (result) {
+    new (result) std::remove_cv_t<R>(call());
+  } else {
+    call();
+  }
+}
+} // namespace MethodDetail
+
+template <typename T> constexpr size_t MethodCount() {
+  return MethodData<T>::methods.size();
+}
+
+// First method named `name`, or nullptr. Tables are small, a scan over the
+// names is cheaper than hashing them.
+template <typename T> constexpr const Method *FindMethod(std::string_view name) {
+  for (auto &method : MethodData<T>::methods) {
+    if (method.name == name)
+      return &method;
+  }
+  return nullptr;
+}
+} // namespace PRefl
@@ -0,0 +1,79 @@
+#pragma once
+
+// Pooled names of the reflected fields and attributes, used by the files
+// PupilReflTool generates with --pooled-names.
+// Header only, no dependency besides the standard library.
+//
+// By default every field and attribute is named by its own class template
+// instantiation, Name<"field">{}. With --pooled-names each ReflData<T> has
+// one character table holding the names of all its fields and attributes,
+// and they are named by a PooledName<T>, an index into that table:
+//   constexpr static char nameChars[] = "position\0" "range\0";
+//   constexpr static uint32_t nameOffsets[] = {0, 9, 15};
+//   constexpr static NameTable names {nameChars, nameOffsets, 2};
+//   ... Field { PooledName<Light>{0}, &Light::position, ... }
+// All names of a record have the same type, so a record adds one template
+// instantiation instead of one per name. A PooledName only holds its index
+// and finds the table through ReflData<T>, so the emitted field tables carry
+// no pointer to relocate. Names stay comparable at compile time:
+//   static_assert(ReflData<Light>::names[0] == "position");
+//   static_assert(ReflData<Light>::names.Find("range") == 1);
+//   static_assert(std::get<0>(...fields).name == "position");
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace PRefl {
+
+// Names separated by '\0', name i is chars[offsets[i], offsets[i + 1] - 1).
+struct NameTable {
+  const char *chars;
+  const uint32_t *offsets;
+  size_t count;
+
+  constexpr std::string_view operator[](size_t i) const {
+    return {chars + offsets[i], offsets[i + 1] - offsets[i] - 1};
+  }
+
+  // Index of `name`, or -1. The tables are small, a linear search is enough.
+  constexpr int Find(std::string_view name) const {
+    for (size_t i = 0; i < count; ++i) {
+      if ((*this)[i] == name)
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+};
+
+template <typename T> struct ReflData;
+
+// Name `index` of the table of ReflData<T>.
+template <typename T> struct PooledName {
+  uint32_t index;
+
+  constexpr std::string_view View() const { return ReflData<T>::names[index]; }
+  constexpr operator std::string_view() const { return View(); }
+
+  friend constexpr bool operator==(PooledName a, std::string_view b) {
+    return a.View() == b;
+  }
+  friend constexpr bool operator==(std::string_view a, PooledName b) {
+    return a == b.View();
+  }
+  friend constexpr bool operator!=(PooledName a, std::string_view b) {
+    return !(a == b);
+  }
+  friend constexpr bool operator!=(std::string_view a, PooledName b) {
+    return !(a == b);
+  }
+  template <typename U>
+  friend constexpr bool operator==(PooledName a, PooledName<U> b) {
+    return a.View() == b.View();
+  }
+  template <typename U>
+  friend constexpr bool operator!=(PooledName a, PooledName<U> b) {
+    return !(a == b);
+  }
+};
+} // namespace PRefl
@@ -0,0 +1,299 @@
+#pragma once
+
+// Process-wide registry of the reflected records, for code which only knows a
+// type by its name or ID at runtime (plugins, asset loaders, editors).
+// Header only, no dependency besides the standard library.
+//
+// With --registry the generated files register every record which has a type
+// ID (see PReflTypeId.h) during static initialization and unregister it when
+// the module is unloaded:
+//   Registry::Instance().Find("ns::Record")   by qualified name
+//   Registry::Instance().Find(typeId)         by ReflData<T>::typeId
+//
+// Lookups are wait-free: they read an open addressing table through atomics
+// and never wait for a writer. Registration and unregistration are serialized
+// by a mutex and publish a new table when the current one is half full. The
+// registry copies the metadata it is given, so a RecordInfo returned by Find
+// stays readable after its module is unloaded; copies and replaced tables are
+// only released with the registry, and a module loaded again reuses
+// the copies of its records.
+//
+// The registry is an inline function local static. Shared libraries on ELF
+// platforms share it as long as the symbol is not hidden. Otherwise (e.g.
+// DLLs) define PREFL_REGISTRY_EXTERN and PREFL_REGISTRY_API (dllexport or
+// dllimport) everywhere, and PREFL_REGISTRY_IMPLEMENT in the one module which
+// owns the registry.
+
+#include "PReflTypeId.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef PREFL_REGISTRY_API
+#define PREFL_REGISTRY_API
+#endif
+
+namespace PRefl {
+
+struct FieldInfo {
+  std::string_view name;
+  size_t offset;
+  size_t size;
+};
+
+struct RecordInfo {
+  uint64_t typeId;
+  std::string_view name;
+  size_t size;
+  size_t align;
+  const FieldInfo *fields = nullptr;
+  size_t fieldCount = 0;
+};
+
+class Registry {
+  struct Node {
+    RecordInfo info;
+    std::string name;
+    std::vector<std::string> fieldNames;
+    std::vector<FieldInfo> fields;
+    // modules which registered the record, guarded by m_mutex
+    size_t refCount = 0;
+  };
+
+  struct Slot {
+    // 0 while empty, the ID stays when the record is unregistered
+    std::atomic<uint64_t> typeId{0};
+    std::atomic<Node *> node{nullptr};
+  };
+
+  struct Table {
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    // slots with an ID, guarded by m_mutex
+    size_t used = 0;
+
+    explicit Table(size_t capacity)
+        : mask(capacity - 1), slots(new Slot[capacity]) {}
+  };
+
+  std::atomic<Table *> m_table{nullptr};
+  std::mutex m_mutex;
+  // every table and node ever published, readers may still use them
+  std::vector<std::unique_ptr<Table>> m_tables;
+  std::vector<std::unique_ptr<Node>> m_nodes;
+  // unregistered nodes by ID, reused when a module is loaded again
+  std::unordered_map<uint64_t, Node *> m_retired;
+  std::atomic<size_t> m_size{0};
+
+  static Slot *Probe(const Table &table, uint64_t typeId) {
+    for (size_t i = typeId & table.mask, n = 0; n <= table.mask;
+         i = (i + 1) & table.mask, ++n) {
+      auto id = table.slots[i].typeId.load(std::memory_order_acquire);
+      if (id == typeId || id == 0)
+        return &table.slots[i];
+    }
+    return nullptr;
+  }
+
+  static bool Matches(const Node &node, const RecordInfo &info) {
+    if (node.info.name != info.name || node.info.size != info.size ||
+        node.info.align != info.align || node.fields.size() != info.fieldCount)
+      return false;
+    for (size_t i = 0; i < info.fieldCount; ++i) {
+      auto &field = node.fields[i];
+      if (field.name != info.fields[i].name ||
+          field.offset != info.fields[i].offset ||
+          field.size != info.fields[i].size)
+        return false;
+    }
+    return true;
+  }
+
+  static void Copy(const RecordInfo &info, Node &node) {
+    node.name = info.name;
+    node.fieldNames.reserve(info.fieldCount);
+    for (size_t i = 0; i < info.fieldCount; ++i)
+      node.fieldNames.emplace_back(info.fields[i].name);
+    node.fields.reserve(info.fieldCount);
+    for (size_t i = 0; i < info.fieldCount; ++i)
+      node.fields.push_back(
+          {node.fieldNames[i], info.fields[i].offset, info.fields[i].size});
+    node.info = info;
+    node.info.name = node.name;
+    node.info.fields = node.fields.data();
+  }
+
+  // Copy the live records into a table with room for `extra` more.
+  void Grow(size_t extra) {
+    Table *current = m_table.load(std::memory_order_relaxed);
+    size_t live = m_size.load(std::memory_order_relaxed) + extra;
+    size_t capacity = 64;
+    while (capacity < live * 4)
+      capacity *= 2;
+
+    auto table = std::make_unique<Table>(capacity);
+    if (current) {
+      for (size_t i = 0; i <= current->mask; ++i) {
+        auto *node = current->slots[i].node.load(std::memory_order_relaxed);
+        if (!node)
+          continue;
+        auto *slot = Probe(*table, node->info.typeId);
+        slot->node.store(node, std::memory_order_relaxed);
+        slot->typeId.store(node->info.typeId, std::memory_order_relaxed);
+        ++table->used;
+      }
+    }
+    m_table.store(table.get(), std::memory_order_release);
+    m_tables.push_back(std::move(table));
+  }
+
+public:
+  Registry() = default;
+  Registry(const Registry &) = delete;
+  Registry &operator=(const Registry &) = delete;
+
+  PREFL_REGISTRY_API static Registry &Instance();
+
+  // Returns the registered copy of `info`, which identifies the registration
+  // for Unregister, or nullptr when another record has the same ID.
+  const RecordInfo *Register(const RecordInfo &info) {
+    if (info.typeId == 0)
+      return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Table *table = m_table.load(std::memory_order_relaxed);
+    if (!table || (table->used + 1) * 2 > table->mask + 1) {
+      Grow(1);
+      table = m_table.load(std::memory_order_relaxed);
+    }
+
+    // writers are serialized, so the slots of the current table only change
+    // here
+    auto *slot = Probe(*table, info.typeId);
+    auto *node = slot->node.load(std::memory_order_relaxed);
+    if (node) {
+      if (node->info.name != info.name)
+        return nullptr;
+      // the same record registered by another module
+      ++node->refCount;
+      return &node->info;
+    }
+
+    Node *registered;
+    auto retired = m_retired.find(info.typeId);
+    if (retired != m_retired.end() && Matches(*retired->second, info)) {
+      registered = retired->second;
+      m_retired.erase(retired);
+    } else {
+      m_nodes.push_back(std::make_unique<Node>());
+      registered = m_nodes.back().get();
+      Copy(info, *registered);
+    }
+    registered->refCount = 1;
+
+    if (slot->typeId.load(std::memory_order_relaxed) == 0)
+      ++table->used;
+    slot->node.store(registered, std::memory_order_release);
+    slot->typeId.store(info.typeId, std::memory_order_release);
+    m_size.fetch_add(1, std::memory_order_relaxed);
+    return &registered->info;
+  }
+
+  void Unregister(const RecordInfo *registered) {
+    if (!registered)
+      return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Table *table = m_table.load(std::memory_order_relaxed);
+    auto *slot = table ? Probe(*table, registered->typeId) : nullptr;
+    auto *node = slot ? slot->node.load(std::memory_order_relaxed) : nullptr;
+    if (!node || &node->info != registered)
+      return;
+    if (--node->refCount > 0)
+      return;
+    // the ID stays in the slot, so the probe sequences of the other records
+    // are not cut
+    slot->node.store(nullptr, std::memory_order_release);
+    m_retired[node->info.typeId] = node;
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  const RecordInfo *Find(uint64_t typeId) const noexcept {
+    const Table *table = m_table.load(std::memory_order_acquire);
+    if (!table || typeId == 0)
+      return nullptr;
+    auto *slot = Probe(*table, typeId);
+    if (!slot)
+      return nullptr;
+    auto *node = slot->node.load(std::memory_order_acquire);
+    return node ? &node->info : nullptr;
+  }
+
+  const RecordInfo *Find(std::string_view name) const noexcept {
+    auto *info = Find(TypeIdOf(name));
+    return info && info->name == name ? info : nullptr;
+  }
+
+  // Number of registered records.
+  size_t Size() const noexcept {
+    return m_size.load(std::memory_order_relaxed);
+  }
+};
+
+#if !defined(PREFL_REGISTRY_EXTERN)
+inline Registry &Registry::Instance() {
+  static Registry registry;
+  return registry;
+}
+#elif defined(PREFL_REGISTRY_IMPLEMENT)
+Registry &Registry::Instance() {
+  static Registry registry;
+  return registry;
+}
+#endif
+
+// Registers a record for the lifetime of the object. The generated files hold
+// one inline Registration per record, constructed once per module.
+class Registration {
+  const RecordInfo *m_registered;
+
+public:
+  Registration(RecordInfo info, std::initializer_list<FieldInfo> fields) {
+    info.fields = fields.begin();
+    info.fieldCount = fields.size();
+    m_registered = Registry::Instance().Register(info);
+  }
+  Registration(const Registration &) = delete;
+  Registration &operator=(const Registration &) = delete;
+  ~Registration() { Registry::Instance().Unregister(m_registered); }
+
+  // nullptr when the type ID was taken by another record
+  const RecordInfo *Get() const { return m_registered; }
+};
+
+namespace RegistryDetail {
+// Offset of a data member without offsetof, which does not accept template
+// arguments with commas. No T is constructed, the member pointer is only
+// applied to suitably aligned storage.
+template <typename T, typename M> size_t OffsetOf(M T::*member) {
+  alignas(T) static unsigned char storage[sizeof(T)];
+  auto *object = reinterpret_cast<T *>(storage);
+  return static_cast<size_t>(
+      reinterpret_cast<unsigned char *>(std::addressof(object->*member)) -
+      storage);
+}
+
+template <typename T, typename M>
+FieldInfo FieldOf(std::string_view name, M T::*member) {
+  return {name, OffsetOf(member), sizeof(M)};
+}
+} // namespace RegistryDetail
+} // namespace PRefl
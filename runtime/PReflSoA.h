@@ -0,0 +1,57 @@
+#pragma once
+
+// Struct-of-arrays support for the code generated by PupilReflTool.
+// Header only, needs C++20 (std::span), like the rest of the generated code.
+//
+// For a record annotated with [[META, SOA]] the tool generates SoA<T>, which
+// stores every reflected non-static field of T in its own contiguous array
+// (array members become std::array elements), and the alias <Record>SoA next
+// to namespace scope records:
+//   Push/Pop/Get/Set     one record at a time
+//   FromAoS/ToAoS        conversion from and to an array of records
+//   <field>()            span over the values of one field
+// Get and ToAoS assign the fields of default constructed or existing records.
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace PRefl {
+
+template <typename T> class SoA;
+
+namespace SoADetail {
+template <typename T> struct Element {
+  using Type = T;
+};
+template <typename T, size_t N> struct Element<T[N]> {
+  using Type = std::array<typename Element<T>::Type, N>;
+};
+// Type of the column of a member of type T.
+template <typename T>
+using ElementT = typename Element<std::remove_cv_t<T>>::Type;
+
+template <typename T> void Load(T &dst, const T &src) { dst = src; }
+template <typename T, typename U, size_t N>
+void Load(std::array<T, N> &dst, const U (&src)[N]) {
+  for (size_t i = 0; i < N; ++i)
+    Load(dst[i], src[i]);
+}
+
+template <typename T> void Store(T &dst, const T &src) { dst = src; }
+template <typename T, typename U, size_t N>
+void Store(T (&dst)[N], const std::array<U, N> &src) {
+  for (size_t i = 0; i < N; ++i)
+    Store(dst[i], src[i]);
+}
+// const members keep the value of their initializer
+template <typename T, typename U> void Store(const T &, const U &) {}
+
+template <typename T, typename U>
+void Push(std::vector<T> &column, const U &value) {
+  Load(column.emplace_back(), value);
+}
+} // namespace SoADetail
+} // namespace PRefl
@@ -0,0 +1,24 @@
+#pragma once
+
+// Stable type IDs of the records reflected by PupilReflTool.
+// Header only, no dependency besides the standard library.
+//
+// ReflData<T>::typeId is the 64-bit hash of the qualified name of T, e.g.
+// "ns::Outer::Record" or, for the generated full specializations of class
+// templates, "ns::Tmp<int, float>". The ID does not depend on the compiler or
+// on RTTI, so it can key hash maps, switch tables and serialized assets. The
+// tool reports an error when two names of a project get the same ID. Class
+// templates have typeId 0 unless a full specialization is generated for the
+// arguments (see --specializations).
+
+#include "PReflEnum.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace PRefl {
+// Same hash as the enumerator names, FNV-1a and the splitmix64 finalizer.
+constexpr uint64_t TypeIdOf(std::string_view qualifiedName) {
+  return EnumDetail::Hash(qualifiedName);
+}
+} // namespace PRefl
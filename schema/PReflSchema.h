@@ -0,0 +1,354 @@
+#pragma once
+
+// Reader of the binary reflection schema written by PupilReflTool --schema.
+// Header only, no dependency besides the standard library (and the OS API
+// for mapping files).
+//
+// The schema is a set of flat arrays linked by indices, so a mapped file can
+// be queried in place without deserializing:
+//
+//   Header
+//   string table   null-terminated strings, referenced by StringRef
+//   records        sorted by qualified name
+//   fields         fields of record i are [firstField, firstField + fieldCount)
+//   attributes     attributes of field i are [firstAttr, firstAttr + attrCount)
+//   bases          bases of record i are [firstBase, firstBase + baseCount)
+//   hash index     open addressing table of record indices, keyed by the
+//                  FNV-1a hash of the qualified name
+//
+// Values are in the byte order of the machine which wrote the schema, so it
+// can be mapped without conversion; Header::byteOrder tells it and IsValid
+// rejects a schema of the other byte order. Every section is 8-byte aligned.
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PReflSchema {
+
+constexpr char s_magic[4] = {'P', 'R', 'S', 'C'};
+// Increase when the layout changes.
+constexpr uint32_t s_version = 2;
+// Header::byteOrder as written, read back swapped on a machine of the other
+// byte order.
+constexpr uint32_t s_byteOrder = 0x01020304u;
+constexpr uint32_t s_invalidIndex = 0xffffffffu;
+
+enum class ERecordType : uint32_t { Class, Struct, None };
+enum class EAttrType : uint32_t { Meta, Info, Range, Step, Unknown };
+
+struct StringRef {
+  uint32_t offset; // into the string table
+  uint32_t size;   // without the terminating null
+};
+
+struct Section {
+  uint32_t offset; // from the beginning of the file
+  uint32_t count;
+};
+
+struct Header {
+  char magic[4];
+  uint32_t byteOrder; // s_byteOrder
+  uint32_t version;
+  uint32_t fileSize;
+  uint32_t stringTableSize;
+  uint32_t stringTableOffset;
+  Section records;
+  Section fields;
+  Section attrs;
+  Section bases;
+  Section hashIndex; // count is a power of two
+};
+
+struct Record {
+  StringRef name;          // e.g. TestCase8
+  StringRef qualifiedName; // e.g. TestCase8Nsp::TestCase8<T1, T2>
+  ERecordType type;
+  uint32_t templateCount;
+  uint32_t firstField;
+  uint32_t fieldCount;
+  uint32_t firstBase;
+  uint32_t baseCount;
+};
+
+struct Field {
+  StringRef name;
+  uint32_t firstAttr;
+  uint32_t attrCount;
+};
+
+struct Attr {
+  StringRef name;
+  EAttrType type;
+  StringRef info; // Info
+  uint32_t padding;
+  double values[2]; // Range: min, max; Step: step
+};
+
+struct Base {
+  StringRef name;
+  uint32_t record; // index of the base record in this schema or invalid
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(Record) == 40 &&
+                  sizeof(Field) == 16 && sizeof(Attr) == 40 &&
+                  sizeof(Base) == 12,
+              "the schema layout must not depend on the compiler");
+
+constexpr uint64_t Hash(std::string_view str) {
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Read only view of a schema in memory. It does not own the data.
+class Schema {
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+
+  template <typename T> const T *GetArray(const Section &section) const {
+    return reinterpret_cast<const T *>(m_data + section.offset);
+  }
+
+  bool CheckSection(const Section &section, size_t elemSize) const {
+    return section.offset % 8 == 0 &&
+           section.offset + uint64_t(section.count) * elemSize <= m_size;
+  }
+
+  // The string and its terminating null are in the string table.
+  bool CheckString(StringRef ref) const {
+    return uint64_t(ref.offset) + ref.size < GetHeader().stringTableSize;
+  }
+
+  // [first, first + count) is in a section of `total` elements.
+  static bool CheckRange(uint32_t first, uint32_t count, uint32_t total) {
+    return uint64_t(first) + count <= total;
+  }
+
+  bool CheckRecords() const {
+    const auto &header = GetHeader();
+    const auto *records = GetArray<Record>(header.records);
+    for (uint32_t i = 0; i < header.records.count; ++i) {
+      const auto &record = records[i];
+      if (!CheckString(record.name) || !CheckString(record.qualifiedName) ||
+          uint32_t(record.type) > uint32_t(ERecordType::None) ||
+          !CheckRange(record.firstField, record.fieldCount,
+                      header.fields.count) ||
+          !CheckRange(record.firstBase, record.baseCount, header.bases.count))
+        return false;
+    }
+    const auto *fields = GetArray<Field>(header.fields);
+    for (uint32_t i = 0; i < header.fields.count; ++i) {
+      if (!CheckString(fields[i].name) ||
+          !CheckRange(fields[i].firstAttr, fields[i].attrCount,
+                      header.attrs.count))
+        return false;
+    }
+    const auto *attrs = GetArray<Attr>(header.attrs);
+    for (uint32_t i = 0; i < header.attrs.count; ++i) {
+      if (!CheckString(attrs[i].name) || !CheckString(attrs[i].info) ||
+          uint32_t(attrs[i].type) > uint32_t(EAttrType::Unknown))
+        return false;
+    }
+    const auto *bases = GetArray<Base>(header.bases);
+    for (uint32_t i = 0; i < header.bases.count; ++i) {
+      if (!CheckString(bases[i].name) ||
+          (bases[i].record != s_invalidIndex &&
+           bases[i].record >= header.records.count))
+        return false;
+    }
+    // a power of two, with at least one free slot so probes terminate
+    const auto &index = header.hashIndex;
+    if (index.count == 0)
+      return header.records.count == 0;
+    if ((index.count & (index.count - 1)) != 0 ||
+        index.count <= header.records.count)
+      return false;
+    const auto *slots = GetArray<uint32_t>(index);
+    for (uint32_t i = 0; i < index.count; ++i) {
+      if (slots[i] != s_invalidIndex && slots[i] >= header.records.count)
+        return false;
+    }
+    return true;
+  }
+
+public:
+  Schema() = default;
+  Schema(const void *data, size_t size)
+      : m_data(static_cast<const char *>(data)), m_size(size) {}
+
+  const Header &GetHeader() const {
+    return *reinterpret_cast<const Header *>(m_data);
+  }
+
+  // Check the version, the bounds of every section and every index and
+  // string of the arrays, so the queries never read outside of the data.
+  // Linear in the size of the schema, should be called once before any
+  // query.
+  bool IsValid() const {
+    if (!m_data || m_size < sizeof(Header))
+      return false;
+    const auto &header = GetHeader();
+    return std::memcmp(header.magic, s_magic, sizeof(s_magic)) == 0 &&
+           header.byteOrder == s_byteOrder && header.version == s_version && header.fileSize == m_size &&
+           header.stringTableOffset + uint64_t(header.stringTableSize) <=
+               m_size &&
+           CheckSection(header.records, sizeof(Record)) &&
+           CheckSection(header.fields, sizeof(Field)) &&
+           CheckSection(header.attrs, sizeof(Attr)) &&
+           CheckSection(header.bases, sizeof(Base)) &&
+           CheckSection(header.hashIndex, sizeof(uint32_t)) && CheckRecords();
+  }
+
+  std::string_view GetString(StringRef ref) const {
+    return {m_data + GetHeader().stringTableOffset + ref.offset, ref.size};
+  }
+
+  uint32_t GetRecordCount() const { return GetHeader().records.count; }
+  const Record &GetRecord(uint32_t i) const {
+    return GetArray<Record>(GetHeader().records)[i];
+  }
+  const Field &GetField(const Record &record, uint32_t i) const {
+    return GetArray<Field>(GetHeader().fields)[record.firstField + i];
+  }
+  const Attr &GetAttr(const Field &field, uint32_t i) const {
+    return GetArray<Attr>(GetHeader().attrs)[field.firstAttr + i];
+  }
+  const Base &GetBase(const Record &record, uint32_t i) const {
+    return GetArray<Base>(GetHeader().bases)[record.firstBase + i];
+  }
+
+  // Find a record by qualified name through the hash index.
+  const Record *FindRecord(std::string_view qualifiedName) const {
+    const auto &index = GetHeader().hashIndex;
+    if (index.count == 0)
+      return nullptr;
+    const uint32_t *slots = GetArray<uint32_t>(index);
+    const uint32_t mask = index.count - 1;
+    uint32_t i = static_cast<uint32_t>(Hash(qualifiedName)) & mask;
+    for (uint32_t probe = 0; probe < index.count; ++probe, i = (i + 1) & mask) {
+      uint32_t slot = slots[i];
+      if (slot == s_invalidIndex)
+        return nullptr;
+      const auto &record = GetRecord(slot);
+      if (GetString(record.qualifiedName) == qualifiedName)
+        return &record;
+    }
+    return nullptr;
+  }
+
+  const Field *FindField(const Record &record, std::string_view name) const {
+    for (uint32_t i = 0; i < record.fieldCount; ++i) {
+      const auto &field = GetField(record, i);
+      if (GetString(field.name) == name)
+        return &field;
+    }
+    return nullptr;
+  }
+
+  const Attr *FindAttr(const Field &field, EAttrType type) const {
+    for (uint32_t i = 0; i < field.attrCount; ++i) {
+      const auto &attr = GetAttr(field, i);
+      if (attr.type == type)
+        return &attr;
+    }
+    return nullptr;
+  }
+};
+
+// Read only mapping of a schema file.
+class MappedSchema {
+  void *m_data = nullptr;
+  size_t m_size = 0;
+#if defined(_WIN32)
+  HANDLE m_file = INVALID_HANDLE_VALUE;
+  HANDLE m_mapping = nullptr;
+#endif
+
+public:
+  MappedSchema() = default;
+  explicit MappedSchema(const char *path) { Open(path); }
+  ~MappedSchema() { Close(); }
+
+  MappedSchema(const MappedSchema &) = delete;
+  MappedSchema &operator=(const MappedSchema &) = delete;
+
+  bool Open(const char *path) {
+    Close();
+#if defined(_WIN32)
+    m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+      return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+      Close();
+      return false;
+    }
+    m_mapping =
+        CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+      m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_data) {
+      Close();
+      return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    void *data =
+        mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED,
+             fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+      return false;
+    m_data = data;
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+  }
+
+  void Close() {
+#if defined(_WIN32)
+    if (m_data)
+      UnmapViewOfFile(m_data);
+    if (m_mapping)
+      CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+      CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data)
+      munmap(m_data, m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+  Schema GetSchema() const { return Schema{m_data, m_size}; }
+};
+} // namespace PReflSchema
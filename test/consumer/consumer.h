@@ -0,0 +1,25 @@
+#pragma once
+
+// Shared by the consumer tests, which compile the golden files of
+// test/generated against runtime/ and check what the generated code does.
+
+#include "stand_in.h"
+
+#include <cstdio>
+
+namespace ConsumerTest {
+inline int &Failures() {
+  static int failures = 0;
+  return failures;
+}
+} // namespace ConsumerTest
+
+#define CHECK(condition)                                                      \
+  do {                                                                        \
+    if (!(condition)) {                                                       \
+      std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,  \
+                   #condition);                                               \
+      ++ConsumerTest::Failures();                                             \
+    }                                                                         \
+  } while (false)
+
@@ -0,0 +1,146 @@
+// test.h with the output it includes (generated/test.gen.inl): field tables,
+// type IDs, enums, method tables and SoA containers.
+
+#include "consumer.h"
+
+#include "test.h"
+
+#include "PReflTypeId.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace PRefl;
+
+// field tables
+constexpr auto &c_testCase1 = std::get<0>(ReflData<TestCase1>::fields.fields);
+static_assert(ReflData<TestCase1>::fields.size == 1);
+static_assert(c_testCase1.name.View() == "_a");
+static_assert(c_testCase1.pointer == &TestCase1::_a);
+static_assert(!ReflData<TestCase3>::hasData && !ReflData<TestCase2_no>::hasData);
+static_assert(ReflData<TestCase12_3>::hasBases &&
+              ReflData<TestCase12_3>::bases.size == 1);
+// only the public base of TestCase12_4 is reflected
+static_assert(ReflData<TestCase12_4>::bases.size == 1);
+constexpr auto &c_angle = std::get<1>(ReflData<TestCase22>::fields.fields);
+static_assert(c_angle.name.View() == "angle");
+static_assert(std::get<0>(c_angle.attrs.attrs).name.View() == "range");
+static_assert(std::get<0>(std::get<0>(c_angle.attrs.attrs).value).second ==
+              2 * kTestCase22Pi);
+constexpr auto &c_level = std::get<2>(ReflData<TestCase22>::fields.fields);
+static_assert(std::get<0>(std::get<0>(c_level.attrs.attrs).value) ==
+              std::make_pair(-10, -2));
+static_assert(std::get<0>(std::get<1>(c_level.attrs.attrs).value) == -0.5);
+
+// type IDs
+static_assert(ReflData<TestCase1>::typeId == TypeIdOf("TestCase1"));
+static_assert(ReflData<TestCase8Nsp::TestCase8Nsp2::TestCase8_2>::typeId ==
+              TypeIdOf("TestCase8Nsp::TestCase8Nsp2::TestCase8_2"));
+static_assert(ReflData<TestCase15<float, 3>>::typeId ==
+              TypeIdOf("TestCase15<float, 3>"));
+static_assert(ReflData<TestCase4<int>>::typeId == 0);
+
+// enums
+static_assert(EnumCount<TestCase16Mode>() == 4);
+static_assert(EnumToName(TestCase16Mode::Deferred) == "Deferred");
+// Default is an alias of Forward and Count follows it, the first name wins
+static_assert(EnumToName(TestCase16Mode::Default) == "Forward");
+static_assert(EnumToName(TestCase16Mode::Count) == "Deferred");
+static_assert(EnumToName(static_cast<TestCase16Mode>(2)).empty());
+static_assert(EnumFromName<TestCase16Mode>("Default") == TestCase16Mode::Forward);
+static_assert(EnumFromName<TestCase16Mode>("Count") == TestCase16Mode::Deferred);
+static_assert(!EnumFromName<TestCase16Mode>("Backward"));
+static_assert(EnumToName(TestCase16::Reflect) == "Reflect");
+static_assert(EnumToName(TestCase16::All) == "All");
+static_assert(EnumToName(static_cast<TestCase16::EFlag>(2)).empty());
+static_assert(EnumFromName<TestCase16::EFlag>("Shadow") == TestCase16::Shadow);
+static_assert(!EnumFromName<TestCase16::EFlag>("shadow"));
+static_assert(EnumContains(TestCase16::All));
+static_assert(!EnumContains(static_cast<TestCase16::EFlag>(3)));
+
+// method tables
+static_assert(MethodCount<TestCase17>() == 3);
+static_assert(FindMethod<TestCase17>("Hidden_no") == nullptr);
+static_assert(FindMethod<TestCase17>("Scale")->isConst);
+static_assert(FindMethod<TestCase17>("Twice")->isStatic);
+static_assert(FindMethod<TestCase17>("Scale")->params[1].name == "bias");
+
+namespace {
+void TestMethods() {
+  TestCase17 object{2.f};
+  float x = 3.f, bias = 0.5f, result = 0.f;
+  void *args[] = {&x, &bias};
+  FindMethod<TestCase17>("Scale")->invoke(&object, args, &result);
+  CHECK(result == 6.5f);
+
+  float scale = 4.f;
+  void *setArgs[] = {&scale};
+  FindMethod<TestCase17>("SetScale")->invoke(&object, setArgs, nullptr);
+  CHECK(object.scale == 4.f);
+
+  int a = 21, twice = 0;
+  void *twiceArgs[] = {&a};
+  FindMethod<TestCase17>("Twice")->invoke(nullptr, twiceArgs, &twice);
+  CHECK(twice == 42);
+
+  TestCase19Nsp::TestCase19 scaled{1.5f};
+  TestCase19Nsp::Scalar factor = 2.f, product = 0.f;
+  void *scaledArgs[] = {&factor};
+  FindMethod<TestCase19Nsp::TestCase19>("Scaled")->invoke(&scaled, scaledArgs,
+                                                          &product);
+  CHECK(product == 3.f);
+  int count = 0;
+  FindMethod<TestCase19Nsp::TestCase19>("Count")->invoke(&scaled, nullptr,
+                                                         &count);
+  CHECK(count == 1);
+}
+
+bool Equal(const TestCase18 &a, const TestCase18 &b) {
+  return std::memcmp(a.position, b.position, sizeof(a.position)) == 0 &&
+         a.life == b.life && a.id == b.id;
+}
+
+void TestSoA() {
+  std::vector<TestCase18> records(5);
+  for (int i = 0; i < 5; ++i) {
+    auto &record = records[i];
+    record.position[0] = i * 1.f;
+    record.position[1] = i * 2.f;
+    record.position[2] = i * 3.f;
+    record.life = i * 0.25f;
+    record.id = 100 + i;
+  }
+
+  auto soa = TestCase18SoA::FromAoS(records.data(), records.size());
+  CHECK(soa.Size() == 5);
+  CHECK(soa.life().size() == 5 && soa.life()[2] == 0.5f);
+  CHECK(soa.id()[4] == 104);
+  CHECK(soa.position()[3][1] == 6.f);
+  CHECK(Equal(soa.Get(1), records[1]));
+
+  // the columns are contiguous
+  CHECK(&soa.id()[1] == &soa.id()[0] + 1);
+
+  std::vector<TestCase18> back(5);
+  soa.ToAoS(back.data());
+  for (size_t i = 0; i < records.size(); ++i)
+    CHECK(Equal(back[i], records[i]));
+
+  auto replaced = records[0];
+  replaced.id = 7;
+  soa.Set(3, replaced);
+  CHECK(soa.id()[3] == 7 && soa.life()[3] == 0.f);
+  soa.Push(records[4]);
+  CHECK(soa.Size() == 6 && Equal(soa.Get(5), records[4]));
+  soa.Pop();
+  CHECK(soa.Size() == 5);
+  soa.Clear();
+  CHECK(soa.Empty());
+}
+} // namespace
+
+int main() {
+  TestMethods();
+  TestSoA();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// generated/test.std140.gen.inl, or test.std430.gen.inl with
+// CONSUMER_STD430: GPU block offsets and the bytes PackTo writes, against a
+// packer written by hand from the GLSL layout rules.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#ifdef CONSUMER_STD430
+#include "generated/test.std430.gen.inl"
+#else
+#include "generated/test.std140.gen.inl"
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace PRefl;
+using TestCase23Nsp::TestCase23;
+
+// std140 rounds the stride of arrays and the alignment of structs up to 16
+// bytes, std430 does not. bool is 4 bytes in both.
+#ifdef CONSUMER_STD430
+constexpr EGpuLayout c_layout = EGpuLayout::Std430;
+constexpr size_t c_scalarStride = 4;
+constexpr size_t c_size21 = 32, c_weights21 = 20;
+constexpr size_t c_size23 = 320, c_lights23 = 176, c_lightCount23 = 304;
+#else
+constexpr EGpuLayout c_layout = EGpuLayout::Std140;
+constexpr size_t c_scalarStride = 16;
+constexpr size_t c_size21 = 64, c_weights21 = 32;
+constexpr size_t c_size23 = 368, c_lights23 = 224, c_lightCount23 = 352;
+#endif
+
+using Block21 = GpuBlock<TestCase21>;
+static_assert(Block21::layout == c_layout);
+static_assert(Block21::size == c_size21 && Block21::align == 16);
+static_assert(Block21::members[0].name == "direction" &&
+              Block21::members[0].offset == 0 &&
+              Block21::members[0].size == 12);
+// a scalar fills the end of the vec3
+static_assert(Block21::members[1].offset == 12);
+static_assert(Block21::members[2].offset == 16 && Block21::members[2].size == 4);
+static_assert(Block21::members[3].offset == c_weights21 &&
+              Block21::members[3].size == 2 * c_scalarStride);
+
+using Block23 = GpuBlock<TestCase23>;
+static_assert(Block23::size == c_size23 && Block23::align == 16);
+static_assert(Block23::members[0].offset == 0 && Block23::members[0].size == 64);
+static_assert(Block23::members[2].offset == 128 &&
+              Block23::members[3].offset == 140);
+static_assert(Block23::members[4].offset == 144 &&
+              Block23::members[6].offset == 156);
+static_assert(Block23::members[7].offset == 160 &&
+              Block23::members[7].size == 4 * c_scalarStride);
+static_assert(Block23::members[8].offset == c_lights23 &&
+              Block23::members[8].size == 128);
+static_assert(Block23::members[9].offset == c_lightCount23);
+
+namespace {
+void Put(unsigned char *dst, const void *src, size_t size) {
+  std::memcpy(dst, src, size);
+}
+
+void PutBool(unsigned char *dst, bool value) {
+  uint32_t word = value;
+  std::memcpy(dst, &word, sizeof(word));
+}
+
+void PackByHand(const TestCase21 &record, unsigned char *out) {
+  Put(out + 0, &record.direction, 12);
+  Put(out + 12, &record.intensity, 4);
+  PutBool(out + 16, record.enabled);
+  for (size_t i = 0; i < 2; ++i)
+    Put(out + c_weights21 + i * c_scalarStride, &record.weights[i], 4);
+}
+
+void PackByHand(const TestCase23 &record, unsigned char *out) {
+  Put(out + 0, &record.view, 64);
+  Put(out + 64, &record.projection, 64);
+  Put(out + 128, &record.eye, 12);
+  Put(out + 140, &record.time, 4);
+  Put(out + 144, &record.jitter, 8);
+  Put(out + 152, &record.frame, 4);
+  PutBool(out + 156, record.taa);
+  for (size_t i = 0; i < 4; ++i)
+    Put(out + 160 + i * c_scalarStride, &record.cascadeSplits[i], 4);
+  for (size_t i = 0; i < 4; ++i) {
+    auto &light = record.lights[i];
+    auto *dst = out + c_lights23 + i * 32;
+    Put(dst + 0, &light.position, 12);
+    Put(dst + 12, &light.radius, 4);
+    Put(dst + 16, &light.color, 12);
+    PutBool(dst + 28, light.castShadows);
+  }
+  Put(out + c_lightCount23, &record.lightCount, 4);
+}
+
+float Value(size_t i, size_t k) { return static_cast<float>(i * 100 + k); }
+
+TestCase23 MakeFrame(size_t i) {
+  TestCase23 frame{};
+  for (size_t c = 0; c < 4; ++c) {
+    frame.view.value[c] = {Value(i, c), Value(i, c + 4), Value(i, c + 8),
+                           Value(i, c + 12)};
+    frame.projection.value[c] = {-Value(i, c), 1.f, 2.f, 3.f};
+  }
+  frame.eye = {Value(i, 16), Value(i, 17), Value(i, 18)};
+  frame.time = Value(i, 19);
+  frame.jitter = {Value(i, 20), Value(i, 21)};
+  frame.frame = static_cast<int>(i);
+  frame.taa = i % 2 == 0;
+  for (size_t k = 0; k < 4; ++k) {
+    frame.cascadeSplits[k] = Value(i, 22 + k);
+    auto &light = frame.lights[k];
+    light.position = {Value(i, 26 + k), Value(i, 30 + k), Value(i, 34 + k)};
+    light.radius = Value(i, 38 + k);
+    light.color = {Value(i, 42 + k), Value(i, 46 + k), Value(i, 50 + k)};
+    light.castShadows = (i + k) % 3 == 0;
+  }
+  frame.lightCount = static_cast<unsigned>(i % 5);
+  return frame;
+}
+
+// The padding of the block is left as it is, both packers start from the
+// same bytes.
+template <typename T> void CheckPack(const std::vector<T> &records) {
+  size_t size = GpuBlock<T>::size;
+  std::vector<unsigned char> generated(records.size() * size, 0xcd);
+  std::vector<unsigned char> byHand(generated);
+  PackArrayTo(records.data(), records.size(), generated.data());
+  for (size_t i = 0; i < records.size(); ++i)
+    PackByHand(records[i], byHand.data() + i * size);
+  CHECK(generated == byHand);
+
+  PackTo(records[0], generated.data());
+  CHECK(generated == byHand);
+}
+
+void TestPack() {
+  std::vector<TestCase21> lights(3);
+  for (size_t i = 0; i < lights.size(); ++i) {
+    lights[i].direction = {Value(i, 0), Value(i, 1), Value(i, 2)};
+    lights[i].intensity = Value(i, 3);
+    lights[i].enabled = i != 1;
+    lights[i].weights[0] = Value(i, 4);
+    lights[i].weights[1] = Value(i, 5);
+  }
+  CheckPack(lights);
+
+  std::vector<TestCase23> frames;
+  for (size_t i = 0; i < 3; ++i)
+    frames.push_back(MakeFrame(i));
+  CheckPack(frames);
+}
+} // namespace
+
+int main() {
+  TestPack();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
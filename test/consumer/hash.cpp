@@ -0,0 +1,63 @@
+// generated/test.hash.gen.inl: hashing the reflected fields of records.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.hash.gen.inl"
+
+#include <cstring>
+#include <new>
+
+using namespace PRefl;
+
+namespace {
+// A TestCase20 whose padding bytes (between c and d) are `fill`.
+TestCase20 *Make(void *storage, unsigned char fill, double d) {
+  std::memset(storage, fill, sizeof(TestCase20));
+  auto *record = new (storage) TestCase20;
+  record->a = 1;
+  record->b = 2;
+  record->c = 0.5f;
+  record->d = d;
+  return record;
+}
+
+void TestHash() {
+  alignas(TestCase20) unsigned char storage0[sizeof(TestCase20)];
+  alignas(TestCase20) unsigned char storage1[sizeof(TestCase20)];
+  auto *a = Make(storage0, 0x00, 0.25);
+  auto *b = Make(storage1, 0xff, 0.25);
+  // equal fields hash equal, the padding is not hashed
+  CHECK(Hash(*a) == Hash(*b));
+  CHECK(Hash(*a, 1) == Hash(*b, 1));
+  CHECK(Hash(*a, 1) != Hash(*a, 2));
+  b->d = 0.5;
+  CHECK(Hash(*a) != Hash(*b));
+  b->d = 0.25;
+  b->b = 3;
+  CHECK(Hash(*a) != Hash(*b));
+
+  // nested records are hashed through their own Hasher
+  TestCase11 x{}, y{};
+  x.t._a = y.t._a = 4;
+  // a_no is not reflected
+  y.t.a_no = 5;
+  CHECK(Hash(x) == Hash(y));
+  y.t._a = 6;
+  CHECK(Hash(x) != Hash(y));
+
+  TestCase18 p{{1.f, 2.f, 3.f}, 0.5f, 1}, q = p;
+  CHECK(Hash(p) == Hash(q));
+  q.position[2] = -3.f;
+  CHECK(Hash(p) != Hash(q));
+}
+} // namespace
+
+int main() {
+  TestHash();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+// generated/test.json.gen.inl: JSON writer and reader of the records.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.json.gen.inl"
+
+#include <string>
+
+using namespace PRefl;
+
+namespace {
+void TestRoundTrip() {
+  TestCase20 record{1, -2, 0.5f, 0.1};
+  std::string json;
+  ToJson(record, json);
+  CHECK(json == R"({"a":1,"b":-2,"c":0.5,"d":0.1})");
+  TestCase20 back{};
+  CHECK(FromJson(json, back));
+  CHECK(back.a == 1 && back.b == -2 && back.c == 0.5f && back.d == 0.1);
+
+  // nested records, enums and arrays; static fields are not written
+  TestCase11 outer;
+  outer.b = 3;
+  outer.t._a = 4;
+  json.clear();
+  ToJson(outer, json);
+  CHECK(json == R"({"b":3,"t":{"_a":4}})");
+
+  TestCase16 mode{TestCase16Mode::Deferred};
+  json.clear();
+  ToJson(mode, json);
+  CHECK(json == R"({"mode":1})");
+  TestCase16 modeBack{};
+  CHECK(FromJson(json, modeBack) && modeBack.mode == TestCase16Mode::Deferred);
+
+  TestCase18 particle{{1.f, 2.f, 3.f}, 0.25f, 9};
+  json.clear();
+  ToJson(particle, json);
+  CHECK(json == R"({"position":[1,2,3],"life":0.25,"id":9})");
+  TestCase18 particleBack{};
+  CHECK(FromJson(json, particleBack));
+  CHECK(particleBack.position[2] == 3.f && particleBack.life == 0.25f &&
+        particleBack.id == 9);
+}
+
+void TestReader() {
+  // unknown keys are skipped, missing keys leave the field untouched
+  TestCase20 record{7, 8, 9.f, 10.0};
+  CHECK(FromJson(R"( { "c" : 1.5, "x": {"y": [1, "z"]}, "a": -3 } )", record));
+  CHECK(record.a == -3 && record.b == 8 && record.c == 1.5f &&
+        record.d == 10.0);
+
+  TestCase11 outer{};
+  CHECK(FromJson(R"({"t":{"_a":5,"a_no":6}})", outer));
+  CHECK(outer.t._a == 5 && outer.t.a_no == 0);
+
+  CHECK(!FromJson(R"({"a":)", record));
+  CHECK(!FromJson(R"({"a":"text"})", record));
+  // elements past the end of a fixed array are skipped
+  TestCase18 particle{};
+  CHECK(FromJson(R"({"position":[1,2,3,4],"id":2})", particle));
+  CHECK(particle.position[2] == 3.f && particle.id == 2);
+}
+} // namespace
+
+int main() {
+  TestRoundTrip();
+  TestReader();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+// generated/test.kernels.gen.inl: the RANGE and STEP batch kernels.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.kernels.gen.inl"
+
+using namespace PRefl;
+
+namespace {
+void TestKernels() {
+  TestCase22 records[] = {{-3.f, 7.f, 0}, {0.5f, -1.f, -20}, {2.f, 1.f, -5}};
+  ClampToRange(records, 3);
+  CHECK(records[0].x == -1.f && records[1].x == 0.5f && records[2].x == 1.f);
+  CHECK(records[0].angle == 2 * kTestCase22Pi && records[1].angle == 0.f &&
+        records[2].angle == 1.f);
+  CHECK(records[0].level == -2 && records[1].level == -10 &&
+        records[2].level == -5);
+
+  // angle snaps to multiples of pi / 4, level has a negative STEP and no
+  // kernel
+  SnapToStep(records, 3);
+  CHECK(records[2].angle == kTestCase22Pi / 4);
+  CHECK(records[0].angle == 8 * (kTestCase22Pi / 4));
+  CHECK(records[2].level == -5);
+
+  // integers: the range is [1, 10.5], steps start at the lower bound
+  TestCase14 ints[] = {{0}, {12}, {6}};
+  ClampToRange(ints, 3);
+  CHECK(ints[0].a == 1 && ints[1].a == 10 && ints[2].a == 6);
+  SnapToStep(ints, 3);
+  CHECK(ints[0].a == 1 && ints[1].a == 10 && ints[2].a == 6);
+
+  // fields without RANGE are left as they are
+  TestCase18 particles[] = {{{5.f, 5.f, 5.f}, 2.f, 1}};
+  ClampToRange(particles, 1);
+  CHECK(particles[0].life == 1.f && particles[0].position[0] == 5.f);
+}
+} // namespace
+
+int main() {
+  TestKernels();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
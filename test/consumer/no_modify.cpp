@@ -0,0 +1,20 @@
+// generated/test.no_modify.gen.inl, the output of --no-modify-source: it
+// includes test.h itself, and test.h then skips the default output.
+
+#include "consumer.h"
+
+#include "generated/test.no_modify.gen.inl"
+
+using namespace PRefl;
+
+static_assert(ReflData<TestCase1>::hasData);
+static_assert(std::get<0>(ReflData<TestCase20>::fields.fields).name.View() ==
+              "a");
+static_assert(EnumToName(TestCase16::Shadow) == "Shadow");
+
+int main() {
+  TestCase18 records[2] = {{{1.f, 2.f, 3.f}, 0.5f, 1}, {{4.f, 5.f, 6.f}, 1.f, 2}};
+  auto soa = TestCase18SoA::FromAoS(records, 2);
+  CHECK(soa.Size() == 2 && soa.id()[1] == 2);
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
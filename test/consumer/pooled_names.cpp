@@ -0,0 +1,41 @@
+// generated/test.pooled_names.gen.inl: fields and attributes named through
+// the name table of their record.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.pooled_names.gen.inl"
+
+#include <string_view>
+
+using namespace PRefl;
+
+using Data14 = ReflData<TestCase14>;
+static_assert(Data14::names.count == 4);
+static_assert(Data14::names[0] == "a" && Data14::names[3] == "info");
+static_assert(Data14::names.Find("step") == 2 && Data14::names.Find("b") == -1);
+
+constexpr auto &c_a = std::get<0>(Data14::fields.fields);
+static_assert(c_a.name == "a" && c_a.pointer == &TestCase14::a);
+static_assert(std::get<0>(c_a.attrs.attrs).name == "range");
+static_assert(std::get<2>(c_a.attrs.attrs).name == std::string_view{"info"});
+
+// a name used by several fields and attributes is stored once
+using Data22 = ReflData<TestCase22>;
+static_assert(Data22::names.count == 5);
+constexpr auto &c_x = std::get<0>(Data22::fields.fields);
+constexpr auto &c_level = std::get<2>(Data22::fields.fields);
+static_assert(std::get<0>(c_x.attrs.attrs).name ==
+              std::get<0>(c_level.attrs.attrs).name);
+static_assert(c_level.name == "level");
+
+// the names of a record have one type and hold only their index
+static_assert(std::is_same_v<decltype(c_x.name), decltype(c_level.name)>);
+static_assert(sizeof(c_a.name) == sizeof(uint32_t));
+static_assert(c_a.name != c_x.name);
+
+int main() { return 0; }
@@ -0,0 +1,89 @@
+// generated/test.registry.gen.inl: the records registered during static
+// initialization, and registrations of a module coming and going.
+
+#include "consumer.h"
+
+// test.h includes the default output at its end, its include guard keeps it
+// out
+#define __TEST__GEN_INL__
+#include "test.h"
+#undef __TEST__GEN_INL__
+#include "generated/test.registry.gen.inl"
+
+#include <cstddef>
+#include <optional>
+
+using namespace PRefl;
+
+namespace {
+void TestFind() {
+  auto &registry = Registry::Instance();
+  auto *info = registry.Find("TestCase20");
+  CHECK(info && info == registry.Find(ReflData<TestCase20>::typeId));
+  if (info) {
+    CHECK(info->size == sizeof(TestCase20) &&
+          info->align == alignof(TestCase20));
+    CHECK(info->fieldCount == 4);
+    CHECK(info->fields[3].name == "d" &&
+          info->fields[3].offset == offsetof(TestCase20, d) &&
+          info->fields[3].size == sizeof(double));
+  }
+
+  auto *nested = registry.Find("TestCase5::TestCase5Inner");
+  CHECK(nested && nested->fieldCount == 1 && nested->fields[0].name == "a_in");
+  auto *spec = registry.Find("TestCase15<float, 3>");
+  CHECK(spec && spec->size == sizeof(TestCase15<float, 3>));
+
+  // only the public fields are reflected
+  auto *outer = registry.Find("TestCase11");
+  CHECK(outer && outer->fieldCount == 2 && outer->fields[1].name == "t" &&
+        outer->fields[1].size == sizeof(TestCase1));
+
+  // class templates have no type ID, TestCase2_no is not reflected
+  CHECK(!registry.Find("TestCase4"));
+  CHECK(!registry.Find("TestCase2_no"));
+  CHECK(!registry.Find(TypeIdOf("TestCase20") + 1));
+}
+
+void TestRegister() {
+  auto &registry = Registry::Instance();
+  size_t size = registry.Size();
+  const FieldInfo field{"value", 0, sizeof(int)};
+  RecordInfo plugin{TypeIdOf("Plugin::Record"), "Plugin::Record", sizeof(int),
+                    alignof(int)};
+
+  std::optional<Registration> registration;
+  registration.emplace(plugin, std::initializer_list<FieldInfo>{field});
+  CHECK(registration->Get() && registry.Size() == size + 1);
+  auto *found = registry.Find("Plugin::Record");
+  CHECK(found == registration->Get());
+  CHECK(found && found->fields[0].name == "value");
+
+  // a second module registering the same record shares it
+  std::optional<Registration> again;
+  again.emplace(plugin, std::initializer_list<FieldInfo>{field});
+  CHECK(again->Get() == found && registry.Size() == size + 1);
+  again.reset();
+  CHECK(registry.Find("Plugin::Record") == found);
+
+  // the registry keeps its copy readable after the last module leaves
+  registration.reset();
+  CHECK(!registry.Find("Plugin::Record") && registry.Size() == size);
+  CHECK(found->name == "Plugin::Record");
+
+  // another record with a taken ID is refused
+  RecordInfo clash{ReflData<TestCase20>::typeId, "Plugin::Clash", 4, 4};
+  Registration refused{clash, {}};
+  CHECK(!refused.Get());
+  CHECK(registry.Find(ReflData<TestCase20>::typeId)->name == "TestCase20");
+
+  registration.emplace(plugin, std::initializer_list<FieldInfo>{field});
+  CHECK(registration->Get() == found);
+}
+} // namespace
+
+int main() {
+  TestFind();
+  TestRegister();
+  return ConsumerTest::Failures() == 0 ? 0 : 1;
+}
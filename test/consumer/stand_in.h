@@ -0,0 +1,62 @@
+#pragma once
+
+// Stand-in for the Pupil Reflection header, which the generated files expect
+// to be included before them (https://github.com/mchenwang/PupilReflect). It
+// is not part of this repository, so the consumer tests and benchmarks declare
+// types of the same shape: ReflData, Name<"...">, Attribute, Field and the
+// arrays of them. They keep the names, member pointers and attribute values,
+// enough to check the field tables.
+
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+
+namespace PRefl {
+template <typename T> struct ReflData {
+  constexpr static bool hasData = false;
+  constexpr static bool hasBases = false;
+};
+
+template <size_t N> struct FixedString {
+  char chars[N]{};
+  constexpr FixedString(const char (&str)[N]) {
+    for (size_t i = 0; i < N; ++i)
+      chars[i] = str[i];
+  }
+};
+
+template <FixedString S> struct Name {
+  constexpr std::string_view View() const { return {S.chars, sizeof(S) - 1}; }
+  constexpr operator std::string_view() const { return View(); }
+};
+
+template <typename N, typename... V> struct Attribute {
+  N name;
+  std::tuple<V...> value;
+  constexpr Attribute(N name, V... value) : name(name), value(value...) {}
+};
+
+template <typename... A> struct AttrArray {
+  std::tuple<A...> attrs;
+  constexpr AttrArray(A... attrs) : attrs(attrs...) {}
+};
+
+template <typename N, typename P, typename A> struct Field {
+  N name;
+  P pointer;
+  A attrs;
+  constexpr Field(N name, P pointer, A attrs)
+      : name(name), pointer(pointer), attrs(attrs) {}
+};
+
+template <typename... F> struct FieldArray {
+  constexpr static size_t size = sizeof...(F);
+  std::tuple<F...> fields;
+  constexpr FieldArray(F... fields) : fields(fields...) {}
+};
+
+template <typename... R> struct ReflDataArray {
+  constexpr static size_t size = sizeof...(R);
+  constexpr ReflDataArray(R...) {}
+};
+} // namespace PRefl
@@ -4,12 +4,60 @@
 
 #ifndef __TEST__GEN_INL__
 #define __TEST__GEN_INL__
+#include "PReflEnum.h"
+#include "PReflMethod.h"
+#include "PReflSoA.h"
 namespace PRefl {
 template<>
+struct EnumData<TestCase16Mode>
+{
+    constexpr static size_t count = 4;
+    constexpr static auto min = TestCase16Mode::Forward;
+    constexpr static auto max = TestCase16Mode::Deferred;
+    constexpr static auto entries = std::array<EnumEntry<TestCase16Mode>, 4> {{
+        { TestCase16Mode::Forward, "Forward" },
+        { TestCase16Mode::Deferred, "Deferred" },
+        { TestCase16Mode::Default, "Default" },
+        { TestCase16Mode::Count, "Count" }
+    }};
+    constexpr static bool isDense = true;
+    constexpr static auto names = std::array<std::string_view, 2> {
+        "Forward",
+        "Deferred"
+    };
+    constexpr static auto nameIndex = EnumHashIndex<2, 8> {
+        {0, 1},
+        {3, 0, 4, 2, 1, 0, 0, 0}
+    };
+};
+template<>
+struct EnumData<TestCase16::EFlag>
+{
+    constexpr static size_t count = 4;
+    constexpr static auto min = TestCase16::EFlag::None;
+    constexpr static auto max = TestCase16::EFlag::All;
+    constexpr static auto entries = std::array<EnumEntry<TestCase16::EFlag>, 4> {{
+        { TestCase16::EFlag::None, "None" },
+        { TestCase16::EFlag::Shadow, "Shadow" },
+        { TestCase16::EFlag::Reflect, "Reflect" },
+        { TestCase16::EFlag::All, "All" }
+    }};
+    constexpr static bool isDense = false;
+    constexpr static auto valueIndex = EnumHashIndex<2, 8> {
+        {0, 0},
+        {1, 0, 0, 4, 0, 2, 3, 0}
+    };
+    constexpr static auto nameIndex = EnumHashIndex<2, 8> {
+        {1, 0},
+        {3, 2, 0, 1, 4, 0, 0, 0}
+    };
+};
+template<>
 struct ReflData<TestCase1>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x90662add3ceff868ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"_a">{}, &TestCase1::_a, AttrArray {} }
     };
@@ -19,12 +67,14 @@ struct ReflData<TestCase3>
 {
     constexpr static bool hasData = false;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xb6b3735bb0eb1638ull;
 };
 template<typename T>
 struct ReflData<TestCase4<T>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase4<T>::a, AttrArray {} }
     };
@@ -34,6 +84,7 @@ struct ReflData<TestCase5::TestCase5Inner>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x09bdc78684edcbaeull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a_in">{}, &TestCase5::TestCase5Inner::a_in, AttrArray {} }
     };
@@ -43,6 +94,7 @@ struct ReflData<TestCase5>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x57f8c38d6a71de0cull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase5::a, AttrArray {} }
     };
@@ -52,6 +104,7 @@ struct ReflData<TestCase6::TestCase6Inner<T>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a_in">{}, &TestCase6::TestCase6Inner<T>::a_in, AttrArray {} }
     };
@@ -61,24 +114,17 @@ struct ReflData<TestCase6>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xd399692170e6db74ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase6::a, AttrArray {} }
     };
 };
-template<>
-struct ReflData<TestCase7::TestCase7Inner>
-{
-    constexpr static bool hasData = true;
-    constexpr static bool hasBases = false;
-    constexpr static auto fields = FieldArray {
-        Field { Name<"a_in">{}, &TestCase7::TestCase7Inner::a_in, AttrArray {} }
-    };
-};
 template<typename T>
 struct ReflData<TestCase7<T>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase7<T>::a, AttrArray {} }
     };
@@ -88,6 +134,7 @@ struct ReflData<TestCase8Nsp::TestCase8<T1, T2>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase8Nsp::TestCase8<T1, T2>::a, AttrArray {} },
         Field { Name<"b">{}, &TestCase8Nsp::TestCase8<T1, T2>::b, AttrArray {} }
@@ -98,6 +145,7 @@ struct ReflData<TestCase8Nsp::TestCase8Nsp2::TestCase8_2>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xa867d26e27c91790ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a2">{}, &TestCase8Nsp::TestCase8Nsp2::TestCase8_2::a2, AttrArray {} }
     };
@@ -107,6 +155,7 @@ struct ReflData<TestCase9<T1, T2>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto bases = ReflDataArray {
         ReflData<TestCase8Nsp::TestCase8Nsp2::TestCase8_2> {},
         ReflData<TestCase4<T2>> {}
@@ -123,6 +172,7 @@ struct ReflData<TestCase10_no::TestCase10Inner<T>>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a_in">{}, &TestCase10_no::TestCase10Inner<T>::a_in, AttrArray {} }
     };
@@ -132,6 +182,7 @@ struct ReflData<TestCase11>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xd81ef8b9240b05cfull;
     constexpr static auto fields = FieldArray {
         Field { Name<"b">{}, &TestCase11::b, AttrArray {} },
         Field { Name<"t">{}, &TestCase11::t, AttrArray {} }
@@ -142,6 +193,7 @@ struct ReflData<TestCase12_1>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x7bc3af6435e4173cull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase12_1::a, AttrArray {} }
     };
@@ -151,6 +203,7 @@ struct ReflData<TestCase12_2>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xdbc51615160551c6ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"b">{}, &TestCase12_2::b, AttrArray {} }
     };
@@ -160,6 +213,7 @@ struct ReflData<TestCase12_3>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0x891fa5ee25cbf816ull;
     constexpr static auto bases = ReflDataArray {
         ReflData<TestCase12_1> {}
     };
@@ -172,6 +226,7 @@ struct ReflData<TestCase12_4>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0xcb66a1c339b9b523ull;
     constexpr static auto bases = ReflDataArray {
         ReflData<TestCase12_2> {}
     };
@@ -184,6 +239,7 @@ struct ReflData<TestCase13>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x4b613eecbc396928ull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase13::a, AttrArray {Attribute{ Name<"range">{}, std::make_pair(0, 1) }} }
     };
@@ -193,6 +249,7 @@ struct ReflData<TestCase14>
 {
     constexpr static bool hasData = true;
     constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x14b5a145a01ca53bull;
     constexpr static auto fields = FieldArray {
         Field { Name<"a">{}, &TestCase14::a,
             AttrArray{
@@ -203,5 +260,263 @@ struct ReflData<TestCase14>
         }
     };
 };
+template<typename T, int N>
+struct ReflData<TestCase15<T, N>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"a">{}, &TestCase15<T, N>::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase15<float, 3>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x05516582e0b555bbull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"a">{}, &TestCase15<float, 3>::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase15_User>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x1bb3ee0f41bde150ull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"v">{}, &TestCase15_User::v, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase16>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x82627eb45f7bfe1full;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"mode">{}, &TestCase16::mode, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase17>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xc2d97d89464f7324ull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"scale">{}, &TestCase17::scale, AttrArray {} }
+    };
+};
+template<>
+struct MethodData<TestCase17>
+{
+    static void Invoke0(void *object, void *const *args, void *result) {
+        MethodDetail::Store<float>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase17 *>(object)->Scale(MethodDetail::Arg<float>(args[0]), MethodDetail::Arg<const float &>(args[1]));
+        });
+    }
+    constexpr static auto params0 = std::array<MethodParam, 2> {{
+        { "x", TypeTagOf<float>() },
+        { "bias", TypeTagOf<const float &>() }
+    }};
+    static void Invoke1(void *object, void *const *args, void *result) {
+        MethodDetail::Store<void>(result, [&]() -> decltype(auto) {
+            return static_cast<TestCase17 *>(object)->SetScale(MethodDetail::Arg<float>(args[0]));
+        });
+    }
+    constexpr static auto params1 = std::array<MethodParam, 1> {{
+        { "s", TypeTagOf<float>() }
+    }};
+    static void Invoke2(void *, void *const *args, void *result) {
+        MethodDetail::Store<int>(result, [&]() -> decltype(auto) {
+            return TestCase17::Twice(MethodDetail::Arg<int>(args[0]));
+        });
+    }
+    constexpr static auto params2 = std::array<MethodParam, 1> {{
+        { "a", TypeTagOf<int>() }
+    }};
+    constexpr static auto methods = std::array<Method, 3> {{
+        { "Scale", &Invoke0, TypeTagOf<float>(), params0.data(), params0.size(), true, false },
+        { "SetScale", &Invoke1, TypeTagOf<void>(), params1.data(), params1.size(), false, false },
+        { "Twice", &Invoke2, TypeTagOf<int>(), params2.data(), params2.size(), false, true }
+    }};
+};
+template<>
+struct ReflData<TestCase18>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0892a99e156d0925ull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"position">{}, &TestCase18::position, AttrArray {} },
+        Field { Name<"life">{}, &TestCase18::life, AttrArray {Attribute{ Name<"range">{}, std::make_pair(0, 1) }} },
+        Field { Name<"id">{}, &TestCase18::id, AttrArray {} },
+        Field { Name<"kind">{}, &TestCase18::kind, AttrArray {} }
+    };
+};
+template<>
+class SoA<TestCase18>
+{
+public:
+    using Record = TestCase18;
+    size_t Size() const { return m_position.size(); }
+    bool Empty() const { return m_position.empty(); }
+    void Reserve(size_t count) {
+        m_position.reserve(count);
+        m_life.reserve(count);
+        m_id.reserve(count);
+    }
+    void Clear() {
+        m_position.clear();
+        m_life.clear();
+        m_id.clear();
+    }
+    void Push(const Record &record) {
+        SoADetail::Push(m_position, record.position);
+        SoADetail::Push(m_life, record.life);
+        SoADetail::Push(m_id, record.id);
+    }
+    void Pop() {
+        m_position.pop_back();
+        m_life.pop_back();
+        m_id.pop_back();
+    }
+    Record Get(size_t i) const {
+        Record record{};
+        SoADetail::Store(record.position, m_position[i]);
+        SoADetail::Store(record.life, m_life[i]);
+        SoADetail::Store(record.id, m_id[i]);
+        return record;
+    }
+    void Set(size_t i, const Record &record) {
+        SoADetail::Load(m_position[i], record.position);
+        SoADetail::Load(m_life[i], record.life);
+        SoADetail::Load(m_id[i], record.id);
+    }
+    static SoA FromAoS(const Record *records, size_t count) {
+        SoA soa;
+        soa.m_position.resize(count);
+        soa.m_life.resize(count);
+        soa.m_id.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_position[i], records[i].position);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_life[i], records[i].life);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_id[i], records[i].id);
+        return soa;
+    }
+    void ToAoS(Record *records) const {
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].position, m_position[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].life, m_life[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].id, m_id[i]);
+    }
+    std::span<SoADetail::ElementT<decltype(Record::position)>> position() { return m_position; }
+    std::span<const SoADetail::ElementT<decltype(Record::position)>> position() const { return m_position; }
+    std::span<SoADetail::ElementT<decltype(Record::life)>> life() { return m_life; }
+    std::span<const SoADetail::ElementT<decltype(Record::life)>> life() const { return m_life; }
+    std::span<SoADetail::ElementT<decltype(Record::id)>> id() { return m_id; }
+    std::span<const SoADetail::ElementT<decltype(Record::id)>> id() const { return m_id; }
+private:
+    std::vector<SoADetail::ElementT<decltype(Record::position)>> m_position;
+    std::vector<SoADetail::ElementT<decltype(Record::life)>> m_life;
+    std::vector<SoADetail::ElementT<decltype(Record::id)>> m_id;
+};
+template<>
+struct ReflData<TestCase19Nsp::TestCase19>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xbaba93c4886a5abeull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"s">{}, &TestCase19Nsp::TestCase19::s, AttrArray {} }
+    };
+};
+template<>
+struct MethodData<TestCase19Nsp::TestCase19>
+{
+    static void Invoke0(void *object, void *const *args, void *result) {
+        MethodDetail::Store<TestCase19Nsp::Scalar>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase19Nsp::TestCase19 *>(object)->Scaled(MethodDetail::Arg<TestCase19Nsp::Scalar>(args[0]));
+        });
+    }
+    constexpr static auto params0 = std::array<MethodParam, 1> {{
+        { "x", TypeTagOf<TestCase19Nsp::Scalar>() }
+    }};
+    static void Invoke1(void *object, void *const *, void *result) {
+        MethodDetail::Store<TestCase19Nsp::TestCase19::value_type>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase19Nsp::TestCase19 *>(object)->Count();
+        });
+    }
+    constexpr static auto params1 = std::array<MethodParam, 0> {{}};
+    constexpr static auto methods = std::array<Method, 2> {{
+        { "Scaled", &Invoke0, TypeTagOf<TestCase19Nsp::Scalar>(), params0.data(), params0.size(), true, false },
+        { "Count", &Invoke1, TypeTagOf<TestCase19Nsp::TestCase19::value_type>(), params1.data(), params1.size(), true, false }
+    }};
+};
+template<>
+struct ReflData<TestCase20>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x1f4e9ac4b621918bull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"a">{}, &TestCase20::a, AttrArray {} },
+        Field { Name<"b">{}, &TestCase20::b, AttrArray {} },
+        Field { Name<"c">{}, &TestCase20::c, AttrArray {} },
+        Field { Name<"d">{}, &TestCase20::d, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase21>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xfb8219f04520ad5eull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"direction">{}, &TestCase21::direction, AttrArray {} },
+        Field { Name<"intensity">{}, &TestCase21::intensity, AttrArray {} },
+        Field { Name<"enabled">{}, &TestCase21::enabled, AttrArray {} },
+        Field { Name<"weights">{}, &TestCase21::weights, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase22>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x20c41907488a2fefull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"x">{}, &TestCase22::x, AttrArray {Attribute{ Name<"range">{}, std::make_pair(-1, 1) }} },
+        Field { Name<"angle">{}, &TestCase22::angle, AttrArray {Attribute{ Name<"range">{}, std::make_pair(0, 6.2831854820251465) }, Attribute{ Name<"step">{}, 0.78539818525314331 }} },
+        Field { Name<"level">{}, &TestCase22::level, AttrArray {Attribute{ Name<"range">{}, std::make_pair(-10, -2) }, Attribute{ Name<"step">{}, -0.5 }} }
+    };
+};
+template<>
+struct ReflData<TestCase23Nsp::TestCase23>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x23dbb3ca4dd8075bull;
+    constexpr static auto fields = FieldArray {
+        Field { Name<"view">{}, &TestCase23Nsp::TestCase23::view, AttrArray {} },
+        Field { Name<"projection">{}, &TestCase23Nsp::TestCase23::projection, AttrArray {} },
+        Field { Name<"eye">{}, &TestCase23Nsp::TestCase23::eye, AttrArray {} },
+        Field { Name<"time">{}, &TestCase23Nsp::TestCase23::time, AttrArray {} },
+        Field { Name<"jitter">{}, &TestCase23Nsp::TestCase23::jitter, AttrArray {} },
+        Field { Name<"frame">{}, &TestCase23Nsp::TestCase23::frame, AttrArray {} },
+        Field { Name<"taa">{}, &TestCase23Nsp::TestCase23::taa, AttrArray {} },
+        Field { Name<"cascadeSplits">{}, &TestCase23Nsp::TestCase23::cascadeSplits, AttrArray {} },
+        Field { Name<"lights">{}, &TestCase23Nsp::TestCase23::lights, AttrArray {} },
+        Field { Name<"lightCount">{}, &TestCase23Nsp::TestCase23::lightCount, AttrArray {} }
+    };
+};
 }
+using TestCase18SoA = PRefl::SoA<TestCase18>;
 #endif
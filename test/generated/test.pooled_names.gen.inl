@@ -0,0 +1,610 @@
+//===================================================
+// Automatically generated by Pupil Reflection Tool
+//===================================================
+
+#ifndef __TEST__GEN_INL__
+#define __TEST__GEN_INL__
+#include "PReflEnum.h"
+#include "PReflNames.h"
+#include "PReflMethod.h"
+#include "PReflSoA.h"
+namespace PRefl {
+template<>
+struct EnumData<TestCase16Mode>
+{
+    constexpr static size_t count = 4;
+    constexpr static auto min = TestCase16Mode::Forward;
+    constexpr static auto max = TestCase16Mode::Deferred;
+    constexpr static auto entries = std::array<EnumEntry<TestCase16Mode>, 4> {{
+        { TestCase16Mode::Forward, "Forward" },
+        { TestCase16Mode::Deferred, "Deferred" },
+        { TestCase16Mode::Default, "Default" },
+        { TestCase16Mode::Count, "Count" }
+    }};
+    constexpr static bool isDense = true;
+    constexpr static auto names = std::array<std::string_view, 2> {
+        "Forward",
+        "Deferred"
+    };
+    constexpr static auto nameIndex = EnumHashIndex<2, 8> {
+        {0, 1},
+        {3, 0, 4, 2, 1, 0, 0, 0}
+    };
+};
+template<>
+struct EnumData<TestCase16::EFlag>
+{
+    constexpr static size_t count = 4;
+    constexpr static auto min = TestCase16::EFlag::None;
+    constexpr static auto max = TestCase16::EFlag::All;
+    constexpr static auto entries = std::array<EnumEntry<TestCase16::EFlag>, 4> {{
+        { TestCase16::EFlag::None, "None" },
+        { TestCase16::EFlag::Shadow, "Shadow" },
+        { TestCase16::EFlag::Reflect, "Reflect" },
+        { TestCase16::EFlag::All, "All" }
+    }};
+    constexpr static bool isDense = false;
+    constexpr static auto valueIndex = EnumHashIndex<2, 8> {
+        {0, 0},
+        {1, 0, 0, 4, 0, 2, 3, 0}
+    };
+    constexpr static auto nameIndex = EnumHashIndex<2, 8> {
+        {1, 0},
+        {3, 2, 0, 1, 4, 0, 0, 0}
+    };
+};
+template<>
+struct ReflData<TestCase1>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x90662add3ceff868ull;
+    constexpr static char nameChars[] = "_a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 3};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase1>{0}, &TestCase1::_a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase3>
+{
+    constexpr static bool hasData = false;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xb6b3735bb0eb1638ull;
+};
+template<typename T>
+struct ReflData<TestCase4<T>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase4<T>>{0}, &TestCase4<T>::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase5::TestCase5Inner>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x09bdc78684edcbaeull;
+    constexpr static char nameChars[] = "a_in\0";
+    constexpr static uint32_t nameOffsets[] = {0, 5};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase5::TestCase5Inner>{0}, &TestCase5::TestCase5Inner::a_in, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase5>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x57f8c38d6a71de0cull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase5>{0}, &TestCase5::a, AttrArray {} }
+    };
+};
+template<typename T>
+struct ReflData<TestCase6::TestCase6Inner<T>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a_in\0";
+    constexpr static uint32_t nameOffsets[] = {0, 5};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase6::TestCase6Inner<T>>{0}, &TestCase6::TestCase6Inner<T>::a_in, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase6>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xd399692170e6db74ull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase6>{0}, &TestCase6::a, AttrArray {} }
+    };
+};
+template<typename T>
+struct ReflData<TestCase7<T>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase7<T>>{0}, &TestCase7<T>::a, AttrArray {} }
+    };
+};
+template<typename T1, typename T2>
+struct ReflData<TestCase8Nsp::TestCase8<T1, T2>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a\0" "b\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 4};
+    constexpr static NameTable names {nameChars, nameOffsets, 2};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase8Nsp::TestCase8<T1, T2>>{0}, &TestCase8Nsp::TestCase8<T1, T2>::a, AttrArray {} },
+        Field { PooledName<TestCase8Nsp::TestCase8<T1, T2>>{1}, &TestCase8Nsp::TestCase8<T1, T2>::b, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase8Nsp::TestCase8Nsp2::TestCase8_2>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xa867d26e27c91790ull;
+    constexpr static char nameChars[] = "a2\0";
+    constexpr static uint32_t nameOffsets[] = {0, 3};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase8Nsp::TestCase8Nsp2::TestCase8_2>{0}, &TestCase8Nsp::TestCase8Nsp2::TestCase8_2::a2, AttrArray {} }
+    };
+};
+template<typename T1, typename T2>
+struct ReflData<TestCase9<T1, T2>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static auto bases = ReflDataArray {
+        ReflData<TestCase8Nsp::TestCase8Nsp2::TestCase8_2> {},
+        ReflData<TestCase4<T2>> {}
+    };
+    constexpr static char nameChars[] = "c\0" "sc\0" "csc\0" "cc\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 5, 9, 12};
+    constexpr static NameTable names {nameChars, nameOffsets, 4};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase9<T1, T2>>{0}, &TestCase9<T1, T2>::c, AttrArray {} },
+        Field { PooledName<TestCase9<T1, T2>>{1}, &TestCase9<T1, T2>::sc, AttrArray {} },
+        Field { PooledName<TestCase9<T1, T2>>{2}, &TestCase9<T1, T2>::csc, AttrArray {} },
+        Field { PooledName<TestCase9<T1, T2>>{3}, &TestCase9<T1, T2>::cc, AttrArray {} }
+    };
+};
+template<typename T>
+struct ReflData<TestCase10_no::TestCase10Inner<T>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a_in\0";
+    constexpr static uint32_t nameOffsets[] = {0, 5};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase10_no::TestCase10Inner<T>>{0}, &TestCase10_no::TestCase10Inner<T>::a_in, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase11>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xd81ef8b9240b05cfull;
+    constexpr static char nameChars[] = "b\0" "t\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 4};
+    constexpr static NameTable names {nameChars, nameOffsets, 2};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase11>{0}, &TestCase11::b, AttrArray {} },
+        Field { PooledName<TestCase11>{1}, &TestCase11::t, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase12_1>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x7bc3af6435e4173cull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase12_1>{0}, &TestCase12_1::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase12_2>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xdbc51615160551c6ull;
+    constexpr static char nameChars[] = "b\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase12_2>{0}, &TestCase12_2::b, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase12_3>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0x891fa5ee25cbf816ull;
+    constexpr static auto bases = ReflDataArray {
+        ReflData<TestCase12_1> {}
+    };
+    constexpr static char nameChars[] = "c\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase12_3>{0}, &TestCase12_3::c, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase12_4>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = true;
+    constexpr static uint64_t typeId = 0xcb66a1c339b9b523ull;
+    constexpr static auto bases = ReflDataArray {
+        ReflData<TestCase12_2> {}
+    };
+    constexpr static char nameChars[] = "d\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase12_4>{0}, &TestCase12_4::d, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase13>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x4b613eecbc396928ull;
+    constexpr static char nameChars[] = "a\0" "range\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 8};
+    constexpr static NameTable names {nameChars, nameOffsets, 2};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase13>{0}, &TestCase13::a, AttrArray {Attribute{ PooledName<TestCase13>{1}, std::make_pair(0, 1) }} }
+    };
+};
+template<>
+struct ReflData<TestCase14>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x14b5a145a01ca53bull;
+    constexpr static char nameChars[] = "a\0" "range\0" "step\0" "info\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 8, 13, 18};
+    constexpr static NameTable names {nameChars, nameOffsets, 4};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase14>{0}, &TestCase14::a,
+            AttrArray{
+                Attribute{ PooledName<TestCase14>{1}, std::make_pair(1, 10.5) },
+                Attribute{ PooledName<TestCase14>{2}, 0.5 },
+                Attribute{ PooledName<TestCase14>{3}, "this is a info"}
+            }
+        }
+    };
+};
+template<typename T, int N>
+struct ReflData<TestCase15<T, N>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0000000000000000ull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase15<T, N>>{0}, &TestCase15<T, N>::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase15<float, 3>>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x05516582e0b555bbull;
+    constexpr static char nameChars[] = "a\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase15<float, 3>>{0}, &TestCase15<float, 3>::a, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase15_User>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x1bb3ee0f41bde150ull;
+    constexpr static char nameChars[] = "v\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase15_User>{0}, &TestCase15_User::v, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase16>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x82627eb45f7bfe1full;
+    constexpr static char nameChars[] = "mode\0";
+    constexpr static uint32_t nameOffsets[] = {0, 5};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase16>{0}, &TestCase16::mode, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase17>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xc2d97d89464f7324ull;
+    constexpr static char nameChars[] = "scale\0";
+    constexpr static uint32_t nameOffsets[] = {0, 6};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase17>{0}, &TestCase17::scale, AttrArray {} }
+    };
+};
+template<>
+struct MethodData<TestCase17>
+{
+    static void Invoke0(void *object, void *const *args, void *result) {
+        MethodDetail::Store<float>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase17 *>(object)->Scale(MethodDetail::Arg<float>(args[0]), MethodDetail::Arg<const float &>(args[1]));
+        });
+    }
+    constexpr static auto params0 = std::array<MethodParam, 2> {{
+        { "x", TypeTagOf<float>() },
+        { "bias", TypeTagOf<const float &>() }
+    }};
+    static void Invoke1(void *object, void *const *args, void *result) {
+        MethodDetail::Store<void>(result, [&]() -> decltype(auto) {
+            return static_cast<TestCase17 *>(object)->SetScale(MethodDetail::Arg<float>(args[0]));
+        });
+    }
+    constexpr static auto params1 = std::array<MethodParam, 1> {{
+        { "s", TypeTagOf<float>() }
+    }};
+    static void Invoke2(void *, void *const *args, void *result) {
+        MethodDetail::Store<int>(result, [&]() -> decltype(auto) {
+            return TestCase17::Twice(MethodDetail::Arg<int>(args[0]));
+        });
+    }
+    constexpr static auto params2 = std::array<MethodParam, 1> {{
+        { "a", TypeTagOf<int>() }
+    }};
+    constexpr static auto methods = std::array<Method, 3> {{
+        { "Scale", &Invoke0, TypeTagOf<float>(), params0.data(), params0.size(), true, false },
+        { "SetScale", &Invoke1, TypeTagOf<void>(), params1.data(), params1.size(), false, false },
+        { "Twice", &Invoke2, TypeTagOf<int>(), params2.data(), params2.size(), false, true }
+    }};
+};
+template<>
+struct ReflData<TestCase18>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x0892a99e156d0925ull;
+    constexpr static char nameChars[] = "position\0" "life\0" "range\0" "id\0" "kind\0";
+    constexpr static uint32_t nameOffsets[] = {0, 9, 14, 20, 23, 28};
+    constexpr static NameTable names {nameChars, nameOffsets, 5};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase18>{0}, &TestCase18::position, AttrArray {} },
+        Field { PooledName<TestCase18>{1}, &TestCase18::life, AttrArray {Attribute{ PooledName<TestCase18>{2}, std::make_pair(0, 1) }} },
+        Field { PooledName<TestCase18>{3}, &TestCase18::id, AttrArray {} },
+        Field { PooledName<TestCase18>{4}, &TestCase18::kind, AttrArray {} }
+    };
+};
+template<>
+class SoA<TestCase18>
+{
+public:
+    using Record = TestCase18;
+    size_t Size() const { return m_position.size(); }
+    bool Empty() const { return m_position.empty(); }
+    void Reserve(size_t count) {
+        m_position.reserve(count);
+        m_life.reserve(count);
+        m_id.reserve(count);
+    }
+    void Clear() {
+        m_position.clear();
+        m_life.clear();
+        m_id.clear();
+    }
+    void Push(const Record &record) {
+        SoADetail::Push(m_position, record.position);
+        SoADetail::Push(m_life, record.life);
+        SoADetail::Push(m_id, record.id);
+    }
+    void Pop() {
+        m_position.pop_back();
+        m_life.pop_back();
+        m_id.pop_back();
+    }
+    Record Get(size_t i) const {
+        Record record{};
+        SoADetail::Store(record.position, m_position[i]);
+        SoADetail::Store(record.life, m_life[i]);
+        SoADetail::Store(record.id, m_id[i]);
+        return record;
+    }
+    void Set(size_t i, const Record &record) {
+        SoADetail::Load(m_position[i], record.position);
+        SoADetail::Load(m_life[i], record.life);
+        SoADetail::Load(m_id[i], record.id);
+    }
+    static SoA FromAoS(const Record *records, size_t count) {
+        SoA soa;
+        soa.m_position.resize(count);
+        soa.m_life.resize(count);
+        soa.m_id.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_position[i], records[i].position);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_life[i], records[i].life);
+        for (size_t i = 0; i < count; ++i)
+            SoADetail::Load(soa.m_id[i], records[i].id);
+        return soa;
+    }
+    void ToAoS(Record *records) const {
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].position, m_position[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].life, m_life[i]);
+        for (size_t i = 0; i < Size(); ++i)
+            SoADetail::Store(records[i].id, m_id[i]);
+    }
+    std::span<SoADetail::ElementT<decltype(Record::position)>> position() { return m_position; }
+    std::span<const SoADetail::ElementT<decltype(Record::position)>> position() const { return m_position; }
+    std::span<SoADetail::ElementT<decltype(Record::life)>> life() { return m_life; }
+    std::span<const SoADetail::ElementT<decltype(Record::life)>> life() const { return m_life; }
+    std::span<SoADetail::ElementT<decltype(Record::id)>> id() { return m_id; }
+    std::span<const SoADetail::ElementT<decltype(Record::id)>> id() const { return m_id; }
+private:
+    std::vector<SoADetail::ElementT<decltype(Record::position)>> m_position;
+    std::vector<SoADetail::ElementT<decltype(Record::life)>> m_life;
+    std::vector<SoADetail::ElementT<decltype(Record::id)>> m_id;
+};
+template<>
+struct ReflData<TestCase19Nsp::TestCase19>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xbaba93c4886a5abeull;
+    constexpr static char nameChars[] = "s\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2};
+    constexpr static NameTable names {nameChars, nameOffsets, 1};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase19Nsp::TestCase19>{0}, &TestCase19Nsp::TestCase19::s, AttrArray {} }
+    };
+};
+template<>
+struct MethodData<TestCase19Nsp::TestCase19>
+{
+    static void Invoke0(void *object, void *const *args, void *result) {
+        MethodDetail::Store<TestCase19Nsp::Scalar>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase19Nsp::TestCase19 *>(object)->Scaled(MethodDetail::Arg<TestCase19Nsp::Scalar>(args[0]));
+        });
+    }
+    constexpr static auto params0 = std::array<MethodParam, 1> {{
+        { "x", TypeTagOf<TestCase19Nsp::Scalar>() }
+    }};
+    static void Invoke1(void *object, void *const *, void *result) {
+        MethodDetail::Store<TestCase19Nsp::TestCase19::value_type>(result, [&]() -> decltype(auto) {
+            return static_cast<const TestCase19Nsp::TestCase19 *>(object)->Count();
+        });
+    }
+    constexpr static auto params1 = std::array<MethodParam, 0> {{}};
+    constexpr static auto methods = std::array<Method, 2> {{
+        { "Scaled", &Invoke0, TypeTagOf<TestCase19Nsp::Scalar>(), params0.data(), params0.size(), true, false },
+        { "Count", &Invoke1, TypeTagOf<TestCase19Nsp::TestCase19::value_type>(), params1.data(), params1.size(), true, false }
+    }};
+};
+template<>
+struct ReflData<TestCase20>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x1f4e9ac4b621918bull;
+    constexpr static char nameChars[] = "a\0" "b\0" "c\0" "d\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 4, 6, 8};
+    constexpr static NameTable names {nameChars, nameOffsets, 4};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase20>{0}, &TestCase20::a, AttrArray {} },
+        Field { PooledName<TestCase20>{1}, &TestCase20::b, AttrArray {} },
+        Field { PooledName<TestCase20>{2}, &TestCase20::c, AttrArray {} },
+        Field { PooledName<TestCase20>{3}, &TestCase20::d, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase21>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0xfb8219f04520ad5eull;
+    constexpr static char nameChars[] = "direction\0" "intensity\0" "enabled\0" "weights\0";
+    constexpr static uint32_t nameOffsets[] = {0, 10, 20, 28, 36};
+    constexpr static NameTable names {nameChars, nameOffsets, 4};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase21>{0}, &TestCase21::direction, AttrArray {} },
+        Field { PooledName<TestCase21>{1}, &TestCase21::intensity, AttrArray {} },
+        Field { PooledName<TestCase21>{2}, &TestCase21::enabled, AttrArray {} },
+        Field { PooledName<TestCase21>{3}, &TestCase21::weights, AttrArray {} }
+    };
+};
+template<>
+struct ReflData<TestCase22>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x20c41907488a2fefull;
+    constexpr static char nameChars[] = "x\0" "range\0" "angle\0" "step\0" "level\0";
+    constexpr static uint32_t nameOffsets[] = {0, 2, 8, 14, 19, 25};
+    constexpr static NameTable names {nameChars, nameOffsets, 5};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase22>{0}, &TestCase22::x, AttrArray {Attribute{ PooledName<TestCase22>{1}, std::make_pair(-1, 1) }} },
+        Field { PooledName<TestCase22>{2}, &TestCase22::angle, AttrArray {Attribute{ PooledName<TestCase22>{1}, std::make_pair(0, 6.2831854820251465) }, Attribute{ PooledName<TestCase22>{3}, 0.78539818525314331 }} },
+        Field { PooledName<TestCase22>{4}, &TestCase22::level, AttrArray {Attribute{ PooledName<TestCase22>{1}, std::make_pair(-10, -2) }, Attribute{ PooledName<TestCase22>{3}, -0.5 }} }
+    };
+};
+template<>
+struct ReflData<TestCase23Nsp::TestCase23>
+{
+    constexpr static bool hasData = true;
+    constexpr static bool hasBases = false;
+    constexpr static uint64_t typeId = 0x23dbb3ca4dd8075bull;
+    constexpr static char nameChars[] = "view\0" "projection\0" "eye\0" "time\0" "jitter\0" "frame\0" "taa\0" "cascadeSplits\0" "lights\0" "lightCount\0";
+    constexpr static uint32_t nameOffsets[] = {0, 5, 16, 20, 25, 32, 38, 42, 56, 63, 74};
+    constexpr static NameTable names {nameChars, nameOffsets, 10};
+    constexpr static auto fields = FieldArray {
+        Field { PooledName<TestCase23Nsp::TestCase23>{0}, &TestCase23Nsp::TestCase23::view, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{1}, &TestCase23Nsp::TestCase23::projection, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{2}, &TestCase23Nsp::TestCase23::eye, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{3}, &TestCase23Nsp::TestCase23::time, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{4}, &TestCase23Nsp::TestCase23::jitter, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{5}, &TestCase23Nsp::TestCase23::frame, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{6}, &TestCase23Nsp::TestCase23::taa, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{7}, &TestCase23Nsp::TestCase23::cascadeSplits, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{8}, &TestCase23Nsp::TestCase23::lights, AttrArray {} },
+        Field { PooledName<TestCase23Nsp::TestCase23>{9}, &TestCase23Nsp::TestCase23::lightCount, AttrArray {} }
+    };
+};
+}
+using TestCase18SoA = PRefl::SoA<TestCase18>;
+#endif
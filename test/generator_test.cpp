@@ -0,0 +1,432 @@
+// Golden test of the generated code.
+//
+// Usage: PReflGeneratorTest <test dir> [--update]
+//
+// Builds the records clang extracts from test.h (x86-64 layout), generates
+// them with each output mode and compares the result with the files in
+// <test dir>/generated. --update rewrites the golden files instead. The
+// records mirror what Visitor extracts, so the generator is tested without
+// clang; keep them in sync with test.h.
+
+#include "Generator.h"
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace PReflTool;
+
+namespace {
+std::string MakeUSR(const std::vector<std::string> &nsps,
+                    const std::string &name) {
+  std::string usr = "c:";
+  for (auto &nsp : nsps)
+    usr += "@S@" + nsp;
+  return usr + "@S@" + name;
+}
+
+class RecordBuilder {
+  std::unique_ptr<CxxRecord> m_record;
+
+public:
+  RecordBuilder(std::string name, std::vector<std::string> nsps,
+                std::vector<std::string> tmps, ECxxRecordType type) {
+    m_record = std::make_unique<CxxRecord>(name, nsps, tmps, true, type);
+    m_record->SetUSR(MakeUSR(nsps, name));
+  }
+
+  // A field whose layout depends on template parameters.
+  Field &Dependent(std::string name) {
+    auto field = std::make_unique<Field>();
+    field->name = name;
+    auto *result = field.get();
+    m_record->PushField(field);
+    return *result;
+  }
+  Field &Static(std::string name) {
+    auto &field = Dependent(name);
+    field.isStatic = true;
+    return field;
+  }
+  Field &Plain(std::string name, uint64_t offset, uint64_t size,
+               GpuType gpu) {
+    auto &field = Dependent(name);
+    field.offset = offset;
+    field.size = size;
+    field.isPlainBytes = true;
+    field.gpu = std::move(gpu);
+    return field;
+  }
+
+  CxxRecord &operator*() { return *m_record; }
+  CxxRecord *operator->() { return m_record.get(); }
+  void PushTo(Generator &generator) { generator.PushCxxRecord(m_record); }
+};
+
+GpuType Scalar(GpuType::EScalar scalar, uint32_t count = 0) {
+  GpuType gpu;
+  gpu.kind = GpuType::EKind::Scalar;
+  gpu.scalar = scalar;
+  gpu.count = count;
+  uint64_t size = scalar == GpuType::EScalar::Double ? 8
+                  : scalar == GpuType::EScalar::Bool ? 1
+                                                     : 4;
+  gpu.cpuSize = size * std::max(count, 1u);
+  return gpu;
+}
+GpuType Int() { return Scalar(GpuType::EScalar::Int); }
+GpuType Float() { return Scalar(GpuType::EScalar::Float); }
+
+void AddRange(Field &field, double vmin, double vmax) {
+  auto range = std::make_unique<RangeAnnotate>();
+  range->SetRange(vmin);
+  range->SetRange(vmax);
+  field.attrs.emplace_back(std::move(range));
+}
+
+void AddStep(Field &field, double step) {
+  auto attr = std::make_unique<StepAnnotate>();
+  attr->step = step;
+  field.attrs.emplace_back(std::move(attr));
+}
+
+void AddInfo(Field &field, std::string info) {
+  auto attr = std::make_unique<InfoAnnotate>();
+  attr->info = info;
+  field.attrs.emplace_back(std::move(attr));
+}
+
+// The records and enums of test.h, in the order Visitor pushes them: nested
+// records before their outer record.
+void PushTestRecords(Generator &generator) {
+  using S = GpuType::EScalar;
+  auto Struct = ECxxRecordType::Struct;
+  auto Class = ECxxRecordType::Class;
+
+  {
+    RecordBuilder r{"TestCase1", {}, {}, Struct};
+    r.Plain("_a", 4, 4, Int());
+    r.PushTo(generator);
+  }
+  RecordBuilder{"TestCase3", {}, {}, Class}.PushTo(generator);
+  {
+    RecordBuilder r{"TestCase4", {}, {"T"}, Struct};
+    r.Dependent("a");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase5Inner", {"TestCase5"}, {}, Struct};
+    r->SetNested(true);
+    r.Plain("a_in", 0, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase5", {}, {}, Struct};
+    r.Plain("a", 0, 4, Float());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase6Inner", {"TestCase6"}, {"T"}, Struct};
+    r->SetNested(true);
+    r.Dependent("a_in");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase6", {}, {}, Struct};
+    r.Plain("a", 0, 4, Float());
+    r.PushTo(generator);
+  }
+  // TestCase7Inner is nested in a class template and not pushed
+  {
+    RecordBuilder r{"TestCase7", {}, {"T"}, Struct};
+    r.Dependent("a");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase8", {"TestCase8Nsp"}, {"T1", "T2"}, Struct};
+    r.Dependent("a");
+    r.Dependent("b");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase8_2", {"TestCase8Nsp", "TestCase8Nsp2"}, {},
+                    Struct};
+    r.Plain("a2", 0, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase9", {}, {"T1", "T2"}, Class};
+    r->AddBase("TestCase8Nsp::TestCase8Nsp2::TestCase8_2",
+               MakeUSR({"TestCase8Nsp", "TestCase8Nsp2"}, "TestCase8_2"));
+    r->AddBase("TestCase4<T2>", MakeUSR({}, "TestCase4"));
+    r.Dependent("c");
+    r.Static("sc");
+    r.Static("csc");
+    r.Dependent("cc");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase10Inner", {"TestCase10_no"}, {"T"}, Struct};
+    r->SetNested(true);
+    r.Dependent("a_in");
+    r.PushTo(generator);
+  }
+  {
+    GpuType testCase1;
+    testCase1.kind = GpuType::EKind::Struct;
+    testCase1.cpuSize = 8;
+    testCase1.members = {{"a_no", 0, Int()}, {"_a", 4, Int()}};
+
+    RecordBuilder r{"TestCase11", {}, {}, Class};
+    r.Plain("b", 4, 4, Int());
+    r.Plain("t", 20, 8, testCase1);
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase12_1", {}, {}, Class};
+    r.Plain("a", 0, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase12_2", {}, {}, Class};
+    r.Plain("b", 0, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase12_3", {}, {}, Class};
+    r->AddBase("TestCase12_1", MakeUSR({}, "TestCase12_1"));
+    r.Plain("c", 4, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase12_4", {}, {}, Class};
+    r->AddBase("TestCase12_2", MakeUSR({}, "TestCase12_2"));
+    r.Plain("d", 8, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase13", {}, {}, Struct};
+    AddRange(r.Plain("a", 0, 4, Float()), 0, 1);
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase14", {}, {}, Struct};
+    auto &a = r.Plain("a", 0, 4, Int());
+    AddRange(a, 1, 10.5);
+    AddStep(a, 0.5);
+    AddInfo(a, "this is a info");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase15", {}, {"T", "N"}, Struct};
+    std::vector<std::string> decls{"typename T", "int N"};
+    r->SetTemplateDecls(decls);
+    r->AddSpecialization({"float", "3"});
+    r.Dependent("a");
+    r.PushTo(generator);
+  }
+  {
+    GpuType array;
+    array.kind = GpuType::EKind::Struct;
+    array.cpuSize = 12;
+    array.members = {{"a", 0, Scalar(S::Float, 3)}};
+
+    // a record of floats has no unique object representation
+    RecordBuilder r{"TestCase15_User", {}, {}, Struct};
+    r.Plain("v", 0, 12, array).isPlainBytes = false;
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase16", {}, {}, Struct};
+    r.Plain("mode", 0, 4, Int());
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase17", {}, {}, Struct};
+    r.Plain("scale", 0, 4, Float());
+    r->PushMethod({"Scale", "float", {{"float", "x"}, {"const float &", "bias"}},
+                   true, false});
+    r->PushMethod({"SetScale", "void", {{"float", "s"}}, false, false});
+    r->PushMethod({"Twice", "int", {{"int", "a"}}, false, true});
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase18", {}, {}, Struct};
+    r->SetGenerateSoA(true);
+    r.Plain("position", 0, 12, Scalar(S::Float, 3));
+    AddRange(r.Plain("life", 12, 4, Float()), 0, 1);
+    r.Plain("id", 16, 4, Int());
+    r.Static("kind");
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase19", {"TestCase19Nsp"}, {}, Struct};
+    r.Plain("s", 0, 4, Float());
+    r->PushMethod({"Scaled",
+                   "TestCase19Nsp::Scalar",
+                   {{"TestCase19Nsp::Scalar", "x"}},
+                   true,
+                   false});
+    r->PushMethod(
+        {"Count", "TestCase19Nsp::TestCase19::value_type", {}, true, false});
+    r.PushTo(generator);
+  }
+  {
+    RecordBuilder r{"TestCase20", {}, {}, Struct};
+    r.Plain("a", 0, 4, Int());
+    r.Plain("b", 4, 4, Int());
+    r.Plain("c", 8, 4, Float());
+    r.Plain("d", 16, 8, Scalar(S::Double));
+    r.PushTo(generator);
+  }
+  {
+    GpuType vec3 = Float();
+    vec3.rows = 3;
+    vec3.cpuSize = 12;
+
+    // a record of floats has no unique object representation
+    RecordBuilder r{"TestCase21", {}, {}, Struct};
+    r.Plain("direction", 0, 12, vec3).isPlainBytes = false;
+    r.Plain("intensity", 12, 4, Float());
+    r.Plain("enabled", 16, 1, Scalar(S::Bool));
+    r.Plain("weights", 20, 8, Scalar(S::Float, 2));
+    r.PushTo(generator);
+  }
+
+  {
+    // the bounds are evaluated in the type of the expression
+    const float pi = 3.14159265f;
+    RecordBuilder r{"TestCase22", {}, {}, Struct};
+    AddRange(r.Plain("x", 0, 4, Float()), -1, 1);
+    auto &angle = r.Plain("angle", 4, 4, Float());
+    AddRange(angle, 0, 2 * pi);
+    AddStep(angle, pi / 4);
+    auto &level = r.Plain("level", 8, 4, Int());
+    AddRange(level, -10, -2);
+    AddStep(level, -0.5);
+    r.PushTo(generator);
+  }
+  {
+    auto Vector = [](uint32_t rows, uint32_t columns = 1) {
+      GpuType gpu = Float();
+      gpu.rows = rows;
+      gpu.columns = columns;
+      gpu.cpuSize = 4 * rows * columns;
+      return gpu;
+    };
+    GpuType bool1 = Scalar(S::Bool);
+    GpuType light;
+    light.kind = GpuType::EKind::Struct;
+    light.count = 4;
+    light.cpuSize = 128;
+    light.members = {{"position", 0, Vector(3)},
+                     {"radius", 12, Float()},
+                     {"color", 16, Vector(3)},
+                     {"castShadows", 28, bool1}};
+
+    // records of floats have no unique object representation
+    RecordBuilder r{"TestCase23", {"TestCase23Nsp"}, {}, Struct};
+    r.Plain("view", 0, 64, Vector(4, 4)).isPlainBytes = false;
+    r.Plain("projection", 64, 64, Vector(4, 4)).isPlainBytes = false;
+    r.Plain("eye", 128, 12, Vector(3)).isPlainBytes = false;
+    r.Plain("time", 140, 4, Float());
+    r.Plain("jitter", 144, 8, Vector(2)).isPlainBytes = false;
+    r.Plain("frame", 152, 4, Int());
+    r.Plain("taa", 156, 1, bool1);
+    r.Plain("cascadeSplits", 160, 16, Scalar(S::Float, 4));
+    r.Plain("lights", 176, 128, light).isPlainBytes = false;
+    r.Plain("lightCount", 304, 4, Scalar(S::UInt));
+    r.PushTo(generator);
+  }
+
+  auto mode = std::make_unique<CxxEnum>("TestCase16Mode",
+                                        std::vector<std::string>{}, true);
+  mode->SetUSR("c:@E@TestCase16Mode");
+  mode->PushEnumerator("Forward", 0);
+  mode->PushEnumerator("Deferred", 1);
+  mode->PushEnumerator("Default", 0);
+  // Count follows the alias Default
+  mode->PushEnumerator("Count", 1);
+  generator.PushCxxEnum(mode);
+
+  auto flag = std::make_unique<CxxEnum>(
+      "EFlag", std::vector<std::string>{"TestCase16"}, false);
+  flag->SetUSR("c:@S@TestCase16@E@EFlag");
+  flag->PushEnumerator("None", 0);
+  flag->PushEnumerator("Shadow", 1);
+  flag->PushEnumerator("Reflect", 16);
+  flag->PushEnumerator("All", 0xffffffff);
+  generator.PushCxxEnum(flag);
+}
+
+struct Mode {
+  const char *golden;
+  std::function<void(Options &)> configure;
+};
+
+const Mode s_modes[] = {
+    {"test.gen.inl", [](Options &) {}},
+    {"test.no_modify.gen.inl",
+     [](Options &options) { options.modifySource = false; }},
+    {"test.registry.gen.inl",
+     [](Options &options) { options.emitRegistry = true; }},
+    {"test.json.gen.inl", [](Options &options) { options.emitJson = true; }},
+    {"test.hash.gen.inl", [](Options &options) { options.emitHash = true; }},
+    {"test.kernels.gen.inl",
+     [](Options &options) { options.emitKernels = true; }},
+    {"test.pooled_names.gen.inl",
+     [](Options &options) { options.pooledNames = true; }},
+    {"test.std140.gen.inl",
+     [](Options &options) {
+       options.gpuLayout = Options::EGpuLayout::Std140;
+     }},
+    {"test.std430.gen.inl",
+     [](Options &options) {
+       options.gpuLayout = Options::EGpuLayout::Std430;
+     }},
+};
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: PReflGeneratorTest <test dir> [--update]\n";
+    return 1;
+  }
+  std::filesystem::path testDir{argv[1]};
+  bool update = argc > 2 && std::string{argv[2]} == "--update";
+
+  int failed = 0;
+  for (auto &mode : s_modes) {
+    Options options;
+    options.writeOutputs = false;
+    options.jobs = 1;
+    mode.configure(options);
+
+    Generator generator{(testDir / "test.h").string(), options};
+    PushTestRecords(generator);
+    std::ostringstream out;
+    generator.Generate(out);
+
+    auto golden = testDir / "generated" / mode.golden;
+    if (update) {
+      std::ofstream file(golden, std::ios::out | std::ios::trunc |
+                                     std::ios::binary);
+      file << out.str();
+      std::cout << "updated " << golden.string() << "\n";
+      continue;
+    }
+
+    std::ifstream file(golden, std::ios::in | std::ios::binary);
+    std::ostringstream expected;
+    expected << file.rdbuf();
+    if (!file.is_open() || expected.str() != out.str()) {
+      std::cerr << "*** error : output differs from " << golden.string()
+                << ", run with --update to accept it\n";
+      ++failed;
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #define RANGE(a, b) clang::annotate("range", a, b)
 #define INFO(str) clang::annotate("info", str)
 #define STEP(step) clang::annotate("step", step)
+#define SOA clang::annotate("soa")
 
 // test 1
 struct [[META]] TestCase1
@@ -61,7 +62,7 @@ struct [[META]] TestCase6
 // test 7
 // 避免出现模板类的内部类
 // 内部类的类型需要确定父类的模板类型，即 T 需要明确，而在自动生成反射阶段无法获取实例化的模板类型
-// 会生成 Refl<TestCase7::TestCase7Inner>（生成阶段通过 但编译阶段报错）
+// 不会生成 ReflData<TestCase7::TestCase7Inner>（生成的代码无法写出该类型）
 template<typename T>
 struct [[META]] TestCase7
 {
@@ -165,5 +166,145 @@ struct [[META]] TestCase14
     int a;
 };
 
+// test 15
+// 非类型模板参数；文件内使用到的 TestCase15<float, 3> 会生成完整特化
+template<typename T, int N>
+struct [[META]] TestCase15
+{
+    [[META]] T a[N];
+};
+struct [[META]] TestCase15_User
+{
+    [[META]] TestCase15<float, 3> v;
+};
+
+// test 16
+// 枚举：值连续时按值直接索引名字，否则使用完美哈希
+enum class [[META]] TestCase16Mode
+{
+    Forward,
+    Deferred,
+    Default = Forward,
+    Count
+};
+struct [[META]] TestCase16
+{
+    enum [[META]] EFlag : unsigned
+    {
+        None = 0,
+        Shadow = 1 << 0,
+        Reflect = 1 << 4,
+        All = 0xffffffff
+    };
+
+    [[META]] TestCase16Mode mode;
+};
+
+// test 17
+// 成员函数：生成固定签名的调用函数表，构造/析构/运算符/模板函数不生成
+struct [[META]] TestCase17
+{
+    [[META]] float scale;
+
+    [[META]] float Scale(float x, const float &bias) const { return scale * x + bias; }
+    [[META]] void SetScale(float s) { scale = s; }
+    [[META]] static int Twice(int a) { return a * 2; }
+    [[META]] TestCase17 &operator=(const TestCase17 &) = default;
+private:
+    [[META]] void Hidden_no() {}
+};
+
+// test 18
+// SOA：生成 PRefl::SoA<TestCase18> 和别名 TestCase18SoA，每个非静态字段一个连续数组
+struct [[META, SOA]] TestCase18
+{
+    [[META]] float position[3];
+    [[META, RANGE(0, 1)]] float life;
+    [[META]] int id;
+    [[META]] constexpr static int kind = 1;
+};
+
+// test 19
+// 成员函数的类型别名：生成代码位于 namespace PRefl，类型需要完整限定
+namespace TestCase19Nsp
+{
+    using Scalar = float;
+
+    struct [[META]] TestCase19
+    {
+        using value_type = int;
+
+        [[META]] Scalar s;
+
+        [[META]] Scalar Scaled(Scalar x) const { return s * x; }
+        [[META]] value_type Count() const { return 1; }
+    };
+}
+
+// test 20
+// Hash：连续且无填充的字段合并为一次字节哈希，d 前有填充
+struct [[META]] TestCase20
+{
+    [[META]] int a;
+    [[META]] int b;
+    [[META]] float c;
+    [[META]] double d;
+};
+
+// test 21
+// --gpu-layout：向量、bool 和数组在 std140/std430 中的布局不同于 CPU
+struct TestCase21Vec3
+{
+    float x, y, z;
+};
+struct [[META]] TestCase21
+{
+    [[META]] TestCase21Vec3 direction;
+    [[META]] float intensity;
+    [[META]] bool enabled;
+    [[META]] float weights[2];
+};
+
+// test 22
+// RANGE/STEP 的参数按常量表达式求值：负数和 constexpr 常量，非正的 STEP 不生成 kernel
+constexpr float kTestCase22Pi = 3.14159265f;
+struct [[META]] TestCase22
+{
+    [[META, RANGE(-1, 1)]] float x;
+    [[META, RANGE(0, 2 * kTestCase22Pi), STEP(kTestCase22Pi / 4)]] float angle;
+    [[META, RANGE(-10, -2), STEP(-0.5)]] int level;
+};
+
+// test 23
+// --gpu-layout：矩阵、结构体数组和 bool，bench/gpu_pack.cpp 使用这里的 std140 输出
+namespace TestCase23Nsp
+{
+    struct Vec2 { float x, y; };
+    struct Vec3 { float x, y, z; };
+    struct Vec4 { float x, y, z, w; };
+    struct Mat4 { Vec4 value[4]; };
+    struct PointLight
+    {
+        Vec3 position;
+        float radius;
+        Vec3 color;
+        bool castShadows;
+    };
+
+    struct [[META]] TestCase23
+    {
+        [[META]] Mat4 view;
+        [[META]] Mat4 projection;
+        [[META]] Vec3 eye;
+        [[META]] float time;
+        [[META]] Vec2 jitter;
+        [[META]] int frame;
+        [[META]] bool taa;
+        [[META]] float cascadeSplits[4];
+        [[META]] PointLight lights[4];
+        [[META]] unsigned lightCount;
+    };
+}
+
 // auto generated by PupilReflTool
 #include "generated/test.gen.inl"